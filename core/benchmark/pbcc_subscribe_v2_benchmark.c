@@ -0,0 +1,326 @@
+/* -*- c-file-style:"stroustrup"; indent-tabs-mode: nil -*- */
+#include "pubnub_internal.h"
+
+#include "core/pbcc_subscribe_v2.h"
+#include "core/pubnub_json_parse.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+
+/** @file pbcc_subscribe_v2_benchmark.c
+
+    Measures decoding of subscribe V2 responses: parsing the response
+    and getting all the messages from it, like pubnub_get_v2() does.
+    The messages have a realistic layout (as sent by the PubNub
+    network) and their payloads are a mix of small, medium and large
+    JSON objects.
+
+    For comparison, it also measures the "legacy" decoder, which
+    looked for every field from the start of the message, and checks
+    that both decoders (and random access to the indexed messages)
+    give the same results.
+ */
+
+
+/** How many times to decode each response */
+#define ROUNDS 200
+
+
+static char* append(char* s, char const* fmt, ...)
+{
+    va_list args;
+    int     len;
+
+    va_start(args, fmt);
+    len = vsprintf(s, fmt, args);
+    va_end(args);
+
+    return s + len;
+}
+
+
+/** Makes a payload (JSON object) of about @p size bytes */
+static void make_payload(char* s, size_t size, unsigned n)
+{
+    size_t len = (size_t)sprintf(s, "{\"seq\":%u,\"text\":\"", n);
+    while (len + 3 < size) {
+        s[len] = (char)('a' + (len % 26));
+        ++len;
+    }
+    strcpy(s + len, "\"}");
+}
+
+
+/** Makes a subscribe V2 response with @p count messages, the
+    payload size of the i-th of which is `sizes[i % nsizes]`.
+ */
+static char* make_response(unsigned count, size_t const* sizes, unsigned nsizes, size_t* length)
+{
+    size_t   capacity = 256;
+    char*    rslt;
+    char*    s;
+    char*    payload;
+    unsigned i;
+    size_t   max_size = 0;
+
+    for (i = 0; i < nsizes; ++i) {
+        if (sizes[i] > max_size) {
+            max_size = sizes[i];
+        }
+    }
+    for (i = 0; i < count; ++i) {
+        capacity += sizes[i % nsizes] + 256;
+    }
+    rslt    = (char*)malloc(capacity);
+    payload = (char*)malloc(max_size + 1);
+    if ((NULL == rslt) || (NULL == payload)) {
+        fputs("Out of memory\n", stderr);
+        exit(EXIT_FAILURE);
+    }
+    s = append(rslt, "{\"t\":{\"t\":\"16190000000000000\",\"r\":12},\"m\":[");
+    for (i = 0; i < count; ++i) {
+        make_payload(payload, sizes[i % nsizes], i);
+        s = append(s,
+                   "%s{\"a\":\"4\",\"f\":0,\"i\":\"publisher-%u\","
+                   "\"p\":{\"t\":\"1619000000%07u\",\"r\":12},"
+                   "\"k\":\"sub-c-bench\",\"c\":\"channel-%u\",\"d\":%s,"
+                   "\"u\":{\"lang\":\"en\"},\"b\":\"channel-%u\"%s}",
+                   (0 == i) ? "" : ",",
+                   i % 7,
+                   i,
+                   i % 10,
+                   payload,
+                   i % 10,
+                   (i % 5 == 4) ? ",\"e\":1" : "");
+    }
+    s = append(s, "]}");
+    free(payload);
+    *length = s - rslt;
+
+    return rslt;
+}
+
+
+/** The way responses were parsed before: looking for the time token
+    and then, from the start again, for the messages. Messages were
+    not indexed, but decoded one by one by legacy_get_msg_v2().
+ */
+static enum pubnub_res legacy_parse(struct pbcc_context* p)
+{
+    struct pbjson_elem el;
+    struct pbjson_elem found;
+    struct pbjson_elem titel;
+
+    el.start = p->http_reply;
+    el.end   = p->http_reply + p->http_buf_len;
+    if ((jonmpOK != pbjson_get_object_value(&el, "t", &found))
+        || (jonmpOK != pbjson_get_object_value(&found, "t", &titel))) {
+        return PNR_FORMAT_ERROR;
+    }
+    memcpy(p->timetoken, titel.start + 1, titel.end - titel.start - 2);
+    p->timetoken[titel.end - titel.start - 2] = '\0';
+    if (jonmpOK != pbjson_get_object_value(&found, "r", &titel)) {
+        return PNR_FORMAT_ERROR;
+    }
+    p->region = strtol(titel.start, NULL, 0);
+    if (jonmpOK != pbjson_get_object_value(&el, "m", &found)) {
+        return PNR_FORMAT_ERROR;
+    }
+    p->msg_ofs = (unsigned)(found.start - p->http_reply + 1);
+    p->msg_end = (unsigned)(found.end - p->http_reply - 1);
+
+    return PNR_OK;
+}
+
+
+/** The way messages were decoded before: finding the end of the
+    message, then looking for each field from its start.
+ */
+static struct pubnub_v2_message legacy_get_msg_v2(struct pbcc_context* p)
+{
+    struct pbjson_elem       el;
+    struct pbjson_elem       found;
+    struct pubnub_v2_message rslt;
+    char const*              start;
+    char const*              seeker;
+
+    memset(&rslt, 0, sizeof rslt);
+    if (p->msg_ofs >= p->msg_end) {
+        return rslt;
+    }
+    start  = p->http_reply + p->msg_ofs;
+    seeker = pbjson_find_end_complex(start, p->http_reply + p->msg_end);
+    p->msg_ofs = (unsigned)(seeker - p->http_reply + 2);
+    el.start   = start;
+    el.end     = seeker + 1;
+
+    if (jonmpOK == pbjson_get_object_value(&el, "d", &found)) {
+        rslt.payload.ptr  = (char*)found.start;
+        rslt.payload.size = found.end - found.start;
+    }
+    if (jonmpOK == pbjson_get_object_value(&el, "c", &found)) {
+        rslt.channel.ptr  = (char*)found.start + 1;
+        rslt.channel.size = found.end - found.start - 2;
+    }
+    rslt.message_type = pbsbPublished;
+    if (jonmpOK == pbjson_get_object_value(&el, "e", &found)) {
+        if (pbjson_elem_equals_string(&found, "1")) {
+            rslt.message_type = pbsbSignal;
+        }
+        else if (pbjson_elem_equals_string(&found, "3")) {
+            rslt.message_type = pbsbAction;
+        }
+    }
+    if (jonmpOK == pbjson_get_object_value(&el, "p", &found)) {
+        struct pbjson_elem titel;
+        if (jonmpOK == pbjson_get_object_value(&found, "t", &titel)) {
+            rslt.tt.ptr  = (char*)titel.start + 1;
+            rslt.tt.size = titel.end - titel.start - 2;
+        }
+    }
+    if (jonmpOK == pbjson_get_object_value(&el, "b", &found)) {
+        rslt.match_or_group.ptr  = (char*)found.start;
+        rslt.match_or_group.size = found.end - found.start;
+    }
+    if (jonmpOK == pbjson_get_object_value(&el, "u", &found)) {
+        rslt.metadata.ptr  = (char*)found.start;
+        rslt.metadata.size = found.end - found.start;
+    }
+
+    return rslt;
+}
+
+
+static bool same_block(struct pubnub_char_mem_block a, struct pubnub_char_mem_block b)
+{
+    return (a.ptr == b.ptr) && (a.size == b.size);
+}
+
+
+static bool same_msg(struct pubnub_v2_message const* a, struct pubnub_v2_message const* b)
+{
+    return same_block(a->tt, b->tt) && same_block(a->channel, b->channel)
+           && same_block(a->match_or_group, b->match_or_group)
+           && same_block(a->payload, b->payload)
+           && same_block(a->metadata, b->metadata)
+           && (a->message_type == b->message_type);
+}
+
+
+/** Decodes the @p response @p rounds times with @p parse and
+    @p get_msg.
+    @return Number of messages decoded (in all rounds)
+ */
+static unsigned long decode(struct pbcc_context* p,
+                            char*                response,
+                            size_t               length,
+                            unsigned             rounds,
+                            enum pubnub_res (*parse)(struct pbcc_context*),
+                            struct pubnub_v2_message (*get_msg)(struct pbcc_context*))
+{
+    unsigned long count = 0;
+    unsigned      i;
+
+    for (i = 0; i < rounds; ++i) {
+        p->http_reply   = response;
+        p->http_buf_len = length;
+        if (parse(p) != PNR_OK) {
+            fputs("Failed to parse the response\n", stderr);
+            exit(EXIT_FAILURE);
+        }
+        while (get_msg(p).payload.ptr != NULL) {
+            ++count;
+        }
+    }
+
+    return count;
+}
+
+
+static double seconds_since(clock_t start)
+{
+    return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+
+static void run(char const* name, unsigned count, size_t const* sizes, unsigned nsizes)
+{
+    static struct pbcc_context pbc;
+    size_t                     length;
+    char*                      response = make_response(count, sizes, nsizes, &length);
+    clock_t                    start;
+    unsigned long              msgs;
+    double                     legacy_s;
+    double                     indexed_s;
+    unsigned                   i;
+    double                     mb = (double)length * ROUNDS / (1024.0 * 1024.0);
+
+    /* Check that the results are the same */
+    pbc.http_reply   = response;
+    pbc.http_buf_len = length;
+    pbcc_parse_subscribe_v2_response(&pbc);
+    if (pbcc_msg_v2_count(&pbc) != count) {
+        fprintf(stderr, "%s: wrong message count\n", name);
+        exit(EXIT_FAILURE);
+    }
+    {
+        struct pbcc_context legacy = pbc;
+        for (i = 0;; ++i) {
+            struct pubnub_v2_message a = pbcc_get_msg_v2(&pbc);
+            struct pubnub_v2_message b = legacy_get_msg_v2(&legacy);
+            struct pubnub_v2_message c = pbcc_get_msg_v2_at(&pbc, i);
+            if (!same_msg(&a, &b) || !same_msg(&a, &c)) {
+                fprintf(stderr, "%s: decoders disagree\n", name);
+                exit(EXIT_FAILURE);
+            }
+            if (NULL == a.payload.ptr) {
+                break;
+            }
+        }
+    }
+
+    start    = clock();
+    msgs     = decode(&pbc, response, length, ROUNDS, legacy_parse, legacy_get_msg_v2);
+    legacy_s = seconds_since(start);
+
+    start     = clock();
+    msgs      = decode(&pbc,
+                  response,
+                  length,
+                  ROUNDS,
+                  pbcc_parse_subscribe_v2_response,
+                  pbcc_get_msg_v2);
+    indexed_s = seconds_since(start);
+
+    printf("%-8s %5u msgs, %8lu bytes: legacy %8.1f MB/s, indexed %8.1f MB/s "
+           "(%.2fx), %lu msgs\n",
+           name,
+           count,
+           (unsigned long)length,
+           mb / legacy_s,
+           mb / indexed_s,
+           legacy_s / indexed_s,
+           msgs);
+
+    free(response);
+}
+
+
+int main(void)
+{
+    static size_t const small[]  = { 40, 80, 120 };
+    static size_t const medium[] = { 200, 1000, 2000 };
+    static size_t const large[]  = { 8000, 16000, 30000 };
+    static size_t const mixed[]  = { 60, 60, 60, 500, 500, 4000, 20000 };
+
+    run("small", 100, small, sizeof small / sizeof small[0]);
+    run("medium", 100, medium, sizeof medium / sizeof medium[0]);
+    run("large", 20, large, sizeof large / sizeof large[0]);
+    run("mixed", 100, mixed, sizeof mixed / sizeof mixed[0]);
+
+    return 0;
+}
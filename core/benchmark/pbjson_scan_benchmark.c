@@ -0,0 +1,349 @@
+/* -*- c-file-style:"stroustrup"; indent-tabs-mode: nil -*- */
+#include "core/pubnub_json_parse.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+
+/** @file pbjson_scan_benchmark.c
+
+    Measures the JSON scanners (see pbjson_select_scanner()) on:
+
+    - a large JSON object, like the ones the Objects API returns,
+      getting the value of its last key,
+    - a history response (an array of messages with their time
+      tokens), walking all of its elements,
+    - long strings with some escaped characters,
+    - splitting the messages of a (V1) subscribe and history response
+      (pbcc_split_array()).
+
+    Every scanner available is checked to give the same results as
+    the scalar one.
+ */
+
+
+/** How many times to scan each input */
+#define ROUNDS 200
+
+
+struct scanner_info {
+    enum pbjson_scanner scanner;
+    char const*         name;
+};
+
+static struct scanner_info const m_scanners[] = {
+    { pbjsonScannerScalar, "scalar" },
+    { pbjsonScannerSSE2, "SSE2" },
+    { pbjsonScannerAVX2, "AVX2" },
+    { pbjsonScannerNEON, "NEON" },
+};
+
+#define SCANNER_COUNT (sizeof m_scanners / sizeof m_scanners[0])
+
+
+static char* append(char* s, char const* fmt, ...)
+{
+    va_list args;
+    int     len;
+
+    va_start(args, fmt);
+    len = vsprintf(s, fmt, args);
+    va_end(args);
+
+    return s + len;
+}
+
+
+static char* alloc_or_die(size_t size)
+{
+    char* rslt = (char*)malloc(size);
+    if (NULL == rslt) {
+        fputs("Out of memory\n", stderr);
+        exit(EXIT_FAILURE);
+    }
+    return rslt;
+}
+
+
+/** Appends a text of @p len characters, with an escaped quote now
+    and then, if @p escapes. */
+static char* append_text(char* s, size_t len, unsigned seed, bool escapes)
+{
+    size_t i;
+    for (i = 0; i < len; ++i) {
+        if (escapes && ((i + seed) % 97 == 96)) {
+            *s++ = '\\';
+            *s++ = '"';
+        }
+        else {
+            *s++ = (char)('a' + ((i + seed) % 26));
+        }
+    }
+    *s = '\0';
+    return s;
+}
+
+
+/** Makes an object of @p count "user" objects, each with some
+    metadata, like the Objects API returns. */
+static char* make_object(unsigned count, size_t* length)
+{
+    char*    rslt = alloc_or_die((size_t)count * 600 + 64);
+    char*    s    = append(rslt, "{\"status\":200,\"data\":[");
+    unsigned i;
+
+    for (i = 0; i < count; ++i) {
+        s = append(s,
+                   "%s{\"id\":\"user-%u\",\"name\":\"User %u\","
+                   "\"externalId\":null,\"profileUrl\":\"https://example.com/%u\","
+                   "\"email\":\"user%u@example.com\",\"custom\":{\"bio\":\"",
+                   (0 == i) ? "" : ",",
+                   i,
+                   i,
+                   i,
+                   i);
+        s = append_text(s, 300, i, true);
+        s = append(s,
+                   "\",\"tags\":[\"a\",\"b\",[1,2,{\"x\":true}]]},"
+                   "\"created\":\"2020-01-01T00:00:00.000Z\","
+                   "\"updated\":\"2020-01-01T00:00:00.000Z\","
+                   "\"eTag\":\"AYGyoY3gre71eA\"}");
+    }
+    s       = append(s, "],\"next\":\"MTAw\"}");
+    *length = s - rslt;
+
+    return rslt;
+}
+
+
+/** Makes a history response with @p count messages, with payloads of
+    @p size characters. */
+static char* make_history(unsigned count, size_t size, size_t* length)
+{
+    char*    rslt = alloc_or_die((size_t)count * (size + 128) + 128);
+    char*    s    = append(rslt, "[[");
+    unsigned i;
+
+    for (i = 0; i < count; ++i) {
+        s = append(s,
+                   "%s{\"message\":{\"seq\":%u,\"text\":\"",
+                   (0 == i) ? "" : ",",
+                   i);
+        s = append_text(s, size, i, false);
+        s = append(s, "\"},\"timetoken\":\"1619000000%07u\"}", i);
+    }
+    s = append(s, "],\"16190000000000000\",\"1619000000%07u\"]", count);
+    *length = s - rslt;
+
+    return rslt;
+}
+
+
+/** Makes an array of @p count strings of @p size characters */
+static char* make_strings(unsigned count, size_t size, size_t* length)
+{
+    char*    rslt = alloc_or_die((size_t)count * (size * 2 + 4) + 4);
+    char*    s    = append(rslt, "[");
+    unsigned i;
+
+    for (i = 0; i < count; ++i) {
+        s = append(s, "%s\"", (0 == i) ? "" : ",");
+        s = append_text(s, size, i, true);
+        s = append(s, "\"");
+    }
+    s       = append(s, "]");
+    *length = s - rslt;
+
+    return rslt;
+}
+
+
+/** Gets the last value from the object (walking over all the
+    others).
+    @return "Checksum" of the result
+ */
+static size_t scan_object(char const* json, size_t length)
+{
+    struct pbjson_elem el;
+    struct pbjson_elem found;
+
+    el.start = json;
+    el.end   = json + length;
+    if (pbjson_get_object_value(&el, "next", &found) != jonmpOK) {
+        fputs("Failed to parse the object\n", stderr);
+        exit(EXIT_FAILURE);
+    }
+    return found.start - json;
+}
+
+
+/** Walks all the elements of the (outer and inner) array.
+    @return "Checksum" of the result
+ */
+static size_t scan_array(char const* json, size_t length)
+{
+    char const* end = json + length;
+    char const* s   = json + 1;
+    size_t      sum = 0;
+
+    while (s < end) {
+        char const* elem_end = pbjson_find_end_element(s, end);
+        if ('[' == *s) {
+            sum += scan_array(s, elem_end - s + 1);
+        }
+        sum += elem_end - json;
+        s = elem_end + 2;
+    }
+    return sum;
+}
+
+
+/** Makes the messages of a (V1) subscribe response: @p count
+    messages, with payloads of @p size characters. */
+static char* make_subscribe_v1(unsigned count, size_t size, size_t* length)
+{
+    char*    rslt = alloc_or_die((size_t)count * (size * 2 + 64) + 4);
+    char*    s    = rslt;
+    unsigned i;
+
+    for (i = 0; i < count; ++i) {
+        s = append(s, "%s{\"seq\":%u,\"text\":\"", (0 == i) ? "" : ",", i);
+        s = append_text(s, size, i, true);
+        s = append(s, "\",\"tags\":[\"a,b\",{\"c\":[1,2]}]}");
+    }
+    *length = s - rslt;
+
+    return rslt;
+}
+
+
+static double seconds_since(clock_t start)
+{
+    return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+
+static void run(char const* name,
+                char*       json,
+                size_t      length,
+                size_t (*scan)(char const*, size_t))
+{
+    double   mb = (double)length * ROUNDS / (1024.0 * 1024.0);
+    double   scalar_s = 0;
+    size_t   expected = 0;
+    unsigned i;
+
+    printf("%-8s %8lu bytes:", name, (unsigned long)length);
+    for (i = 0; i < SCANNER_COUNT; ++i) {
+        clock_t  start;
+        double   secs;
+        size_t   rslt = 0;
+        unsigned round;
+
+        if (!pbjson_select_scanner(m_scanners[i].scanner)) {
+            continue;
+        }
+        start = clock();
+        for (round = 0; round < ROUNDS; ++round) {
+            rslt = scan(json, length);
+        }
+        secs = seconds_since(start);
+        if (pbjsonScannerScalar == m_scanners[i].scanner) {
+            expected = rslt;
+            scalar_s = secs;
+            printf(" %s %7.1f MB/s", m_scanners[i].name, mb / secs);
+        }
+        else {
+            if (rslt != expected) {
+                fprintf(stderr, "\n%s: %s scanner disagrees\n", name, m_scanners[i].name);
+                exit(EXIT_FAILURE);
+            }
+            printf(", %s %7.1f MB/s (%.2fx)", m_scanners[i].name, mb / secs, scalar_s / secs);
+        }
+    }
+    putchar('\n');
+
+    free(json);
+}
+
+
+/** Like run(), but for splitting arrays. As splitting only replaces
+    the separating commas with NULs (which are then treated like any
+    other character), the same input can be split again and again.
+ */
+static void run_split(char const* name, char* json, size_t length)
+{
+    double   mb       = (double)length * ROUNDS / (1024.0 * 1024.0);
+    double   scalar_s = 0;
+    char*    expected = alloc_or_die(length);
+    char*    work     = alloc_or_die(length);
+    unsigned i;
+
+    printf("%-8s %8lu bytes:", name, (unsigned long)length);
+    for (i = 0; i < SCANNER_COUNT; ++i) {
+        clock_t  start;
+        double   secs;
+        unsigned round;
+
+        if (!pbjson_select_scanner(m_scanners[i].scanner)) {
+            continue;
+        }
+        memcpy(work, json, length);
+        if (!pbjson_split_array(work, work + length)) {
+            fprintf(stderr, "\n%s: failed to split\n", name);
+            exit(EXIT_FAILURE);
+        }
+        start = clock();
+        for (round = 0; round < ROUNDS; ++round) {
+            pbjson_split_array(work, work + length);
+        }
+        secs = seconds_since(start);
+        if (pbjsonScannerScalar == m_scanners[i].scanner) {
+            memcpy(expected, work, length);
+            scalar_s = secs;
+            printf(" %s %7.1f MB/s", m_scanners[i].name, mb / secs);
+        }
+        else {
+            if (memcmp(work, expected, length) != 0) {
+                fprintf(stderr, "\n%s: %s scanner disagrees\n", name, m_scanners[i].name);
+                exit(EXIT_FAILURE);
+            }
+            printf(", %s %7.1f MB/s (%.2fx)", m_scanners[i].name, mb / secs, scalar_s / secs);
+        }
+    }
+    putchar('\n');
+
+    free(work);
+    free(expected);
+    free(json);
+}
+
+
+int main(void)
+{
+    size_t length;
+    char*  json;
+
+    json = make_object(500, &length);
+    run("object", json, length, scan_object);
+    json = make_history(100, 100, &length);
+    run("history", json, length, scan_array);
+    json = make_history(20, 5000, &length);
+    run("history+", json, length, scan_array);
+    json = make_strings(100, 2000, &length);
+    run("strings", json, length, scan_array);
+
+    json = make_subscribe_v1(100, 100, &length);
+    run_split("split", json, length);
+    json = make_subscribe_v1(100, 3000, &length);
+    run_split("split+", json, length);
+    json = make_history(100, 3000, &length);
+    /* Skip the opening bracket, like pbcc_parse_history_response() */
+    memmove(json, json + 1, --length);
+    run_split("h-split", json, length);
+
+    return 0;
+}
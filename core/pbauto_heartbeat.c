@@ -16,9 +16,11 @@
 #include "lib/pb_strnlen_s.h"
 #include "core/pb_sleep_ms.h"
 #include "core/pubnub_assert.h"
+#include "core/pbmem.h"
 #include "core/pubnub_log.h"
 #include "core/pbpal.h"
 #include "core/pubnub_helper.h"
+#include "core/pubnub_version.h"
 
 #include <stdlib.h>
 #include <string.h>
@@ -56,7 +58,11 @@ static int copy_context_settings(pubnub_t* pb_clone, pubnub_t const* pb)
     PUBNUB_ASSERT_OPT(pb_valid_ctx_ptr(pb));
 
     pubnub_mutex_lock(pb_clone->monitor);
-    pb_clone->core.auth = pb->core.auth;
+    /* Thumper contexts are shared, so the keys are not necessarily
+       the ones it was initialized with */
+    pb_clone->core.publish_key   = pb->core.publish_key;
+    pb_clone->core.subscribe_key = pb->core.subscribe_key;
+    pb_clone->core.auth          = pb->core.auth;
     strcpy(pb_clone->core.uuid, pb->core.uuid);
     if (PUBNUB_ORIGIN_SETTABLE) {
         pb_clone->origin = pb->origin;
@@ -94,10 +100,70 @@ static int copy_context_settings(pubnub_t* pb_clone, pubnub_t const* pb)
 }
 
 
-static bool pubsub_keys_changed(pubnub_t const* pb_clone, pubnub_t const* pb)
+/** Returns the length of @p s, which may be NULL, as it would be in
+    the URL, in the worst case of URL encoding every character.
+ */
+static size_t url_encoded_len_max(char const* s)
 {
-    return (pb_clone->core.publish_key != pb->core.publish_key)
-           || (pb_clone->core.subscribe_key != pb->core.subscribe_key);
+    return (NULL == s) ? 0 : 3 * pb_strnlen_s(s, PUBNUB_MAX_OBJECT_LENGTH);
+}
+
+/** Makes sure that the HTTP buffer of the thumper context
+    @p heartbeat_pb (with settings already copied from the subscribing
+    context) can hold the heartbeat request for @p channel and
+    @p channel_group, growing it if needed. Thumper contexts start
+    with a small buffer, as the heartbeat request is usually short.
+ */
+static void fit_thumper_http_buffer(pubnub_t*   heartbeat_pb,
+                                    char const* channel,
+                                    char const* channel_group)
+{
+#if PUBNUB_DYNAMIC_HTTP_BUFFER
+    /* All the fixed parts of the URL path of the heartbeat request
+       (as formed by pbcc_heartbeat_prep()), with the room for the
+       terminating NUL */
+    static char const fixed_parts[] = "/v2/presence/sub-key//channel/"
+                                      "/heartbeat?pnsdk="
+                                      "&channel-group=&auth=&uuid=";
+    size_t needed;
+
+    pubnub_mutex_lock(heartbeat_pb->monitor);
+    needed = sizeof fixed_parts
+             + pb_strnlen_s(heartbeat_pb->core.subscribe_key,
+                            PUBNUB_MAX_OBJECT_LENGTH)
+             + strlen(pubnub_uname()) + url_encoded_len_max(channel)
+             + url_encoded_len_max(channel_group)
+             + url_encoded_len_max(heartbeat_pb->core.auth)
+             + url_encoded_len_max(heartbeat_pb->core.uuid);
+    /* After the request is sent, the buffer holds the lines of the
+       response header */
+    if (needed < PUBNUB_HEARTBEAT_HTTP_BUF_SIZE) {
+        needed = PUBNUB_HEARTBEAT_HTTP_BUF_SIZE;
+    }
+    if (needed > PUBNUB_MAX_HTTP_BUF_SIZE) {
+        needed = PUBNUB_MAX_HTTP_BUF_SIZE;
+    }
+    if ((needed > PBCC_HTTP_BUF_SIZE(&heartbeat_pb->core))
+        && ((PBS_IDLE == heartbeat_pb->state)
+            || (PBS_KEEP_ALIVE_IDLE == heartbeat_pb->state))) {
+        if (0 == pbcc_set_http_buf_size(&heartbeat_pb->core, needed)) {
+            heartbeat_pb->ptr       = (uint8_t*)heartbeat_pb->core.http_buf;
+            heartbeat_pb->left      = needed;
+            heartbeat_pb->unreadlen = 0;
+        }
+        else {
+            PUBNUB_LOG_WARNING("fit_thumper_http_buffer(heartbeat_pb=%p) - "
+                               "failed to grow the HTTP buffer to %lu bytes\n",
+                               heartbeat_pb,
+                               (unsigned long)needed);
+        }
+    }
+    pubnub_mutex_unlock(heartbeat_pb->monitor);
+#else
+    PUBNUB_UNUSED(heartbeat_pb);
+    PUBNUB_UNUSED(channel);
+    PUBNUB_UNUSED(channel_group);
+#endif
 }
 
 #if defined(PUBNUB_CALLBACK_API)
@@ -111,27 +177,41 @@ static void add_heartbeat_in_progress(unsigned thumper_index)
 }
 #endif
 
+/** Returns the thumper context @p heartbeat_pb to the pool, once the
+    thumper it was lent to has no heartbeat in progress.
+ */
+static void return_thumper_pb(pubnub_t* heartbeat_pb)
+{
+    unsigned thumper_index;
+
+    pubnub_mutex_lock(heartbeat_pb->monitor);
+    thumper_index              = heartbeat_pb->thumperIndex;
+    heartbeat_pb->thumperIndex = UNASSIGNED;
+    pubnub_mutex_unlock(heartbeat_pb->monitor);
+    if (UNASSIGNED == thumper_index) {
+        return;
+    }
+
+    pubnub_mutex_lock(m_watcher.mutw);
+    if (m_watcher.heartbeat_data[thumper_index].heartbeat_pb == heartbeat_pb) {
+        m_watcher.heartbeat_data[thumper_index].heartbeat_pb = NULL;
+    }
+    PUBNUB_ASSERT_OPT(m_watcher.idle_thumper_pbs_count
+                      < PUBNUB_MAX_HEARTBEAT_THUMPERS);
+    m_watcher.idle_thumper_pbs[m_watcher.idle_thumper_pbs_count++] = heartbeat_pb;
+    pubnub_mutex_unlock(m_watcher.mutw);
+}
+
+
 static void heartbeat_thump(pubnub_t* pb, pubnub_t* heartbeat_pb)
 {
     char const* channel;
     char const* channel_group;
-    bool        keys_changed;
 
     PUBNUB_ASSERT_OPT(pb_valid_ctx_ptr(pb));
     PUBNUB_ASSERT_OPT(pb_valid_ctx_ptr(heartbeat_pb));
 
     pubnub_mutex_lock(pb->monitor);
-    pubnub_mutex_lock(heartbeat_pb->monitor);
-    keys_changed = pubsub_keys_changed(heartbeat_pb, pb);
-    pubnub_mutex_unlock(heartbeat_pb->monitor);
-
-    if (keys_changed) {
-        /** Used in sync environment while for callback it's an empty macro */
-        add_heartbeat_in_progress(pb->thumperIndex);
-        pubnub_mutex_unlock(pb->monitor);
-        pubnub_cancel(heartbeat_pb);
-        return;
-    }
     channel       = pb->channelInfo.channel;
     channel_group = pb->channelInfo.channel_group;
     if (((channel != NULL) && (pb_strnlen_s(channel, PUBNUB_MAX_OBJECT_LENGTH) > 0))
@@ -141,6 +221,7 @@ static void heartbeat_thump(pubnub_t* pb, pubnub_t* heartbeat_pb)
         PUBNUB_LOG_TRACE(
             "--->heartbeat_thump(pb=%p, heartbeat_pb=%p).\n", pb, heartbeat_pb);
         copy_context_settings(heartbeat_pb, pb);
+        fit_thumper_http_buffer(heartbeat_pb, channel, channel_group);
         res = pubnub_heartbeat(heartbeat_pb, channel, channel_group);
         if ((res != PNR_STARTED) && (res != PNR_OK)) {
             PUBNUB_LOG_ERROR("heartbeat_thump(pb=%p, heartbeat_pb) - "
@@ -154,6 +235,10 @@ static void heartbeat_thump(pubnub_t* pb, pubnub_t* heartbeat_pb)
         /** Used in sync environment while for callback it's an empty macro */
         add_heartbeat_in_progress(pb->thumperIndex);
     }
+    else {
+        /* Nothing to keep presence on, so no heartbeat */
+        return_thumper_pb(heartbeat_pb);
+    }
     pubnub_mutex_unlock(pb->monitor);
 }
 
@@ -169,18 +254,25 @@ static void auto_heartbeat_callback(pubnub_t*         heartbeat_pb,
 
     /* Maybe something should be done with this */
     pubnub_get(heartbeat_pb);
+    /* The reply is not needed any more, so the thumper doesn't have
+       to keep the reply buffer until the next heartbeat */
+    pubnub_release_reply(heartbeat_pb);
 
     if (PNR_OK == result) {
-        /* Start heartbeat timer */
-        start_heartbeat_timer(thumper_index);
+        return_thumper_pb(heartbeat_pb);
+        if (thumper_index < PUBNUB_MAX_HEARTBEAT_THUMPERS) {
+            /* Start heartbeat timer */
+            start_heartbeat_timer(thumper_index);
+        }
     }
     else {
-        pubnub_t* pb;
-        pubnub_mutex_lock(m_watcher.mutw);
-        pb = m_watcher.heartbeat_data[thumper_index].pb;
-        pubnub_mutex_unlock(m_watcher.mutw);
-
-        if (result != PNR_CANCELLED) {
+        pubnub_t* pb = NULL;
+        if (thumper_index < PUBNUB_MAX_HEARTBEAT_THUMPERS) {
+            pubnub_mutex_lock(m_watcher.mutw);
+            pb = m_watcher.heartbeat_data[thumper_index].pb;
+            pubnub_mutex_unlock(m_watcher.mutw);
+        }
+        if ((result != PNR_CANCELLED) && (pb != NULL)) {
             PUBNUB_LOG_WARNING("punbub_heartbeat(heartbeat_pb=%p) failed with "
                                "code: %d('%s') - "
                                "will try again.\n",
@@ -190,20 +282,14 @@ static void auto_heartbeat_callback(pubnub_t*         heartbeat_pb,
             /* Depending on the kind of error try thumping again */
             heartbeat_thump(pb, heartbeat_pb);
         }
-        else if (pb != NULL) {
-            pubnub_mutex_lock(pb->monitor);
-            if (pubsub_keys_changed(heartbeat_pb, pb)) {
-                pubnub_init(
-                    heartbeat_pb, pb->core.publish_key, pb->core.subscribe_key);
-                heartbeat_thump(pb, heartbeat_pb);
-            }
-            pubnub_mutex_unlock(pb->monitor);
+        else {
+            return_thumper_pb(heartbeat_pb);
         }
     }
 }
 
 
-static pubnub_t* init_new_thumper_pb(pubnub_t* pb, unsigned i)
+static pubnub_t* init_new_thumper_pb(pubnub_t* pb)
 {
     pubnub_t* pb_new;
 
@@ -220,15 +306,80 @@ static pubnub_t* init_new_thumper_pb(pubnub_t* pb, unsigned i)
     pubnub_init(pb_new, pb->core.publish_key, pb->core.subscribe_key);
     pubnub_mutex_unlock(pb->monitor);
 
+#if PUBNUB_DYNAMIC_HTTP_BUFFER
+    if (pubnub_set_http_buffer_size(pb_new, PUBNUB_HEARTBEAT_HTTP_BUF_SIZE) != 0) {
+        PUBNUB_LOG_WARNING("init_new_thumper_pb(pb = %p) - "
+                           "Failed to shrink the HTTP buffer of "
+                           "clone heartbeat context!\n",
+                           pb);
+    }
+#endif
+
     pubnub_mutex_lock(pb_new->monitor);
     pubnub_set_non_blocking_io(pb_new);
-    pb_new->thumperIndex = i;
     pubnub_mutex_unlock(pb_new->monitor);
+#if defined(PUBNUB_CALLBACK_API)
+    pubnub_register_callback(pb_new, auto_heartbeat_callback, NULL);
+#endif
 
     return pb_new;
 }
 
 
+/** Lends a thumper context to the thumper @p thumper_index (of the
+    context @p pb) for its heartbeat. Reuses an idle one from the
+    pool, preferably one with the same origin (as its connection may
+    be kept alive), or allocates a new one if there is none.
+ */
+static pubnub_t* lend_thumper_pb(pubnub_t* pb, unsigned thumper_index)
+{
+    pubnub_t* heartbeat_pb = NULL;
+    unsigned  idle;
+
+    pubnub_mutex_lock(m_watcher.mutw);
+    idle = m_watcher.idle_thumper_pbs_count;
+    if (idle > 0) {
+        unsigned i = idle - 1;
+        if (PUBNUB_ORIGIN_SETTABLE) {
+            unsigned j;
+            for (j = 0; j < idle; j++) {
+                if (m_watcher.idle_thumper_pbs[j]->origin == pb->origin) {
+                    i = j;
+                    break;
+                }
+            }
+        }
+        heartbeat_pb                     = m_watcher.idle_thumper_pbs[i];
+        m_watcher.idle_thumper_pbs[i]    = m_watcher.idle_thumper_pbs[idle - 1];
+        m_watcher.idle_thumper_pbs_count = idle - 1;
+    }
+    else if (m_watcher.thumper_pbs_count < PUBNUB_MAX_HEARTBEAT_THUMPERS) {
+        heartbeat_pb = init_new_thumper_pb(pb);
+        if (heartbeat_pb != NULL) {
+            m_watcher.thumper_pbs[m_watcher.thumper_pbs_count++] = heartbeat_pb;
+        }
+    }
+    else {
+        PUBNUB_LOG_WARNING("lend_thumper_pb(pb=%p) - No more thumper contexts "
+                           "left: PUBNUB_MAX_HEARTBEAT_THUMPERS = %d\n",
+                           pb,
+                           PUBNUB_MAX_HEARTBEAT_THUMPERS);
+    }
+    if (heartbeat_pb != NULL) {
+        m_watcher.heartbeat_data[thumper_index].heartbeat_pb = heartbeat_pb;
+    }
+    pubnub_mutex_unlock(m_watcher.mutw);
+
+    if (heartbeat_pb != NULL) {
+        pubnub_mutex_lock(heartbeat_pb->monitor);
+        heartbeat_pb->thumperIndex = thumper_index;
+        pubnub_mutex_unlock(heartbeat_pb->monitor);
+    }
+
+    return heartbeat_pb;
+}
+
+
 void pbauto_take_the_node_out(unsigned* indexes, unsigned i, unsigned* dimension)
 {
     unsigned* node_out = indexes + i;
@@ -289,17 +440,15 @@ static void handle_heartbeat_timers(int elapsed_ms)
             heartbeat_pb = thumper->heartbeat_pb;
             pubnub_mutex_unlock(m_watcher.mutw);
 
+            if (NULL == pb) {
+                /* Thumper released in the meantime */
+                continue;
+            }
             if (NULL == heartbeat_pb) {
-                heartbeat_pb = init_new_thumper_pb(pb, thumper_index);
+                heartbeat_pb = lend_thumper_pb(pb, thumper_index);
                 if (NULL == heartbeat_pb) {
                     continue;
                 }
-#if defined(PUBNUB_CALLBACK_API)
-                pubnub_register_callback(heartbeat_pb, auto_heartbeat_callback, NULL);
-#endif
-                pubnub_mutex_lock(m_watcher.mutw);
-                thumper->heartbeat_pb = heartbeat_pb;
-                pubnub_mutex_unlock(m_watcher.mutw);
             }
             /* Heartbeat thump */
             heartbeat_thump(pb, heartbeat_pb);
@@ -388,18 +537,7 @@ static int form_heartbeat_thumper(pubnub_t* pb)
     for (i = 0; i < PUBNUB_MAX_HEARTBEAT_THUMPERS; i++) {
         struct pubnub_heartbeat_data* thumper = &heartbeat_data[i];
         if (NULL == thumper->pb) {
-            pubnub_t* heartbeat_pb = thumper->heartbeat_pb;
-            if (NULL == heartbeat_pb) {
-                heartbeat_pb = init_new_thumper_pb(pb, i);
-                if (NULL == heartbeat_pb) {
-                    pubnub_mutex_unlock(m_watcher.mutw);
-                    return -1;
-                }
-#if defined(PUBNUB_CALLBACK_API)
-                pubnub_register_callback(heartbeat_pb, auto_heartbeat_callback, NULL);
-#endif
-                thumper->heartbeat_pb = heartbeat_pb;
-            }
+            /* Thumper context is lent to it only when it thumps */
             pb->thumperIndex    = i;
             thumper->pb         = pb;
             thumper->period_sec = PUBNUB_MIN_HEARTBEAT_PERIOD;
@@ -477,10 +615,18 @@ static void auto_heartbeat_stop_timer(unsigned thumper_index)
 }
 
 
-static void stop_heartbeat(pubnub_t* heartbeat_pb, unsigned thumper_index)
+static void stop_heartbeat(unsigned thumper_index)
 {
-    PUBNUB_ASSERT_OPT(pb_valid_ctx_ptr(heartbeat_pb));
+    pubnub_t* heartbeat_pb;
 
+    pubnub_mutex_lock(m_watcher.mutw);
+    heartbeat_pb = m_watcher.heartbeat_data[thumper_index].heartbeat_pb;
+    pubnub_mutex_unlock(m_watcher.mutw);
+
+    if (NULL == heartbeat_pb) {
+        auto_heartbeat_stop_timer(thumper_index);
+        return;
+    }
     pubnub_mutex_lock(heartbeat_pb->monitor);
     if (pbnc_can_start_transaction(heartbeat_pb)) {
         auto_heartbeat_stop_timer(thumper_index);
@@ -495,22 +641,18 @@ static void stop_heartbeat(pubnub_t* heartbeat_pb, unsigned thumper_index)
 static void release_thumper(unsigned thumper_index)
 {
     if (thumper_index < PUBNUB_MAX_HEARTBEAT_THUMPERS) {
-        struct pubnub_heartbeat_data* thumper;
-        pubnub_t*                     heartbeat_pb;
-
         pubnub_mutex_lock(m_watcher.mutw);
-        thumper      = &m_watcher.heartbeat_data[thumper_index];
-        heartbeat_pb = thumper->heartbeat_pb;
-        thumper->pb  = NULL;
+        m_watcher.heartbeat_data[thumper_index].pb = NULL;
         --m_watcher.thumpers_in_use;
         pubnub_mutex_unlock(m_watcher.mutw);
 
-        stop_heartbeat(heartbeat_pb, thumper_index);
+        stop_heartbeat(thumper_index);
     }
 }
 
 /** If it is a thumper pubnub context, or one that doesn't have thumper assigned, it is
-    exempted from auto heartbeat procedures.
+    exempted from auto heartbeat procedures. (Thumper contexts have
+    the thumper index of the thumper they are lent to, if any.)
   */
 static bool is_exempted(pubnub_t const* pb, unsigned thumper_index)
 {
@@ -561,11 +703,11 @@ void pbauto_heartbeat_free_channelInfo(pubnub_t* pb)
     PUBNUB_ASSERT_OPT(pb_valid_ctx_ptr(pb));
 
     if (pb->channelInfo.channel != NULL) {
-        free(pb->channelInfo.channel);
+        pbmem_free(pb->channelInfo.channel);
         pb->channelInfo.channel = NULL;
     }
     if (pb->channelInfo.channel_group != NULL) {
-        free(pb->channelInfo.channel_group);
+        pbmem_free(pb->channelInfo.channel_group);
         pb->channelInfo.channel_group = NULL;
     }
 }
@@ -582,14 +724,14 @@ void pbauto_heartbeat_read_channelInfo(pubnub_t const* pb,
     *channel_group = pb->channelInfo.channel_group;
 }
 
-#if defined _WIN32
-static char* strndup(char const* str, size_t max_size)
+static char* dup_string(pubnub_t* pb, char const* str, size_t max_size)
 {
     size_t len = pb_strnlen_s(str, PUBNUB_MAX_OBJECT_LENGTH);
     char*  rslt;
     len = (len > max_size) ? max_size : len;
     /* Adding the space for NUL character */
-    rslt = (char*)malloc((++len) * sizeof(char));
+    rslt = (char*)pbmem_alloc(
+        PBCC_MEMORY(&pb->core), pbmemcatHeartbeat, (++len) * sizeof(char));
     if (NULL == rslt) {
         return NULL;
     }
@@ -598,7 +740,6 @@ static char* strndup(char const* str, size_t max_size)
 
     return rslt;
 }
-#endif
 
 static enum pubnub_res write_auto_heartbeat_channelInfo(pubnub_t*   pb,
                                                         char const* channel,
@@ -608,7 +749,7 @@ static enum pubnub_res write_auto_heartbeat_channelInfo(pubnub_t*   pb,
 
     pbauto_heartbeat_free_channelInfo(pb);
     if (channel != NULL) {
-        pb->channelInfo.channel = strndup(channel, PUBNUB_MAX_OBJECT_LENGTH - 1);
+        pb->channelInfo.channel = dup_string(pb, channel, PUBNUB_MAX_OBJECT_LENGTH - 1);
         if (NULL == pb->channelInfo.channel) {
             PUBNUB_LOG_ERROR(
                 "Error: write_auto_heartbeat_info(pb=%p) - "
@@ -621,7 +762,7 @@ static enum pubnub_res write_auto_heartbeat_channelInfo(pubnub_t*   pb,
     }
     if (channel_group != NULL) {
         pb->channelInfo.channel_group =
-            strndup(channel_group, PUBNUB_MAX_OBJECT_LENGTH - 1);
+            dup_string(pb, channel_group, PUBNUB_MAX_OBJECT_LENGTH - 1);
         if (NULL == pb->channelInfo.channel_group) {
             PUBNUB_LOG_ERROR(
                 "Error: write_auto_heartbeat_info(pb=%p) - "
@@ -630,7 +771,7 @@ static enum pubnub_res write_auto_heartbeat_channelInfo(pubnub_t*   pb,
                 pb,
                 channel_group);
             if (channel != NULL) {
-                free(pb->channelInfo.channel);
+                pbmem_free(pb->channelInfo.channel);
                 pb->channelInfo.channel = NULL;
             }
             return PNR_OUT_OF_MEMORY;
@@ -681,34 +822,44 @@ void pbauto_heartbeat_start_timer(pubnub_t const* pb)
 
 void pubnub_heartbeat_free_thumpers(void)
 {
-    unsigned                      i;
-    struct pubnub_heartbeat_data* heartbeat_data = m_watcher.heartbeat_data;
+    unsigned  i;
+    unsigned  count;
+    pubnub_t* thumper_pbs[PUBNUB_MAX_HEARTBEAT_THUMPERS];
 
+    pubnub_mutex_lock(m_watcher.mutw);
+    count = m_watcher.thumper_pbs_count;
+    memcpy(thumper_pbs, m_watcher.thumper_pbs, count * sizeof thumper_pbs[0]);
+    m_watcher.thumper_pbs_count      = 0;
+    m_watcher.idle_thumper_pbs_count = 0;
     for (i = 0; i < PUBNUB_MAX_HEARTBEAT_THUMPERS; i++) {
-        pubnub_t* heartbeat_pb;
+        m_watcher.heartbeat_data[i].heartbeat_pb = NULL;
+    }
+#if !defined(PUBNUB_CALLBACK_API)
+    m_watcher.heartbeats_in_progress = 0;
+#endif
+    pubnub_mutex_unlock(m_watcher.mutw);
 
-        pubnub_mutex_lock(m_watcher.mutw);
-        heartbeat_pb = heartbeat_data[i].heartbeat_pb;
-        pubnub_mutex_unlock(m_watcher.mutw);
+    for (i = 0; i < count; i++) {
+        pubnub_t* heartbeat_pb = thumper_pbs[i];
 
-        if (heartbeat_pb != NULL) {
-            if (pubnub_free_with_timeout(heartbeat_pb, 1000) != 0) {
-                PUBNUB_LOG_ERROR(
-                    "Error: pbauto_heartbeat_free_thumpers() - "
-                    "Failed to free the Pubnub heartbeat %u. thumper context: "
-                    "heartbeat_pb=%p\n",
-                    i,
-                    heartbeat_pb);
-            }
-            else {
-                PUBNUB_LOG_TRACE("pubnub_heartbeat_free_thumpers() - "
-                                 "%u. thumper(heartbeat_pb=%p) freed.\n",
-                                 i + 1,
-                                 heartbeat_pb);
-                pubnub_mutex_lock(m_watcher.mutw);
-                heartbeat_data[i].heartbeat_pb = NULL;
-                pubnub_mutex_unlock(m_watcher.mutw);
-            }
+        /* So that it is not returned to the pool when cancelled */
+        pubnub_mutex_lock(heartbeat_pb->monitor);
+        heartbeat_pb->thumperIndex = UNASSIGNED;
+        pubnub_mutex_unlock(heartbeat_pb->monitor);
+
+        if (pubnub_free_with_timeout(heartbeat_pb, 1000) != 0) {
+            PUBNUB_LOG_ERROR(
+                "Error: pbauto_heartbeat_free_thumpers() - "
+                "Failed to free the Pubnub heartbeat %u. thumper context: "
+                "heartbeat_pb=%p\n",
+                i,
+                heartbeat_pb);
+        }
+        else {
+            PUBNUB_LOG_TRACE("pubnub_heartbeat_free_thumpers() - "
+                             "%u. thumper(heartbeat_pb=%p) freed.\n",
+                             i + 1,
+                             heartbeat_pb);
         }
     }
     /* Waits until the contexts are released from the processing queue */
@@ -716,18 +867,6 @@ void pubnub_heartbeat_free_thumpers(void)
 }
 
 
-static void stop_auto_heartbeat(unsigned thumper_index)
-{
-    pubnub_t* heartbeat_pb;
-
-    pubnub_mutex_lock(m_watcher.mutw);
-    heartbeat_pb = m_watcher.heartbeat_data[thumper_index].heartbeat_pb;
-    pubnub_mutex_unlock(m_watcher.mutw);
-
-    stop_heartbeat(heartbeat_pb, thumper_index);
-}
-
-
 void pbauto_heartbeat_transaction_ongoing(pubnub_t const* pb)
 {
     PUBNUB_ASSERT_OPT(pb_valid_ctx_ptr(pb));
@@ -741,7 +880,7 @@ void pbauto_heartbeat_transaction_ongoing(pubnub_t const* pb)
             /*FALLTHRU*/
         case PBTT_SUBSCRIBE:
         case PBTT_SUBSCRIBE_V2:
-            stop_auto_heartbeat(pb->thumperIndex);
+            stop_heartbeat(pb->thumperIndex);
             break;
         default:
             break;
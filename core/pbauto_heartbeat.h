@@ -21,8 +21,23 @@ typedef void*           pubnub_watcher_t;
 #define PUBNUB_MAX_HEARTBEAT_THUMPERS 16
 #define UNASSIGNED PUBNUB_MAX_HEARTBEAT_THUMPERS
 
+#if !defined PUBNUB_HEARTBEAT_HTTP_BUF_SIZE
+/** The (initial) size of the HTTP buffer of the contexts which send
+    the auto heartbeats, if #PUBNUB_DYNAMIC_HTTP_BUFFER is true. It
+    only has to hold the heartbeat request (and the lines of the
+    response header), so it is a lot smaller than the default, and
+    it grows as needed for long lists of channels (and groups).
+ */
+#define PUBNUB_HEARTBEAT_HTTP_BUF_SIZE PUBNUB_MIN_HTTP_BUF_SIZE
+#endif
+
+/** Auto heartbeat data of one (subscribing) context - its thumper */
 struct pubnub_heartbeat_data {
+    /** The context whose presence is kept, NULL if the thumper is free */
     pubnub_t* pb;
+    /** The context sending the heartbeat of this thumper, lent from
+        the pool (of HeartbeatWatcherData) only while the heartbeat is
+        in progress, otherwise NULL. */
     pubnub_t* heartbeat_pb;
     size_t    period_sec;
 };
@@ -38,6 +53,17 @@ struct HeartbeatWatcherData {
     unsigned heartbeats_in_progress pubnub_guarded_by(mutw);
 #endif
     unsigned thumpers_in_use pubnub_guarded_by(mutw);
+    /** All the contexts that send the heartbeats. They are shared by
+        all the thumpers, so there are only as many as there were
+        heartbeats in progress at one time, not one per thumper.
+      */
+    pubnub_t* thumper_pbs[PUBNUB_MAX_HEARTBEAT_THUMPERS] pubnub_guarded_by(mutw);
+    /** Number of contexts in #thumper_pbs */
+    unsigned thumper_pbs_count pubnub_guarded_by(mutw);
+    /** Contexts (from #thumper_pbs) not lent to any thumper at the moment */
+    pubnub_t* idle_thumper_pbs[PUBNUB_MAX_HEARTBEAT_THUMPERS] pubnub_guarded_by(mutw);
+    /** Number of contexts in #idle_thumper_pbs */
+    unsigned idle_thumper_pbs_count pubnub_guarded_by(mutw);
     /** Times left for each of the thumper timers in progress */
     size_t heartbeat_timers[PUBNUB_MAX_HEARTBEAT_THUMPERS] pubnub_guarded_by(timerlock);
     /** Array of thumper indexes whos auto heartbeat timers are active and running */
@@ -96,7 +96,7 @@ enum pubnub_res pbcc_add_action_prep(struct pbcc_context* pb,
     pb->http_content_len = 0;
     pb->msg_ofs = pb->msg_end = 0;
     pb->http_buf_len = snprintf(pb->http_buf,
-                                sizeof pb->http_buf,
+                                PBCC_HTTP_BUF_SIZE(pb),
                                 "/v1/message-actions/%s/channel/",
                                 pb->subscribe_key);
     APPEND_URL_ENCODED_M(pb, channel);
@@ -231,7 +231,7 @@ enum pubnub_res pbcc_remove_action_prep(struct pbcc_context* pb,
     pb->http_content_len = 0;
     pb->msg_ofs = pb->msg_end = 0;
     pb->http_buf_len = snprintf(pb->http_buf,
-                                sizeof pb->http_buf,
+                                PBCC_HTTP_BUF_SIZE(pb),
                                 "/v1/message-actions/%s/channel/",
                                 pb->subscribe_key);
     APPEND_URL_ENCODED_M(pb, channel);
@@ -262,7 +262,7 @@ enum pubnub_res pbcc_get_actions_prep(struct pbcc_context* pb,
     pb->http_content_len = 0;
     pb->msg_ofs = pb->msg_end = 0;
     pb->http_buf_len = snprintf(pb->http_buf,
-                                sizeof pb->http_buf,
+                                PBCC_HTTP_BUF_SIZE(pb),
                                 "/v1/message-actions/%s/channel/",
                                 pb->subscribe_key);
     APPEND_URL_ENCODED_M(pb, channel);
@@ -325,7 +325,7 @@ enum pubnub_res pbcc_get_actions_more_prep(struct pbcc_context* pb)
     pb->http_content_len = 0;
     pb->msg_ofs = pb->msg_end = 0;
     pb->http_buf_len = snprintf(pb->http_buf,
-                                sizeof pb->http_buf,
+                                PBCC_HTTP_BUF_SIZE(pb),
                                 "%.*s",
                                 (int)(elem.end - elem.start - 2),
                                 elem.start + 1);
@@ -352,7 +352,7 @@ enum pubnub_res pbcc_history_with_actions_prep(struct pbcc_context* pb,
     pb->http_content_len = 0;
     pb->msg_ofs = pb->msg_end = 0;
     pb->http_buf_len = snprintf(pb->http_buf,
-                                sizeof pb->http_buf,
+                                PBCC_HTTP_BUF_SIZE(pb),
                                 "/v3/history-with-actions/sub-key/%s/channel/",
                                 pb->subscribe_key);
     APPEND_URL_ENCODED_M(pb, channel);
@@ -8,9 +8,14 @@
 #include "pubnub_version.h"
 #include "pubnub_json_parse.h"
 #include "pubnub_url_encode.h"
+#include "pubnub_helper.h"
+#include "pbmem.h"
 
 #include "pubnub_assert.h"
 #include "pubnub_log.h"
+
+#include <limits.h>
+#include <string.h>
 #else
 #error this module can only be used if PUBNUB_USE_ADVANCED_HISTORY is defined and set to 1
 #endif
@@ -18,6 +23,50 @@
 
 #define PUBNUB_MIN_TIMETOKEN_LEN 4
 
+/** Initial size of the message buffer of a history stream */
+#define PBCC_HISTORY_STREAM_INITIAL_SIZE 1024
+
+
+/** The history stream: parses a history response
+    (`[[msg,msg,...],"start","end"]`) as it arrives, keeping only the
+    messages received, but not yet taken by the user.
+ */
+struct pbcc_history_stream {
+    /** Holds the messages received but not yet taken (each NUL
+        terminated), followed by the part of the message being
+        received. Messages before `head` were taken and are dropped
+        when the stream is fed again.
+     */
+    char* buf;
+    /** Allocated size of `buf` */
+    size_t size;
+    /** Offset of the first message not yet taken */
+    size_t head;
+    /** Offset of the end of the (completely) received messages */
+    size_t tail;
+    /** Offset of the end of the data in `buf` */
+    size_t len;
+    /** JSON nesting depth at the current position in the response */
+    unsigned depth;
+    /** Index of the current element of the outer array */
+    unsigned outer_index;
+    /** Currently inside a JSON string */
+    bool in_string;
+    /** The previous character was a backslash (in a string) */
+    bool escaped;
+    /** Currently inside a message */
+    bool in_msg;
+    /** Messages are expected to have time tokens */
+    bool include_token;
+    /** The response of the current history transaction is to be
+        streamed */
+    bool requested;
+    /** The response body is fed as it arrives */
+    bool receiving;
+    /** The whole response was parsed */
+    bool complete;
+};
+
 
 enum pubnub_res pbcc_parse_message_counts_response(struct pbcc_context* p)
 {
@@ -127,68 +176,103 @@ int pbcc_get_chan_msg_counts_size(struct pbcc_context* p)
 }
 
 
-int pbcc_get_chan_msg_counts(struct pbcc_context* p, 
-                             size_t* io_count, 
-                             struct pubnub_chan_msg_count* chan_msg_counters)
+/** Parses the (decimal, non-negative) message count at @p s, after
+    the colon which follows the channel name, until @p end.
+    @return Pointer to the first character after the count, NULL if
+    there is no (valid) count at @p s
+ */
+static char const* read_count(char const* s, char const* end, size_t* o_count)
 {
-    char const*  ch_start;
-    char const*  end;
-    size_t count = 0;
-
-    ch_start = p->http_reply + p->msg_ofs;
-    end = p->http_reply + p->msg_end + 1;
-    if (ch_start >= end - 1) {
-        *io_count = 0;
-        return 0;
+    char const* digits;
+    size_t      count = 0;
+
+    s = pbjson_skip_whitespace(s, end);
+    if ((s == end) || (*s != ':')) {
+        return NULL;
     }
-    ch_start = pbjson_skip_whitespace(ch_start, end);
-    while ((ch_start < end) && (count < *io_count)) {
-        char const* ch_end = pbjson_find_end_element(ch_start, end);
-        
-        chan_msg_counters[count].channel.size = ch_end - ch_start - 1;
-        chan_msg_counters[count].channel.ptr = (char*)(ch_start + 1),
-        ch_start = pbjson_skip_whitespace(ch_end + 1, end);
-        if (*ch_start != ':') {
-            PUBNUB_LOG_DEBUG("Note: pubnub_get_chan_msg_counts(pbcc=%p) - "
-                             "colon missing after channel name=%*.s\n"
-                             "characters after channel name='%s'\n",
-                             p,
-                             (int)chan_msg_counters[count].channel.size,
-                             chan_msg_counters[count].channel.ptr,
-                             ch_start);
+    digits = s = pbjson_skip_whitespace(s + 1, end);
+    for (; (s < end) && (*s >= '0') && (*s <= '9'); ++s) {
+        unsigned digit = *s - '0';
+        if (count > (SIZE_MAX - digit) / 10) {
+            return NULL;
         }
-        else if (sscanf(++ch_start,
-                        "%lu",
-                        (unsigned long*)&(chan_msg_counters[count].message_count)) != 1) {
-            PUBNUB_LOG_DEBUG("Note: pubnub_get_chan_msg_counts(pbcc=%p) - "
-                             "failed to read the message count for channel='%*.s'\n"
-                             "got these characters instead='%s'\n",
-                             p,
-                             (int)chan_msg_counters[count].channel.size,
-                             chan_msg_counters[count].channel.ptr,                             
-                             ch_start - 1);
+        count = count * 10 + digit;
+    }
+    if (s == digits) {
+        return NULL;
+    }
+    *o_count = count;
+
+    return s;
+}
+
+
+struct pubnub_chan_msg_count pbcc_get_chan_msg_count(struct pbcc_context* p)
+{
+    struct pubnub_chan_msg_count rslt;
+    char const*                  end = p->http_reply + p->msg_end;
+    char const*                  pos;
+
+    rslt.channel.ptr   = NULL;
+    rslt.channel.size  = 0;
+    rslt.message_count = 0;
+    pos = pbjson_skip_whitespace(p->http_reply + p->msg_ofs, end);
+    while ((pos < end) && (NULL == rslt.channel.ptr)) {
+        char const* next = NULL;
+
+        if ('"' == *pos) {
+            char const* name_end = pbjson_find_end_string(pos + 1, end);
+            if (name_end < end) {
+                next = read_count(name_end + 1, end, &rslt.message_count);
+                if (NULL != next) {
+                    rslt.channel.ptr  = (char*)pos + 1;
+                    rslt.channel.size = name_end - pos - 1;
+                }
+            }
         }
-        else {
-            ++count;
+        if (NULL == next) {
+            PUBNUB_LOG_DEBUG("Note: pbcc_get_chan_msg_count(pbcc=%p) - "
+                             "skipping malformed channel message count='%.*s'\n",
+                             p,
+                             (int)(end - pos),
+                             pos);
+            next = pos;
         }
-        while((*ch_start != ',') && (ch_start < end)) {
-            ch_start++;
+        while ((next < end) && (*next != ',')) {
+            ++next;
         }
-        if (ch_start == end) {
+        pos = pbjson_skip_whitespace(next + (next < end), end);
+    }
+    p->msg_ofs = pos - p->http_reply;
+
+    return rslt;
+}
+
+
+int pbcc_get_chan_msg_counts(struct pbcc_context* p, 
+                             size_t* io_count, 
+                             struct pubnub_chan_msg_count* chan_msg_counters)
+{
+    char const* end   = p->http_reply + p->msg_end;
+    size_t      count = 0;
+
+    while (count < *io_count) {
+        struct pubnub_chan_msg_count counter = pbcc_get_chan_msg_count(p);
+        if (NULL == counter.channel.ptr) {
             break;
         }
-        ch_start = pbjson_skip_whitespace(ch_start + 1, end);
+        chan_msg_counters[count++] = counter;
     }
-    if ((count == *io_count) && (ch_start != end)) {
+    if ((count == *io_count)
+        && (pbjson_skip_whitespace(p->http_reply + p->msg_ofs, end) < end)) {
         PUBNUB_LOG_DEBUG("Note: pubnub_get_chan_msg_counts(pbcc=%p) - "
                          "more than expected message counters,\n"
-                         "unhandled part of the response='%s'\n",
+                         "unhandled part of the response='%.*s'\n",
                          p,
-                         ch_start);
-    }
-    else {
-        *io_count = count;
+                         (int)(end - p->http_reply - p->msg_ofs),
+                         p->http_reply + p->msg_ofs);
     }
+    *io_count  = count;
     p->msg_ofs = p->msg_end;
     
     return 0;
@@ -206,10 +290,7 @@ static int initialize_msg_counters(char const* channel, int* o_count)
         for (++next; ' ' == *next; next++) continue ;
         /* Saving negative channel offsets(-1) in the array of counters.
            That is, if channel name from the 'channel' list is not found in the answer
-           corresponding array member stays negative, while when channel name(from the
-           'channel' list) is found in the response this value is used for locating
-           channel name within the list od channels before it is changed to its
-           corresponding message counter value(which could, also, be zero).
+           corresponding array member stays negative.
          */
         o_count[n] = -(next - channel) - 1;
     }
@@ -217,81 +298,159 @@ static int initialize_msg_counters(char const* channel, int* o_count)
 }
 
 
-int pbcc_get_message_counts(struct pbcc_context* p, char const* channel, int* o_count)
+/** A slot of the (open addressing) hash table of the channels from the
+    'channel' list of a message_counts request.
+ */
+struct chan_slot {
+    /** Channel name (not NUL terminated), NULL if the slot is free */
+    char const* name;
+    /** Length of the channel name */
+    size_t len;
+    /** Index of the channel in the 'channel' list */
+    int index;
+};
+
+
+/** Up to this many channels in the 'channel' list, they are looked up
+    by going through the list, rather than by hashing.
+ */
+#define PBCC_MSG_COUNTS_LINEAR_MAX 8
+
+
+/** FNV-1a hash of the channel name @p name of length @p len */
+static uint32_t hash_channel(char const* name, size_t len)
 {
-    char const* ch_start;
-    char const* end;
-    int         n = initialize_msg_counters(channel, o_count);
-    int         counts = 0;
+    uint32_t hash = 2166136261u;
 
-    ch_start = p->http_reply + p->msg_ofs;
-    end = p->http_reply + p->msg_end + 1;
-    if (ch_start >= end - 1) {
-        /* Response message carries no counters */
-        return 0;
+    while (len-- > 0) {
+        hash ^= (unsigned char)*name++;
+        hash *= 16777619u;
     }
-    ch_start = pbjson_skip_whitespace(ch_start, end);
-    while((ch_start < end) && (counts < n)) {
-        /* index in the array of message counters */
-        int         i = 0;
-        /* channel name length */
-        unsigned    len;
-        char const* ptr_ch;
-        char const* ch_end;
-        ch_end = (char*)pbjson_find_end_element(ch_start++, end);
-        len = ch_end - ch_start;
-        for (i = 0; i < n ; i++) {
-            ptr_ch = channel - o_count[i] - 1;
-            /* Comparing channel name found in response message with name from 'channel' list. */
-            if ((memcmp(ptr_ch, ch_start, len) == 0) &&
-                ((' ' == *(ptr_ch + len)) || (',' == *(ptr_ch + len)) || ('\0' == *(ptr_ch + len)))) {
+    return hash;
+}
+
+
+/** Length of the channel name @p name from the 'channel' list */
+static size_t channel_name_len(char const* name)
+{
+    return strcspn(name, " ,");
+}
+
+
+/** Makes the hash table with (at least) twice as many slots as there
+    are channels in the 'channel' list (@p n), so that the lookup
+    seldom needs to probe more than one or two slots.
+    @return The table, NULL on failure
+ */
+static struct chan_slot* make_chan_table(struct pbcc_context* p,
+                                         char const*          channel,
+                                         int const*           o_count,
+                                         int                  n,
+                                         size_t*              o_mask)
+{
+    struct chan_slot* table;
+    size_t            size = 16;
+    int               i;
+
+    while (size < 2 * (size_t)n) {
+        size *= 2;
+    }
+    table = (struct chan_slot*)pbmem_calloc(
+        PBCC_MEMORY(p), pbmemcatReply, size, sizeof *table);
+    if (NULL == table) {
+        return NULL;
+    }
+    for (i = 0; i < n; ++i) {
+        char const* name = channel - o_count[i] - 1;
+        size_t      len  = channel_name_len(name);
+        size_t      slot = hash_channel(name, len) & (size - 1);
+        /* If a channel is listed more than once, the first one is used */
+        while (table[slot].name != NULL) {
+            if ((table[slot].len == len) && (0 == memcmp(table[slot].name, name, len))) {
                 break;
             }
+            slot = (slot + 1) & (size - 1);
         }
-        if (i == n) {
-            PUBNUB_LOG_DEBUG("Note: pubnub_get_msg_counts(pbcc=%p) - "
-                             "channel not present in the query list 'channel',\n"
-                             "unhandled channel from the response='%*.s'\n",
-                             p,
-                             len,
-                             ch_start);
+        if (NULL == table[slot].name) {
+            table[slot].name  = name;
+            table[slot].len   = len;
+            table[slot].index = i;
         }
-        ch_start = pbjson_skip_whitespace(ch_end + 1, end);
-        if (*ch_start != ':') {
-            PUBNUB_LOG_DEBUG("Note: pubnub_get_msg_counts(pbcc=%p) - "
-                             "colon missing after channel name='%*.s'\n"
-                             "characters after channel name='%s'",
-                             p,
-                             len,
-                             ptr_ch,
-                             ch_start);
-        }    /* Saving message count value in the array provided */
-        else if (sscanf(++ch_start, "%u", (unsigned*)(o_count + i)) != 1) {
-            PUBNUB_LOG_DEBUG("Note: pubnub_get_msg_counts(pbcc=%p) - "
-                             "failed to read the message count for channel='%*.s'\n"
-                             "got these characters instead='%s'\n",
-                             p,
-                             len,
-                             ptr_ch,
-                             ch_start - 1);
+    }
+    *o_mask = size - 1;
+
+    return table;
+}
+
+
+/** Finds the channel @p name of length @p len in the @p table if there
+    is one, otherwise goes through the 'channel' list.
+    @return Index of the channel in the 'channel' list, -1 if it's not
+    in the list
+ */
+static int find_channel(struct chan_slot const* table,
+                        size_t                  mask,
+                        char const*             channel,
+                        char const*             name,
+                        size_t                  len)
+{
+    int i;
+
+    if (NULL != table) {
+        size_t slot;
+        for (slot = hash_channel(name, len) & mask; table[slot].name != NULL;
+             slot = (slot + 1) & mask) {
+            if ((table[slot].len == len) && (0 == memcmp(table[slot].name, name, len))) {
+                return table[slot].index;
+            }
         }
-        else {
-            ++counts;
+        return -1;
+    }
+    for (i = 0; channel != NULL; ++i) {
+        channel += strspn(channel, " ");
+        if ((channel_name_len(channel) == len) && (0 == memcmp(channel, name, len))) {
+            return i;
         }
-        while((*ch_start != ',') && (ch_start < end)) {
-            ch_start++;
+        channel = strchr(channel, ',');
+        if (channel != NULL) {
+            ++channel;
         }
-        if (ch_start == end) {
+    }
+    return -1;
+}
+
+
+int pbcc_get_message_counts(struct pbcc_context* p, char const* channel, int* o_count)
+{
+    struct chan_slot* table = NULL;
+    size_t            mask  = 0;
+    int               n     = initialize_msg_counters(channel, o_count);
+
+    if (n > PBCC_MSG_COUNTS_LINEAR_MAX) {
+        table = make_chan_table(p, channel, o_count, n, &mask);
+    }
+    for (;;) {
+        struct pubnub_chan_msg_count counter = pbcc_get_chan_msg_count(p);
+        int                          i;
+        if (NULL == counter.channel.ptr) {
             break;
         }
-        ch_start = pbjson_skip_whitespace(ch_start + 1, end);
+        i = find_channel(table, mask, channel, counter.channel.ptr, counter.channel.size);
+        if (i < 0) {
+            PUBNUB_LOG_DEBUG("Note: pubnub_get_msg_counts(pbcc=%p) - "
+                             "channel not present in the query list 'channel',\n"
+                             "unhandled channel from the response='%.*s'\n",
+                             p,
+                             (int)counter.channel.size,
+                             counter.channel.ptr);
+            continue;
+        }
+        /* Saving message count value in the array provided */
+        o_count[i] = (counter.message_count > INT_MAX) ? INT_MAX
+                                                       : (int)counter.message_count;
     }
-    if ((counts == n) && (ch_start != end)) {
-        PUBNUB_LOG_DEBUG("Note: pubnub_get_msg_counts(pbcc=%p) - "
-                         "more than expected message counters,\n"
-                         "unhandled part of the response='%s'\n",
-                         p,
-                         ch_start);
+    if (NULL != table) {
+        pbmem_free(table);
     }
     p->msg_ofs = p->msg_end;
     return 0;
@@ -495,7 +654,7 @@ enum pubnub_res pbcc_message_counts_prep(struct pbcc_context* p,
     p->msg_ofs = p->msg_end = 0;
 
     p->http_buf_len = snprintf(p->http_buf,
-                               sizeof p->http_buf,
+                               PBCC_HTTP_BUF_SIZE(p),
                                "/v3/history/sub-key/%s/message-counts/",
                                p->subscribe_key);
     APPEND_URL_ENCODED_M(p, channel);
@@ -507,3 +666,309 @@ enum pubnub_res pbcc_message_counts_prep(struct pbcc_context* p,
 
     return PNR_STARTED;
 }
+
+
+int pbcc_history_stream_request(struct pbcc_context* p, bool include_token)
+{
+    struct pbcc_history_stream* st = p->history_stream;
+
+    if (NULL == st) {
+        st = (struct pbcc_history_stream*)pbmem_alloc(
+            PBCC_MEMORY(p), pbmemcatReply, sizeof *st);
+        if (NULL == st) {
+            return -1;
+        }
+        st->buf           = NULL;
+        st->size          = 0;
+        p->history_stream = st;
+    }
+    pbcc_history_stream_reset(p);
+    st->include_token = include_token;
+    st->requested     = true;
+
+    return 0;
+}
+
+
+void pbcc_history_stream_reset(struct pbcc_context* p)
+{
+    struct pbcc_history_stream* st = p->history_stream;
+
+    if (st != NULL) {
+        st->head = st->tail = st->len = 0;
+        st->depth = st->outer_index = 0;
+        st->in_string = st->escaped = st->in_msg = false;
+        st->requested = st->receiving = st->complete = false;
+    }
+}
+
+
+bool pbcc_history_stream_requested(struct pbcc_context const* p)
+{
+    return (p->history_stream != NULL) && p->history_stream->requested;
+}
+
+
+void pbcc_history_stream_receive(struct pbcc_context* p)
+{
+    PUBNUB_ASSERT_OPT(pbcc_history_stream_requested(p));
+    p->history_stream->receiving = true;
+}
+
+
+bool pbcc_history_stream_receiving(struct pbcc_context const* p)
+{
+    return (p->history_stream != NULL) && p->history_stream->receiving;
+}
+
+
+bool pbcc_history_stream_full(struct pbcc_context const* p)
+{
+    struct pbcc_history_stream const* st = p->history_stream;
+    return (st != NULL)
+           && (st->tail - st->head >= PUBNUB_HISTORY_STREAM_MAX_PENDING);
+}
+
+
+static bool is_space(char c)
+{
+    return (' ' == c) || ('\t' == c) || ('\r' == c) || ('\n' == c);
+}
+
+
+/** Appends @p len bytes at @p data to the message being received on
+    the stream @p st of context @p p. Drops the messages that were
+    taken and grows the buffer, if needed.
+ */
+static enum pubnub_res stream_append(struct pbcc_context*        p,
+                                     struct pbcc_history_stream* st,
+                                     char const*                 data,
+                                     size_t                      len)
+{
+    if (st->head > 0) {
+        memmove(st->buf, st->buf + st->head, st->len - st->head);
+        st->tail -= st->head;
+        st->len -= st->head;
+        st->head = 0;
+    }
+    /* Leave room for the NUL terminator, too */
+    if (st->len + len + 1 > st->size) {
+        size_t size = (0 == st->size) ? PBCC_HISTORY_STREAM_INITIAL_SIZE : st->size;
+        char*  buf;
+        while (size < st->len + len + 1) {
+            size *= 2;
+        }
+        buf = (char*)pbmem_realloc(PBCC_MEMORY(p), pbmemcatReply, st->buf, size);
+        if (NULL == buf) {
+            PUBNUB_LOG_ERROR("pbcc=%p: Failed to grow the history stream "
+                             "buffer to %lu bytes\n",
+                             p,
+                             (unsigned long)size);
+            return PNR_OUT_OF_MEMORY;
+        }
+        st->buf  = buf;
+        st->size = size;
+    }
+    memcpy(st->buf + st->len, data, len);
+    st->len += len;
+
+    return PNR_OK;
+}
+
+
+/** Finishes the message being received on the stream @p st, making it
+    available to be taken.
+ */
+static enum pubnub_res stream_end_msg(struct pbcc_history_stream* st)
+{
+    while ((st->len > st->tail) && is_space(st->buf[st->len - 1])) {
+        --st->len;
+    }
+    if (st->len == st->tail) {
+        return PNR_FORMAT_ERROR;
+    }
+    st->buf[st->len++] = '\0';
+    st->tail           = st->len;
+    st->in_msg         = false;
+
+    return PNR_OK;
+}
+
+
+enum pubnub_res pbcc_history_stream_feed(struct pbcc_context* p,
+                                         char const*          data,
+                                         size_t               len)
+{
+    struct pbcc_history_stream* st  = p->history_stream;
+    char const*                 end = data + len;
+    char const*                 msg_start;
+    char const*                 s;
+    enum pubnub_res             rslt = PNR_OK;
+
+    PUBNUB_ASSERT_OPT(st != NULL);
+
+    msg_start = data;
+    for (s = data; (s < end) && (PNR_OK == rslt); ++s) {
+        char c = *s;
+        if (st->in_string) {
+            if (st->escaped) {
+                st->escaped = false;
+            }
+            else if ('\\' == c) {
+                st->escaped = true;
+            }
+            else if ('"' == c) {
+                st->in_string = false;
+            }
+            continue;
+        }
+        if (is_space(c)) {
+            continue;
+        }
+        if (st->complete) {
+            rslt = PNR_FORMAT_ERROR;
+            break;
+        }
+        switch (c) {
+        case '[':
+        case '{':
+            if ((st->depth < 2) && (('[' != c) || (st->outer_index > 0))) {
+                /* Only the outer and message arrays are expected here */
+                rslt = PNR_FORMAT_ERROR;
+            }
+            else if ((2 == st->depth) && !st->in_msg) {
+                st->in_msg = true;
+                msg_start  = s;
+            }
+            ++st->depth;
+            break;
+        case ']':
+        case '}':
+            if ((0 == st->depth) || ((st->depth <= 2) && (']' != c))) {
+                rslt = PNR_FORMAT_ERROR;
+                break;
+            }
+            if ((2 == st->depth) && st->in_msg) {
+                rslt = stream_append(p, st, msg_start, s - msg_start);
+                if (PNR_OK == rslt) {
+                    rslt = stream_end_msg(st);
+                }
+            }
+            if (0 == --st->depth) {
+                st->complete = true;
+            }
+            break;
+        case ',':
+            if (2 == st->depth) {
+                rslt = st->in_msg ? stream_append(p, st, msg_start, s - msg_start)
+                                  : PNR_FORMAT_ERROR;
+                if (PNR_OK == rslt) {
+                    rslt = stream_end_msg(st);
+                }
+            }
+            else if (1 == st->depth) {
+                ++st->outer_index;
+            }
+            else if (0 == st->depth) {
+                rslt = PNR_FORMAT_ERROR;
+            }
+            break;
+        case '"':
+            st->in_string = true;
+            /* FALLTHRU */
+        default:
+            if ((0 == st->depth) || ((1 == st->depth) && (0 == st->outer_index))) {
+                rslt = PNR_FORMAT_ERROR;
+            }
+            else if ((2 == st->depth) && !st->in_msg) {
+                st->in_msg = true;
+                msg_start  = s;
+            }
+            break;
+        }
+    }
+    if ((PNR_OK == rslt) && st->in_msg) {
+        rslt = stream_append(p, st, msg_start, end - msg_start);
+    }
+    if (rslt != PNR_OK) {
+        PUBNUB_LOG_ERROR("pbcc=%p: Failed to parse history stream, error %d, "
+                         "at: '%.*s'\n",
+                         p,
+                         rslt,
+                         (int)(end - s),
+                         s);
+    }
+
+    return rslt;
+}
+
+
+enum pubnub_res pbcc_parse_history_stream_response(struct pbcc_context* p)
+{
+    struct pbcc_history_stream* st   = p->history_stream;
+    enum pubnub_res             rslt = PNR_OK;
+
+    PUBNUB_ASSERT_OPT(pbcc_history_stream_requested(p));
+
+    if (!st->receiving) {
+        rslt = pbcc_history_stream_feed(p, p->http_reply, p->http_buf_len);
+    }
+    st->requested = st->receiving = false;
+    if ((PNR_OK == rslt) && !st->complete) {
+        PUBNUB_LOG_ERROR("pbcc=%p: History stream response incomplete\n", p);
+        rslt = PNR_FORMAT_ERROR;
+    }
+
+    return rslt;
+}
+
+
+bool pbcc_history_stream_get(struct pbcc_context* p, struct pubnub_history_message* msg)
+{
+    struct pbcc_history_stream* st = p->history_stream;
+    struct pbjson_elem          el;
+    struct pbjson_elem          found;
+
+    PUBNUB_ASSERT_OPT(msg != NULL);
+
+    if ((NULL == st) || (st->head == st->tail)) {
+        return false;
+    }
+    el.start = st->buf + st->head;
+    el.end   = el.start + strlen(el.start);
+    st->head += el.end - el.start + 1;
+
+    msg->message.ptr    = (char*)el.start;
+    msg->message.size   = el.end - el.start;
+    msg->timetoken.ptr  = NULL;
+    msg->timetoken.size = 0;
+    msg->tt_u64         = 0;
+    if (st->include_token && ('{' == *el.start)
+        && (jonmpOK == pbjson_get_object_value(&el, "message", &found))) {
+        msg->message.ptr  = (char*)found.start;
+        msg->message.size = found.end - found.start;
+        if (jonmpOK == pbjson_get_object_value(&el, "timetoken", &found)) {
+            if ('"' == *found.start) {
+                ++found.start;
+                --found.end;
+            }
+            msg->timetoken.ptr  = (char*)found.start;
+            msg->timetoken.size = found.end - found.start;
+            msg->tt_u64 = pubnub_timetoken_to_u64(found.start, found.end - found.start);
+        }
+    }
+
+    return true;
+}
+
+
+void pbcc_history_stream_free(struct pbcc_context* p)
+{
+    if (p->history_stream != NULL) {
+        if (p->history_stream->buf != NULL) {
+            pbmem_free(p->history_stream->buf);
+        }
+        pbmem_free(p->history_stream);
+        p->history_stream = NULL;
+    }
+}
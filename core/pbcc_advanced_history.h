@@ -6,15 +6,45 @@
 /** @file pbcc_advanced_history.h
 
     This has the functions for formating and parsing the
-    requests and responses for 'advanced history' transactions
+    requests and responses for 'advanced history' transactions,
+    as well as the "history stream", which parses a history response
+    as it arrives.
 */
 
-typedef struct pubnub_char_mem_block pubnub_chamebl_t;
+#include "pubnub_memory_block.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+
+#if !defined PUBNUB_HISTORY_STREAM_MAX_PENDING
+/** While there are at least this many bytes of messages received on
+    a history stream, but not yet taken by the user, no more of the
+    response is read (in the sync interface). Thus, this (plus the
+    size of the HTTP buffer and the largest message) bounds the memory
+    used for receiving a streamed history response.
+ */
+#define PUBNUB_HISTORY_STREAM_MAX_PENDING 16384
+#endif
 
 struct pubnub_chan_msg_count;
 
 struct pbcc_context;
 
+/** A message from a history response, as taken from a history
+    stream.
+ */
+struct pubnub_history_message {
+    /** The message (JSON) */
+    pubnub_chamebl_t message;
+    /** The time token of the message (without quotes, if it had
+        them) if time tokens were requested, otherwise empty */
+    pubnub_chamebl_t timetoken;
+    /** The time token of the message as an integer, 0 if there is
+        none */
+    uint64_t tt_u64;
+};
+
 
 /** Parses server response on 'message_counts' transaction request and prepares
     msg offset for reading the content of json object for 'channels' key containing
@@ -39,6 +69,13 @@ int pbcc_get_error_message(struct pbcc_context* p, pubnub_chamebl_t* o_msg);
  */
 int pbcc_get_chan_msg_counts_size(struct pbcc_context* p);
 
+/** Returns the next channel message counter from the response,
+    skipping malformed ones. The channel name points into the
+    response, it is not copied. If there are no more counters, the
+    channel name `ptr` is NULL.
+ */
+struct pubnub_chan_msg_count pbcc_get_chan_msg_count(struct pbcc_context* p);
+
 /** On input, @p io_count is the number of allocated "counters per channel"(array
     dimension of @p chan_msg_counters). On output(@p io_count), number of counters per
     channel in the answer. If there are more in the answer than there are in the allocated
@@ -68,6 +105,75 @@ enum pubnub_res pbcc_message_counts_prep(struct pbcc_context* p,
                                          char const*          channel,
                                          char const*          timetoken,
                                          char const*          channel_timetokens);
+
+/** Requests that the response of the history transaction about to be
+    started on @p p be "streamed", that is, parsed as it arrives, with
+    the messages kept until taken by pbcc_history_stream_get(). If
+    @p include_token, messages are expected to have time tokens (be
+    objects with "message" and "timetoken" keys).
+    Drops anything left from a previous stream.
+    @retval 0 OK
+    @retval -1 can't allocate the stream
+ */
+int pbcc_history_stream_request(struct pbcc_context* p, bool include_token);
+
+/** Drops the history stream request of @p p (if any) and the messages
+    that were not taken from it.
+ */
+void pbcc_history_stream_reset(struct pbcc_context* p);
+
+/** Returns whether the response of the current history transaction
+    on @p p is to be streamed.
+ */
+bool pbcc_history_stream_requested(struct pbcc_context const* p);
+
+/** To be called when the response body of the (streamed) history
+    transaction on @p p is to be fed to pbcc_history_stream_feed() as
+    it arrives, instead of being kept in the reply buffer.
+ */
+void pbcc_history_stream_receive(struct pbcc_context* p);
+
+/** Returns whether the response body on @p p is being fed to its
+    history stream as it arrives.
+ */
+bool pbcc_history_stream_receiving(struct pbcc_context const* p);
+
+/** Returns whether the history stream of @p p has at least
+    #PUBNUB_HISTORY_STREAM_MAX_PENDING bytes of messages not yet
+    taken, thus should not be fed any more until some are taken.
+ */
+bool pbcc_history_stream_full(struct pbcc_context const* p);
+
+/** Feeds the next @p len bytes at @p data of the history response
+    body to the history stream of @p p.
+    @retval PNR_OK fed
+    @retval PNR_FORMAT_ERROR not a valid history response
+    @retval PNR_OUT_OF_MEMORY can't grow the buffer for the messages
+ */
+enum pubnub_res pbcc_history_stream_feed(struct pbcc_context* p,
+                                         char const*          data,
+                                         size_t               len);
+
+/** Parses the response of a streamed history transaction on @p p,
+    feeding it to the stream first if it was not fed as it arrived
+    (i.e. was kept in the reply buffer).
+    @retval PNR_OK the whole response was parsed OK
+    @retval PNR_FORMAT_ERROR not a valid history response
+    @retval PNR_OUT_OF_MEMORY can't grow the buffer for the messages
+ */
+enum pubnub_res pbcc_parse_history_stream_response(struct pbcc_context* p);
+
+/** Takes the next message (that was received) from the history
+    stream of @p p, putting it in @p msg. The message is valid until
+    the stream is fed again.
+    @retval true a message was taken
+    @retval false there is no message (yet)
+ */
+bool pbcc_history_stream_get(struct pbcc_context* p, struct pubnub_history_message* msg);
+
+/** Frees the history stream of @p p, if it has one */
+void pbcc_history_stream_free(struct pbcc_context* p);
+
 #endif /* INC_PBCC_ADVANCED_HISTORY */
 #endif /* PUBNUB_USE_ADVANCED_HISTORY */
 
@@ -92,7 +92,7 @@ enum pubnub_res append_url_param_include(struct pbcc_context* pb,
             return PNR_OBJECTS_API_INVALID_PARAM;
         }
         param_val_len = pb_strnlen_s(include[i], MAX_INCLUDE_ELEM_LENGTH);
-        if ((pb->http_buf_len + 1 + param_val_len + 1) > sizeof pb->http_buf) {
+        if ((pb->http_buf_len + 1 + param_val_len + 1) > PBCC_HTTP_BUF_SIZE(pb)) {
             PUBNUB_LOG_ERROR("append_url_param_include(pbcc=%p) - Ran out of buffer while appending "
                              "include params : "
                              "include[%u]='%s', include_count=%lu\n",
@@ -108,7 +108,7 @@ enum pubnub_res append_url_param_include(struct pbcc_context* pb,
         }
         else {
             pb->http_buf_len += snprintf(pb->http_buf + pb->http_buf_len,
-                                         sizeof pb->http_buf - pb->http_buf_len,
+                                         PBCC_HTTP_BUF_SIZE(pb) - pb->http_buf_len,
                                          "​,%s",
                                          include[i]);
         }
@@ -135,7 +135,7 @@ enum pubnub_res pbcc_get_users_prep(struct pbcc_context* pb,
     pb->http_content_len = 0;
     pb->msg_ofs = pb->msg_end = 0;
     pb->http_buf_len = snprintf(pb->http_buf,
-                                sizeof pb->http_buf,
+                                PBCC_HTTP_BUF_SIZE(pb),
                                 "/v1/objects/%s/users",
                                 pb->subscribe_key);
     APPEND_URL_PARAM_M(pb, "pnsdk", uname, '?');
@@ -169,7 +169,7 @@ enum pubnub_res pbcc_create_user_prep(struct pbcc_context* pb,
     pb->http_content_len = 0;
     pb->msg_ofs = pb->msg_end = 0;
     pb->http_buf_len = snprintf(pb->http_buf,
-                                sizeof pb->http_buf,
+                                PBCC_HTTP_BUF_SIZE(pb),
                                 "/v1/objects/%s/users",
                                 pb->subscribe_key);
     APPEND_URL_PARAM_M(pb, "pnsdk", uname, '?');
@@ -203,7 +203,7 @@ enum pubnub_res pbcc_get_user_prep(struct pbcc_context* pb,
     pb->http_content_len = 0;
     pb->msg_ofs = pb->msg_end = 0;
     pb->http_buf_len = snprintf(pb->http_buf,
-                                sizeof pb->http_buf,
+                                PBCC_HTTP_BUF_SIZE(pb),
                                 "/v1/objects/%s/users/%s",
                                 pb->subscribe_key,
                                 user_id);
@@ -231,7 +231,7 @@ enum pubnub_res pbcc_update_user_prep(struct pbcc_context* pb,
     pb->http_content_len = 0;
     pb->msg_ofs = pb->msg_end = 0;
     pb->http_buf_len = snprintf(pb->http_buf,
-                                sizeof pb->http_buf,
+                                PBCC_HTTP_BUF_SIZE(pb),
                                 "/v1/objects/%s/users/%.*s",
                                 pb->subscribe_key,
                                 (int)(id->end - id->start - 2),
@@ -263,7 +263,7 @@ enum pubnub_res pbcc_delete_user_prep(struct pbcc_context* pb, char const* user_
     pb->http_content_len = 0;
     pb->msg_ofs = pb->msg_end = 0;
     pb->http_buf_len = snprintf(pb->http_buf,
-                                sizeof pb->http_buf,
+                                PBCC_HTTP_BUF_SIZE(pb),
                                 "/v1/objects/%s/users/%s",
                                 pb->subscribe_key,
                                 user_id);
@@ -292,7 +292,7 @@ enum pubnub_res pbcc_get_spaces_prep(struct pbcc_context* pb,
     pb->http_content_len = 0;
     pb->msg_ofs = pb->msg_end = 0;
     pb->http_buf_len = snprintf(pb->http_buf,
-                                sizeof pb->http_buf,
+                                PBCC_HTTP_BUF_SIZE(pb),
                                 "/v1/objects/%s/spaces",
                                 pb->subscribe_key);
     APPEND_URL_PARAM_M(pb, "pnsdk", uname, '?');
@@ -326,7 +326,7 @@ enum pubnub_res pbcc_create_space_prep(struct pbcc_context* pb,
     pb->http_content_len = 0;
     pb->msg_ofs = pb->msg_end = 0;
     pb->http_buf_len = snprintf(pb->http_buf,
-                                sizeof pb->http_buf,
+                                PBCC_HTTP_BUF_SIZE(pb),
                                 "/v1/objects/%s/spaces",
                                 pb->subscribe_key);
     APPEND_URL_PARAM_M(pb, "pnsdk", uname, '?');
@@ -360,7 +360,7 @@ enum pubnub_res pbcc_get_space_prep(struct pbcc_context* pb,
     pb->http_content_len = 0;
     pb->msg_ofs = pb->msg_end = 0;
     pb->http_buf_len = snprintf(pb->http_buf,
-                                sizeof pb->http_buf,
+                                PBCC_HTTP_BUF_SIZE(pb),
                                 "/v1/objects/%s/spaces/%s",
                                 pb->subscribe_key,
                                 space_id);
@@ -388,7 +388,7 @@ enum pubnub_res pbcc_update_space_prep(struct pbcc_context* pb,
     pb->http_content_len = 0;
     pb->msg_ofs = pb->msg_end = 0;
     pb->http_buf_len = snprintf(pb->http_buf,
-                                sizeof pb->http_buf,
+                                PBCC_HTTP_BUF_SIZE(pb),
                                 "/v1/objects/%s/spaces/%.*s",
                                 pb->subscribe_key,
                                 (int)(id->end - id->start - 2),
@@ -420,7 +420,7 @@ enum pubnub_res pbcc_delete_space_prep(struct pbcc_context* pb, char const* spac
     pb->http_content_len = 0;
     pb->msg_ofs = pb->msg_end = 0;
     pb->http_buf_len = snprintf(pb->http_buf,
-                                sizeof pb->http_buf,
+                                PBCC_HTTP_BUF_SIZE(pb),
                                 "/v1/objects/%s/spaces/%s",
                                 pb->subscribe_key,
                                 space_id);
@@ -450,7 +450,7 @@ enum pubnub_res pbcc_get_memberships_prep(struct pbcc_context* pb,
     pb->http_content_len = 0;
     pb->msg_ofs = pb->msg_end = 0;
     pb->http_buf_len = snprintf(pb->http_buf,
-                                sizeof pb->http_buf,
+                                PBCC_HTTP_BUF_SIZE(pb),
                                 "/v1/objects/%s/users/%s/spaces",
                                 pb->subscribe_key,
                                 user_id);
@@ -486,7 +486,7 @@ enum pubnub_res pbcc_update_memberships_prep(struct pbcc_context* pb,
     pb->http_content_len = 0;
     pb->msg_ofs = pb->msg_end = 0;
     pb->http_buf_len = snprintf(pb->http_buf,
-                                sizeof pb->http_buf,
+                                PBCC_HTTP_BUF_SIZE(pb),
                                 "/v1/objects/%s/users/%s/spaces",
                                 pb->subscribe_key,
                                 user_id);
@@ -519,7 +519,7 @@ enum pubnub_res pbcc_get_members_prep(struct pbcc_context* pb,
     pb->http_content_len = 0;
     pb->msg_ofs = pb->msg_end = 0;
     pb->http_buf_len = snprintf(pb->http_buf,
-                                sizeof pb->http_buf,
+                                PBCC_HTTP_BUF_SIZE(pb),
                                 "/v1/objects/%s/spaces/%s/users",
                                 pb->subscribe_key,
                                 space_id);
@@ -555,7 +555,7 @@ enum pubnub_res pbcc_update_members_prep(struct pbcc_context* pb,
     pb->http_content_len = 0;
     pb->msg_ofs = pb->msg_end = 0;
     pb->http_buf_len = snprintf(pb->http_buf,
-                                sizeof pb->http_buf,
+                                PBCC_HTTP_BUF_SIZE(pb),
                                 "/v1/objects/%s/spaces/%s/users",
                                 pb->subscribe_key,
                                 space_id);
@@ -585,6 +585,7 @@ enum pubnub_res pbcc_parse_objects_api_response(struct pbcc_context* pb)
     pb->chan_ofs = pb->chan_end = 0;
     pb->msg_ofs = 0;
     pb->msg_end = replylen + 1;
+    pb->data_ofs = pb->data_end = 0;
 
     elem.end = pbjson_find_end_element(reply, reply + replylen);
     /* elem.end has to be just behind end curly brace */
@@ -627,6 +628,73 @@ enum pubnub_res pbcc_parse_objects_api_response(struct pbcc_context* pb)
                      pb,
                      (int)(parsed.end - parsed.start),
                      parsed.start);
+    if ('[' == *parsed.start) {
+        pb->data_ofs = parsed.start + 1 - reply;
+        pb->data_end = parsed.end - 1 - reply;
+    }
+    else {
+        pb->data_ofs = parsed.start - reply;
+        pb->data_end = parsed.end - reply;
+    }
 
     return PNR_OK;
 }
+
+
+pubnub_chamebl_t pbcc_get_objects_data_element(struct pbcc_context* pb)
+{
+    pubnub_chamebl_t rslt;
+    char const*      end   = pb->http_reply + pb->data_end;
+    char const*      start = pbjson_skip_whitespace(pb->http_reply + pb->data_ofs, end);
+    char const*      elem_end;
+
+    if (start >= end) {
+        pb->data_ofs = pb->data_end;
+        rslt.ptr  = NULL;
+        rslt.size = 0;
+        return rslt;
+    }
+    elem_end = pbjson_find_end_element(start, end);
+    if (elem_end >= end) {
+        PUBNUB_LOG_ERROR("pbcc_get_objects_data_element(pbcc=%p) - Invalid: "
+                         "unterminated element='%.*s'\n",
+                         pb,
+                         (int)(end - start),
+                         start);
+        pb->data_ofs = pb->data_end;
+        rslt.ptr  = NULL;
+        rslt.size = 0;
+        return rslt;
+    }
+    rslt.ptr  = (char*)start;
+    rslt.size = elem_end + 1 - start;
+
+    start = pbjson_skip_whitespace(elem_end + 1, end);
+    if ((start < end) && (',' == *start)) {
+        ++start;
+    }
+    pb->data_ofs = start - pb->http_reply;
+
+    return rslt;
+}
+
+
+int pbcc_get_objects_cursor(struct pbcc_context* pb,
+                            char const* name,
+                            pubnub_chamebl_t* o_cursor)
+{
+    struct pbjson_elem elem;
+    struct pbjson_elem parsed;
+
+    elem.start = pb->http_reply;
+    elem.end   = pb->http_reply + pb->http_buf_len;
+    if ((pb->http_buf_len < 2) || (*elem.start != '{')
+        || (pbjson_get_object_value(&elem, name, &parsed) != jonmpOK)
+        || (*parsed.start != '"') || (parsed.end - parsed.start < 2)) {
+        return -1;
+    }
+    o_cursor->ptr  = (char*)parsed.start + 1;
+    o_cursor->size = parsed.end - parsed.start - 2;
+
+    return 0;
+}
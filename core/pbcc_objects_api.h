@@ -4,6 +4,7 @@
 
 #include "pubnub_api_types.h"
 #include "pubnub_json_parse.h"
+#include "pubnub_memory_block.h"
 
 struct pbcc_context;
 
@@ -170,5 +171,23 @@ enum pubnub_res pbcc_update_members_prep(struct pbcc_context* pb,
   */
 enum pubnub_res pbcc_parse_objects_api_response(struct pbcc_context* pb);
 
+/** Returns the next element of the "data" array of the last
+    (successfully parsed) Objects API response, pointing into the
+    response, without copying anything. If "data" is not an array,
+    it is returned as the only element. If there are no more
+    elements, `ptr` of the returned memory block is NULL.
+  */
+pubnub_chamebl_t pbcc_get_objects_data_element(struct pbcc_context* pb);
+
+/** Gets the pagination cursor @p name ("next" or "prev") from the
+    last Objects API response, without the quotes, pointing into the
+    response.
+    @retval 0 cursor found, it's in @p o_cursor
+    @retval -1 no such cursor in the response
+  */
+int pbcc_get_objects_cursor(struct pbcc_context* pb,
+                            char const* name,
+                            pubnub_chamebl_t* o_cursor);
+
 
 #endif /* !defined INC_PBCC_OBJECTS_API */
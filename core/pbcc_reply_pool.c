@@ -0,0 +1,127 @@
+/* -*- c-file-style:"stroustrup"; indent-tabs-mode: nil -*- */
+#include "pubnub_internal.h"
+
+#include "pbcc_reply_pool.h"
+#include "pbmem.h"
+#include "pubnub_mutex.h"
+#include "pubnub_assert.h"
+#include "pubnub_log.h"
+
+#include <string.h>
+
+
+/** Size of the smallest size class. Most replies (of publish, time,
+    presence...) fit in it. Has to be able to hold a pointer, which
+    links the idle buffers.
+ */
+#define SMALLEST_CLASS_SIZE 64
+
+/** Number of size classes: 64 B to 1 MB */
+#define CLASS_COUNT 15
+
+
+/** Lists of idle buffers, per size class. The first bytes of an idle
+    buffer point to the next idle buffer in the list. */
+static char* m_idle[CLASS_COUNT];
+
+/** Total size of all idle buffers */
+static size_t m_idle_size;
+
+/** Guards the idle lists */
+pubnub_mutex_static_decl_and_init(m_lock);
+
+
+static size_t class_size(int cls)
+{
+    return (size_t)SMALLEST_CLASS_SIZE << cls;
+}
+
+
+/** Returns the smallest size class that can hold @p size bytes,
+    CLASS_COUNT if none can.
+ */
+static int class_for_size(size_t size)
+{
+    int cls;
+
+    for (cls = 0; cls < CLASS_COUNT; ++cls) {
+        if (size <= class_size(cls)) {
+            break;
+        }
+    }
+    return cls;
+}
+
+
+/** Returns the size class of a buffer of @p capacity, CLASS_COUNT if
+    it is not of any class.
+ */
+static int class_of_capacity(size_t capacity)
+{
+    int cls = class_for_size(capacity);
+
+    return ((cls < CLASS_COUNT) && (class_size(cls) == capacity)) ? cls
+                                                                  : CLASS_COUNT;
+}
+
+
+char* pbcc_reply_pool_get(struct pbmem_account*       account,
+                          enum pubnub_memory_category category,
+                          size_t                      size,
+                          size_t*                     capacity)
+{
+    int   cls = class_for_size(size);
+    char* buf = NULL;
+
+    PUBNUB_ASSERT_OPT(capacity != NULL);
+
+    if (cls < CLASS_COUNT) {
+        pubnub_mutex_init_static(m_lock);
+        pubnub_mutex_lock(m_lock);
+        buf = m_idle[cls];
+        if (buf != NULL) {
+            memcpy(&m_idle[cls], buf, sizeof m_idle[cls]);
+            m_idle_size -= class_size(cls);
+        }
+        pubnub_mutex_unlock(m_lock);
+        size = class_size(cls);
+    }
+    if (buf != NULL) {
+        pbmem_reassign(buf, account, category);
+    }
+    else {
+        buf = (char*)pbmem_alloc(account, category, size);
+        if (NULL == buf) {
+            PUBNUB_LOG_ERROR("Failed to allocate reply buffer of %lu bytes\n",
+                             (unsigned long)size);
+            return NULL;
+        }
+    }
+    *capacity = size;
+
+    return buf;
+}
+
+
+void pbcc_reply_pool_put(char* buf, size_t capacity)
+{
+    int cls = class_of_capacity(capacity);
+
+    if (NULL == buf) {
+        return;
+    }
+    if (cls < CLASS_COUNT) {
+        pbmem_reassign(buf, NULL, pbmemcatReply);
+        pubnub_mutex_init_static(m_lock);
+        pubnub_mutex_lock(m_lock);
+        if (m_idle_size + capacity <= PUBNUB_REPLY_POOL_MAX_IDLE) {
+            memcpy(buf, &m_idle[cls], sizeof m_idle[cls]);
+            m_idle[cls] = buf;
+            m_idle_size += capacity;
+            buf = NULL;
+        }
+        pubnub_mutex_unlock(m_lock);
+    }
+    pbmem_free(buf);
+}
+
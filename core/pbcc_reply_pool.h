@@ -0,0 +1,60 @@
+/* -*- c-file-style:"stroustrup"; indent-tabs-mode: nil -*- */
+#if !defined INC_PBCC_REPLY_POOL
+#define      INC_PBCC_REPLY_POOL
+
+#include "pbmem.h"
+
+#include <stddef.h>
+
+
+#if !defined PUBNUB_REPLY_POOL_MAX_IDLE
+/** The most memory (in bytes) that the reply buffer pool keeps in
+    buffers that no context is using, for the next transaction(s) to
+    borrow. Buffers that are returned while the pool already keeps
+    this much are freed. Set to 0 to not keep any.
+ */
+#define PUBNUB_REPLY_POOL_MAX_IDLE (256 * 1024)
+#endif
+
+
+/** @file pbcc_reply_pool.h
+    Process-wide, thread-safe pool of reply (and decompression)
+    buffers, used if #PUBNUB_DYNAMIC_REPLY_BUFFER is true. Contexts
+    borrow a buffer when a transaction starts receiving the response
+    and return it when the outcome is not needed any more, so the
+    memory used follows the number of transactions receiving at the
+    same time, rather than the number of contexts.
+
+    Buffers come in size classes (powers of two), so that a buffer
+    returned by one context fits the next reply of another. Replies
+    larger than the largest class get buffers of their exact size,
+    which are not kept in the pool.
+
+    While borrowed, a buffer is accounted for in the memory account
+    of the borrower (see pbmem.h), while idle, it is accounted for
+    (process-wide only) as #pbmemcatReply.
+ */
+
+
+/** Borrows a buffer of at least @p size bytes from the pool. Its
+    actual size is put to @p capacity.
+
+    @param account The memory account of the borrower (can be NULL)
+    @param category The category to account the buffer in
+    @param size Minimal size of the buffer
+    @param capacity The actual size of the buffer
+    @return The buffer, NULL on failure
+ */
+char* pbcc_reply_pool_get(struct pbmem_account*       account,
+                          enum pubnub_memory_category category,
+                          size_t                      size,
+                          size_t*                     capacity);
+
+/** Returns the @p buf, of size @p capacity, borrowed with
+    pbcc_reply_pool_get(), to the pool. If @p buf is NULL, does
+    nothing.
+ */
+void pbcc_reply_pool_put(char* buf, size_t capacity);
+
+
+#endif /* !defined INC_PBCC_REPLY_POOL */
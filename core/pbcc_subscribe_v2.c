@@ -3,7 +3,9 @@
 
 #include "pubnub_version.h"
 #include "pubnub_assert.h"
+#include "pbmem.h"
 #include "pubnub_json_parse.h"
+#include "pubnub_helper.h"
 #include "pubnub_log.h"
 #include "pubnub_url_encode.h"
 #include "lib/pb_strnlen_s.h"
@@ -20,6 +22,12 @@
 */
 #define MIN_SUBSCRIBE_V2_RESPONSE_LENGTH 40
 
+/** The number of entries the message index starts with. It doubles
+    as needed. It is freed (with the reply) when the next transaction
+    starts, so it starts anew for every response.
+*/
+#define PBCC_MSG_V2_INDEX_INITIAL_CAPACITY 16
+
 enum pubnub_res pbcc_subscribe_v2_prep(struct pbcc_context* p,
                                        char const*          channel,
                                        char const*          channel_group,
@@ -40,9 +48,10 @@ enum pubnub_res pbcc_subscribe_v2_prep(struct pbcc_context* p,
     }
 
     if ('\0' == p->timetoken[0]) {
-        p->timetoken[0] = '0';
-        p->timetoken[1] = '\0';
-        tr              = NULL;
+        p->timetoken[0]  = '0';
+        p->timetoken[1]  = '\0';
+        p->timetoken_u64 = 0;
+        tr               = NULL;
     }
     else {
         snprintf(region_str, sizeof region_str, "%d", p->region);
@@ -50,12 +59,13 @@ enum pubnub_res pbcc_subscribe_v2_prep(struct pbcc_context* p,
     }
     p->http_content_len = 0;
     p->msg_ofs = p->msg_end = 0;
+    p->msg_v2_count = p->msg_v2_next = 0;
 
     p->http_buf_len = snprintf(
-        p->http_buf, sizeof p->http_buf, "/v2/subscribe/%s/", p->subscribe_key);
+        p->http_buf, PBCC_HTTP_BUF_SIZE(p), "/v2/subscribe/%s/", p->subscribe_key);
     APPEND_URL_ENCODED_M(p, channel);
     p->http_buf_len += snprintf(p->http_buf + p->http_buf_len,
-                                sizeof p->http_buf - p->http_buf_len,
+                                PBCC_HTTP_BUF_SIZE(p) - p->http_buf_len,
                                 "/0?tt=%s&pnsdk=%s",
                                 p->timetoken,
                                 pubnub_uname());
@@ -70,193 +80,506 @@ enum pubnub_res pbcc_subscribe_v2_prep(struct pbcc_context* p,
 }
 
 
-enum pubnub_res pbcc_parse_subscribe_v2_response(struct pbcc_context* p)
+/** The values of a subscribe V2 message (JSON object) that we are
+    interested in, gathered in one pass over the message.
+ */
+struct msg_v2_fields {
+    struct pbjson_elem payload;
+    struct pbjson_elem channel;
+    struct pbjson_elem type;
+    struct pbjson_elem publish;
+    struct pbjson_elem match_or_group;
+    struct pbjson_elem metadata;
+    struct pbjson_elem flags;
+};
+
+
+/** Goes over the key/value pairs of the message starting at @p start
+    (and ending at most at @p end) once, putting the values we are
+    interested in to @p fields. Those not found are left NULL.
+
+    @return Pointer to the closing curly brace of the message, NULL on
+    parse error
+ */
+static char const* gather_msg_v2_fields(struct pbcc_context*  p,
+                                        char const*           start,
+                                        char const*           end,
+                                        struct msg_v2_fields* fields)
 {
     enum pbjson_object_name_parse_result jpresult;
+    struct pbjson_object_iterator        it;
     struct pbjson_elem                   el;
-    struct pbjson_elem                   found;
-    char*                                reply = p->http_reply;
+    struct pbjson_elem                   key;
+    struct pbjson_elem                   value;
 
-    if (p->http_buf_len < MIN_SUBSCRIBE_V2_RESPONSE_LENGTH) {
-        return PNR_FORMAT_ERROR;
+    memset(fields, 0, sizeof *fields);
+    el.start = start;
+    el.end   = end;
+    pbjson_object_iterator_init(&it, &el);
+    while (jonmpOK == (jpresult = pbjson_object_next_pair(&it, &key, &value))) {
+        if (key.end - key.start != 1) {
+            continue;
+        }
+        switch (*key.start) {
+        case 'd':
+            fields->payload = value;
+            break;
+        case 'c':
+            fields->channel = value;
+            break;
+        case 'e':
+            fields->type = value;
+            break;
+        case 'p':
+            fields->publish = value;
+            break;
+        case 'b':
+            fields->match_or_group = value;
+            break;
+        case 'u':
+            fields->metadata = value;
+            break;
+        case 'f':
+            fields->flags = value;
+            break;
+        default:
+            break;
+        }
     }
-    if ((reply[0] != '{') || (reply[p->http_buf_len - 1] != '}')) {
-        return PNR_FORMAT_ERROR;
+    if (jpresult != jonmpKeyNotFound) {
+        PUBNUB_LOG_ERROR("pbcc=%p: Message in subscribe V2 response is not a "
+                         "valid JSON object, error=%d\n",
+                         p,
+                         jpresult);
+        return NULL;
     }
 
-    el.start = p->http_reply;
-    el.end   = p->http_reply + p->http_buf_len;
-    jpresult = pbjson_get_object_value(&el, "t", &found);
-    if (jonmpOK == jpresult) {
-        struct pbjson_elem titel;
-        if (jonmpOK == pbjson_get_object_value(&found, "t", &titel)) {
-            size_t len = titel.end - titel.start - 2;
-            if ((*titel.start != '"') || (titel.end[-1] != '"')) {
+    return it.s;
+}
+
+
+/** Gets the time token and region from the "publish" object @p
+    publish of a subscribe V2 message, to @p rslt.
+ */
+static bool get_msg_v2_publish_info(struct pbjson_elem const* publish,
+                                    struct pubnub_v2_message* rslt)
+{
+    struct pbjson_object_iterator it;
+    struct pbjson_elem            key;
+    struct pbjson_elem            value;
+    bool                          have_tt = false;
+
+    if (pbjson_object_iterator_init(&it, publish) != jonmpOK) {
+        return false;
+    }
+    while (jonmpOK == pbjson_object_next_pair(&it, &key, &value)) {
+        if (pbjson_elem_equals_string(&key, "t")) {
+            if ((*value.start != '"') || (value.end[-1] != '"')) {
                 PUBNUB_LOG_ERROR("Time token in response is not a string\n");
-                return PNR_FORMAT_ERROR;
-            }
-            if (len >= sizeof p->timetoken) {
-                PUBNUB_LOG_ERROR(
-                    "Time token in response, length %lu, longer than max %lu\n",
-                    (unsigned long)len,
-                    (unsigned long)(sizeof p->timetoken - 1));
-                return PNR_FORMAT_ERROR;
+                return false;
             }
-
-            memcpy(p->timetoken, titel.start + 1, len);
-            p->timetoken[len] = '\0';
+            rslt->tt.ptr  = (char*)value.start + 1;
+            rslt->tt.size = value.end - value.start - 2;
+            have_tt       = true;
         }
-        else {
-            PUBNUB_LOG_ERROR(
-                "No timetoken value in subscribe V2 response found\n");
-            return PNR_FORMAT_ERROR;
-        }
-        if (jonmpOK == pbjson_get_object_value(&found, "r", &titel)) {
-            p->region = strtol(titel.start, NULL, 0);
-        }
-        else {
-            PUBNUB_LOG_ERROR(
-                "No region value in subscribe V2 response found\n");
-            return PNR_FORMAT_ERROR;
+        else if (pbjson_elem_equals_string(&key, "r")) {
+            rslt->region = strtol(value.start, NULL, 0);
         }
     }
-    else {
+    if (!have_tt) {
+        PUBNUB_LOG_ERROR("No timetoken value in subscribe V2 response found\n");
+    }
+
+    return have_tt;
+}
+
+
+/** Decodes the message starting at @p start (and ending at most at
+    @p end) to @p rslt. If it lacks some of the mandatory fields, the
+    ones after it (in the order of checking) are left empty.
+
+    @return Pointer to the closing curly brace of the message, NULL if
+    it is not a valid JSON object
+ */
+static char const* decode_msg_v2(struct pbcc_context*      p,
+                                 char const*               start,
+                                 char const*               end,
+                                 struct pubnub_v2_message* rslt)
+{
+    struct msg_v2_fields fields;
+    char const*          seeker;
+
+    memset(rslt, 0, sizeof *rslt);
+    if (*start != '{') {
         PUBNUB_LOG_ERROR(
-            "No timetoken in subscribe V2 response found, error=%d\n", jpresult);
-        return PNR_FORMAT_ERROR;
+            "Message subscribe V2 response is not a JSON object\n");
+        return NULL;
+    }
+    seeker = gather_msg_v2_fields(p, start, end, &fields);
+    if (NULL == seeker) {
+        return NULL;
     }
 
-    p->chan_ofs = p->chan_end = 0;
+    if (NULL == fields.payload.start) {
+        PUBNUB_LOG_ERROR("pbcc=%p: No message payload in subscribe V2 response "
+                         "found\n",
+                         p);
+        return seeker;
+    }
+    rslt->payload.ptr  = (char*)fields.payload.start;
+    rslt->payload.size = fields.payload.end - fields.payload.start;
+
+    if (NULL == fields.channel.start) {
+        PUBNUB_LOG_ERROR("pbcc=%p: No message channel in subscribe V2 response "
+                         "found\n",
+                         p);
+        return seeker;
+    }
+    rslt->channel.ptr  = (char*)fields.channel.start + 1;
+    rslt->channel.size = fields.channel.end - fields.channel.start - 2;
 
-    /* We should optimize this to not look from the start again.
-     */
-    jpresult = pbjson_get_object_value(&el, "m", &found);
-    if (jonmpOK == jpresult) {
-        p->msg_ofs = (unsigned)(found.start - reply + 1);
-        p->msg_end = (unsigned)(found.end - reply - 1);
+    if (NULL == fields.type.start) {
+        rslt->message_type = pbsbPublished;
+    }
+    else if (pbjson_elem_equals_string(&fields.type, "1")) {
+        rslt->message_type = pbsbSignal;
+    }
+    else if (pbjson_elem_equals_string(&fields.type, "3")) {
+        rslt->message_type = pbsbAction;
     }
     else {
-        PUBNUB_LOG_ERROR(
-            "No message array subscribe V2 response found, error=%d\n", jpresult);
-        return PNR_FORMAT_ERROR;
+        rslt->message_type = pbsbPublished;
+    }
+
+    if (NULL == fields.publish.start) {
+        PUBNUB_LOG_ERROR("No message publish timetoken in subscribe V2 "
+                         "response found\n");
+        return seeker;
+    }
+    if (!get_msg_v2_publish_info(&fields.publish, rslt)) {
+        return seeker;
+    }
+
+    if (fields.flags.start != NULL) {
+        rslt->flags = strtol(fields.flags.start, NULL, 0);
+    }
+    if (fields.match_or_group.start != NULL) {
+        rslt->match_or_group.ptr  = (char*)fields.match_or_group.start;
+        rslt->match_or_group.size = fields.match_or_group.end - fields.match_or_group.start;
+    }
+    if (fields.metadata.start != NULL) {
+        rslt->metadata.ptr  = (char*)fields.metadata.start;
+        rslt->metadata.size = fields.metadata.end - fields.metadata.start;
+    }
+
+    return seeker;
+}
+
+
+static struct pbcc_msg_v2_span to_span(struct pbcc_context const*          p,
+                                       struct pubnub_char_mem_block const* block)
+{
+    struct pbcc_msg_v2_span rslt = { 0, 0 };
+    if (block->ptr != NULL) {
+        rslt.ofs = (unsigned)(block->ptr - p->http_reply);
+        rslt.len = (unsigned)block->size;
+    }
+    return rslt;
+}
+
+
+static struct pubnub_char_mem_block from_span(struct pbcc_context const*     p,
+                                              struct pbcc_msg_v2_span const* span)
+{
+    struct pubnub_char_mem_block rslt = { NULL, 0 };
+    if (span->ofs != 0) {
+        rslt.ptr  = (char*)p->http_reply + span->ofs;
+        rslt.size = span->len;
+    }
+    return rslt;
+}
+
+
+/** Appends an entry to the message index of @p p, growing it if
+    needed. Returns NULL if it can't grow.
+ */
+static struct pbcc_msg_v2_entry* add_msg_v2_entry(struct pbcc_context* p)
+{
+    if (p->msg_v2_count == p->msg_v2_capacity) {
+        unsigned capacity = (0 == p->msg_v2_capacity) ? PBCC_MSG_V2_INDEX_INITIAL_CAPACITY
+                                                      : 2 * p->msg_v2_capacity;
+        struct pbcc_msg_v2_entry* index = (struct pbcc_msg_v2_entry*)pbmem_realloc(
+            PBCC_MEMORY(p), pbmemcatReply, p->msg_v2_index, capacity * sizeof *index);
+        if (NULL == index) {
+            return NULL;
+        }
+        p->msg_v2_index    = index;
+        p->msg_v2_capacity = capacity;
+    }
+    return &p->msg_v2_index[p->msg_v2_count++];
+}
+
+
+/** Builds the index of the messages in the array @p messages (the
+    value of the "m" field of the response), going over it once.
+ */
+static enum pubnub_res build_msg_v2_index(struct pbcc_context*      p,
+                                          struct pbjson_elem const* messages)
+{
+    char const* end = messages->end - 1;
+    char const* s   = pbjson_skip_whitespace(messages->start + 1, end);
+
+    p->msg_v2_count = p->msg_v2_next = 0;
+    while (s < end) {
+        struct pubnub_v2_message  msg;
+        struct pbcc_msg_v2_entry* entry;
+        char const*               seeker = decode_msg_v2(p, s, end, &msg);
+
+        if (NULL == seeker) {
+            /* Messages after an invalid one can't be found */
+            break;
+        }
+        entry = add_msg_v2_entry(p);
+        if (NULL == entry) {
+            PUBNUB_LOG_ERROR("pbcc=%p: Failed to allocate the subscribe V2 "
+                             "message index\n",
+                             p);
+            return PNR_OUT_OF_MEMORY;
+        }
+        entry->ofs            = (unsigned)(s - p->http_reply);
+        entry->next_ofs       = (unsigned)(seeker - p->http_reply + 2);
+        entry->tt             = to_span(p, &msg.tt);
+        entry->tt_u64         = pubnub_timetoken_to_u64(msg.tt.ptr, msg.tt.size);
+        entry->channel        = to_span(p, &msg.channel);
+        entry->match_or_group = to_span(p, &msg.match_or_group);
+        entry->payload        = to_span(p, &msg.payload);
+        entry->metadata       = to_span(p, &msg.metadata);
+        entry->region         = msg.region;
+        entry->flags          = msg.flags;
+        entry->message_type   = msg.message_type;
+
+        s = pbjson_skip_whitespace(seeker + 1, end);
+        if ((s < end) && (',' == *s)) {
+            s = pbjson_skip_whitespace(s + 1, end);
+        }
     }
 
     return PNR_OK;
 }
 
 
-struct pubnub_v2_message pbcc_get_msg_v2(struct pbcc_context* p)
+enum pubnub_res pbcc_parse_subscribe_v2_response(struct pbcc_context* p)
 {
     enum pbjson_object_name_parse_result jpresult;
+    struct pbjson_object_iterator        it;
     struct pbjson_elem                   el;
-    struct pbjson_elem                   found;
-    struct pubnub_v2_message             rslt;
-    char const*                          start;
-    char const*                          end;
-    char const*                          seeker;
+    struct pbjson_elem                   key;
+    struct pbjson_elem                   value;
+    struct pbjson_elem                   tt_elem   = { NULL, NULL };
+    struct pbjson_elem                   msgs_elem = { NULL, NULL };
+    struct pbjson_elem                   titel;
+    char*                                reply = p->http_reply;
+    enum pubnub_res                      rslt;
+    size_t                               len;
 
-    memset(&rslt, 0, sizeof rslt);
+    if (p->http_buf_len < MIN_SUBSCRIBE_V2_RESPONSE_LENGTH) {
+        return PNR_FORMAT_ERROR;
+    }
+    if ((reply[0] != '{') || (reply[p->http_buf_len - 1] != '}')) {
+        return PNR_FORMAT_ERROR;
+    }
 
-    if (p->msg_ofs >= p->msg_end) {
-        return rslt;
+    /* One pass over the response to find both the time token and
+       the messages */
+    el.start = p->http_reply;
+    el.end   = p->http_reply + p->http_buf_len;
+    pbjson_object_iterator_init(&it, &el);
+    while (jonmpOK == (jpresult = pbjson_object_next_pair(&it, &key, &value))) {
+        if (pbjson_elem_equals_string(&key, "t")) {
+            tt_elem = value;
+        }
+        else if (pbjson_elem_equals_string(&key, "m")) {
+            msgs_elem = value;
+        }
     }
-    start = p->http_reply + p->msg_ofs;
-    if (*start != '{') {
+    if (NULL == tt_elem.start) {
         PUBNUB_LOG_ERROR(
-            "Message subscribe V2 response is not a JSON object\n");
-        return rslt;
+            "No timetoken in subscribe V2 response found, error=%d\n", jpresult);
+        return PNR_FORMAT_ERROR;
     }
-    end    = p->http_reply + p->msg_end;
-    seeker = pbjson_find_end_complex(start, end);
-    if (seeker == end) {
+    if ((NULL == msgs_elem.start) || (*msgs_elem.start != '[')) {
         PUBNUB_LOG_ERROR(
-            "Message subscribe V2 response has no end of JSON object\n");
-        return rslt;
+            "No message array subscribe V2 response found, error=%d\n", jpresult);
+        return PNR_FORMAT_ERROR;
     }
 
-    p->msg_ofs = (unsigned)(seeker - p->http_reply + 2);
-    el.start   = start;
-    el.end     = seeker;
-
-    /* @todo We should iterate over elements of JSON message object,
-       instead of looking from the start, again and again.
-    */
-
-    jpresult = pbjson_get_object_value(&el, "d", &found);
-    if (jonmpOK == jpresult) {
-        rslt.payload.ptr  = (char*)found.start;
-        rslt.payload.size = found.end - found.start;
+    if (jonmpOK != pbjson_get_object_value(&tt_elem, "t", &titel)) {
+        PUBNUB_LOG_ERROR("No timetoken value in subscribe V2 response found\n");
+        return PNR_FORMAT_ERROR;
     }
-    else {
-        PUBNUB_LOG_ERROR("pbcc=%p: No message payload in subscribe V2 response "
-                         "found, error=%d\n",
-                         p,
-                         jpresult);
+    len = titel.end - titel.start - 2;
+    if ((*titel.start != '"') || (titel.end[-1] != '"')) {
+        PUBNUB_LOG_ERROR("Time token in response is not a string\n");
+        return PNR_FORMAT_ERROR;
+    }
+    if (len >= sizeof p->timetoken) {
+        PUBNUB_LOG_ERROR(
+            "Time token in response, length %lu, longer than max %lu\n",
+            (unsigned long)len,
+            (unsigned long)(sizeof p->timetoken - 1));
+        return PNR_FORMAT_ERROR;
+    }
+
+    /* Build the index before taking the time token, so that, if it
+       fails, the messages can be got again */
+    rslt = build_msg_v2_index(p, &msgs_elem);
+    if (rslt != PNR_OK) {
         return rslt;
     }
 
-    jpresult = pbjson_get_object_value(&el, "c", &found);
-    if (jonmpOK == jpresult) {
-        rslt.channel.ptr  = (char*)found.start + 1;
-        rslt.channel.size = found.end - found.start - 2;
+    memcpy(p->timetoken, titel.start + 1, len);
+    p->timetoken[len] = '\0';
+    p->timetoken_u64  = pubnub_timetoken_to_u64(p->timetoken, len);
+    if (jonmpOK == pbjson_get_object_value(&tt_elem, "r", &titel)) {
+        p->region = strtol(titel.start, NULL, 0);
     }
     else {
-        PUBNUB_LOG_ERROR("pbcc=%p: No message channel in subscribe V2 response "
-                         "found, error=%d\n",
-                         p,
-                         jpresult);
-        return rslt;
+        PUBNUB_LOG_ERROR("No region value in subscribe V2 response found\n");
+        return PNR_FORMAT_ERROR;
     }
 
-    jpresult = pbjson_get_object_value(&el, "e", &found);
-    if (jonmpOK == jpresult) {
-        if (pbjson_elem_equals_string(&found, "1")) {
-            rslt.message_type = pbsbSignal;
-        }
-        else if (pbjson_elem_equals_string(&found, "3")) {
-            rslt.message_type = pbsbAction;
+    p->chan_ofs = p->chan_end = 0;
+    p->msg_ofs  = (unsigned)(msgs_elem.start - reply + 1);
+    p->msg_end  = (unsigned)(msgs_elem.end - reply - 1);
+
+    return PNR_OK;
+}
+
+
+static struct pubnub_v2_message msg_v2_from_entry(struct pbcc_context const*      p,
+                                                  struct pbcc_msg_v2_entry const* entry)
+{
+    struct pubnub_v2_message rslt;
+
+    rslt.tt             = from_span(p, &entry->tt);
+    rslt.tt_u64         = entry->tt_u64;
+    rslt.region         = entry->region;
+    rslt.flags          = entry->flags;
+    rslt.channel        = from_span(p, &entry->channel);
+    rslt.match_or_group = from_span(p, &entry->match_or_group);
+    rslt.payload        = from_span(p, &entry->payload);
+    rslt.metadata       = from_span(p, &entry->metadata);
+    rslt.message_type   = entry->message_type;
+
+    return rslt;
+}
+
+
+/** Finds the index entry of the message at offset @p ofs. This is
+    needed only if the user mixes pubnub_get() and pubnub_get_v2().
+ */
+static struct pbcc_msg_v2_entry const* find_msg_v2_entry(struct pbcc_context* p,
+                                                         unsigned             ofs)
+{
+    unsigned lo = 0;
+    unsigned hi = p->msg_v2_count;
+
+    while (lo < hi) {
+        unsigned mid = lo + (hi - lo) / 2;
+        if (p->msg_v2_index[mid].ofs < ofs) {
+            lo = mid + 1;
         }
         else {
-            rslt.message_type = pbsbPublished;
+            hi = mid;
         }
     }
+    if ((lo < p->msg_v2_count) && (p->msg_v2_index[lo].ofs == ofs)) {
+        p->msg_v2_next = lo;
+        return &p->msg_v2_index[lo];
+    }
+    return NULL;
+}
+
+
+struct pubnub_v2_message pbcc_get_msg_v2(struct pbcc_context* p)
+{
+    struct pbcc_msg_v2_entry const* entry;
+    struct pubnub_v2_message        rslt;
+
+    memset(&rslt, 0, sizeof rslt);
+    if (p->msg_ofs >= p->msg_end) {
+        return rslt;
+    }
+    if ((p->msg_v2_next < p->msg_v2_count)
+        && (p->msg_v2_index[p->msg_v2_next].ofs == p->msg_ofs)) {
+        entry = &p->msg_v2_index[p->msg_v2_next];
+    }
     else {
-        rslt.message_type = pbsbPublished;
-    }
-    
-    jpresult = pbjson_get_object_value(&el, "p", &found);
-    if (jonmpOK == jpresult) {
-        struct pbjson_elem titel;
-        if (jonmpOK == pbjson_get_object_value(&found, "t", &titel)) {
-            if ((*titel.start != '"') || (titel.end[-1] != '"')) {
-                PUBNUB_LOG_ERROR("Time token in response is not a string\n");
-                return rslt;
-            }
-            rslt.tt.ptr  = (char*)titel.start + 1;
-            rslt.tt.size = titel.end - titel.start - 2;
-        }
-        else {
-            PUBNUB_LOG_ERROR(
-                "No timetoken value in subscribe V2 response found\n");
+        entry = find_msg_v2_entry(p, p->msg_ofs);
+        if (NULL == entry) {
+            PUBNUB_LOG_ERROR("pbcc=%p: No valid subscribe V2 message at "
+                             "offset %u\n",
+                             p,
+                             p->msg_ofs);
             return rslt;
         }
     }
-    else {
-        PUBNUB_LOG_ERROR("No message publish timetoken in subscribe V2 "
-                         "response found, error=%d\n",
-                         jpresult);
-        return rslt;
-    }
+    ++p->msg_v2_next;
+    p->msg_ofs = entry->next_ofs;
+
+    return msg_v2_from_entry(p, entry);
+}
+
+
+size_t pbcc_get_msg_v2_batch(struct pbcc_context*      p,
+                             struct pubnub_v2_message* out,
+                             size_t                    max)
+{
+    size_t n = 0;
 
-    if (jonmpOK == pbjson_get_object_value(&el, "b", &found)) {
-        rslt.match_or_group.ptr  = (char*)found.start;
-        rslt.match_or_group.size = found.end - found.start;
+    while ((n < max) && (p->msg_ofs < p->msg_end)) {
+        unsigned                 ofs = p->msg_ofs;
+        struct pubnub_v2_message msg = pbcc_get_msg_v2(p);
+        if (NULL == msg.payload.ptr) {
+            if (ofs == p->msg_ofs) {
+                /* No message found here, so none after it either */
+                break;
+            }
+            /* Not valid, but the ones after it may be */
+            continue;
+        }
+        out[n++] = msg;
     }
 
-    if (jonmpOK == pbjson_get_object_value(&el, "u", &found)) {
-        rslt.metadata.ptr  = (char*)found.start;
-        rslt.metadata.size = found.end - found.start;
+    return n;
+}
+
+
+unsigned pbcc_msg_v2_count(struct pbcc_context const* p)
+{
+    return p->msg_v2_count;
+}
+
+
+struct pubnub_v2_message pbcc_get_msg_v2_at(struct pbcc_context const* p,
+                                            unsigned                   index)
+{
+    struct pubnub_v2_message rslt;
+
+    if (index >= p->msg_v2_count) {
+        memset(&rslt, 0, sizeof rslt);
+        return rslt;
     }
+    return msg_v2_from_entry(p, &p->msg_v2_index[index]);
+}
 
-    return rslt;
+
+void pbcc_free_msg_v2_index(struct pbcc_context* p)
+{
+    if (p->msg_v2_index != NULL) {
+        pbmem_free(p->msg_v2_index);
+        p->msg_v2_index    = NULL;
+        p->msg_v2_capacity = 0;
+    }
+    p->msg_v2_count = p->msg_v2_next = 0;
 }
@@ -6,6 +6,39 @@
 
 struct pbcc_context;
 
+
+/** A part of the subscribe V2 response, by its offset in the
+    reply buffer and length. Offset 0 (which is the start of the
+    response, so, not a part of any message) means "not present".
+ */
+struct pbcc_msg_v2_span {
+    unsigned ofs;
+    unsigned len;
+};
+
+
+/** An entry of the structural index of the messages in a subscribe
+    V2 response, built once, when the response is parsed.  Offsets
+    are used, rather than pointers, so the entry is smaller and
+    doesn't depend on the address of the reply buffer.
+ */
+struct pbcc_msg_v2_entry {
+    /** Offset of the message (its opening curly brace) */
+    unsigned ofs;
+    /** Offset of the message which follows this one */
+    unsigned next_ofs;
+    struct pbcc_msg_v2_span  tt;
+    /** The time token as an integer, converted once, when indexing */
+    uint64_t                 tt_u64;
+    struct pbcc_msg_v2_span  channel;
+    struct pbcc_msg_v2_span  match_or_group;
+    struct pbcc_msg_v2_span  payload;
+    struct pbcc_msg_v2_span  metadata;
+    int                      region;
+    int                      flags;
+    enum pubnub_message_type message_type;
+};
+
 /** Prepares the Subscribe_v2 operation (transaction), mostly by
     formatting the URI of the HTTP request.
   */
@@ -21,8 +54,12 @@ enum pubnub_res pbcc_subscribe_v2_prep(struct pbcc_context* p,
     is, prepares for giving the v2 messages that are received in the
     response to the user (via pbcc_get_msg_v2()).
 
+    The messages are indexed (see pbcc_msg_v2_entry) in the same
+    pass, so getting them afterwards doesn't parse them again.
+
     @param p The Pubnub C core context to parse the response "in"
-    @return PNR_OK: OK, PNR_FORMAT_ERROR: error (invalid response)
+    @return PNR_OK: OK, PNR_FORMAT_ERROR: error (invalid response),
+    PNR_OUT_OF_MEMORY: failed to allocate the message index
   */
 enum pubnub_res pbcc_parse_subscribe_v2_response(struct pbcc_context* p);
 
@@ -34,4 +71,36 @@ enum pubnub_res pbcc_parse_subscribe_v2_response(struct pbcc_context* p);
 struct pubnub_v2_message pbcc_get_msg_v2(struct pbcc_context* p);
 
 
+/** Gets the next (up to) @p max v2 messages from the Pubnub C Core
+    context @p p into @p out, as if pbcc_get_msg_v2() was called for
+    each of them. Messages that are not valid (have no payload) are
+    skipped.
+    @return Number of messages put into @p out, 0 if there are no
+    (more) v2 messages
+  */
+size_t pbcc_get_msg_v2_batch(struct pbcc_context*      p,
+                             struct pubnub_v2_message* out,
+                             size_t                    max);
+
+
+/** Returns the number of v2 messages in the last subscribe V2
+    response parsed in the context @p p - regardless of how many
+    of them were already gotten with pbcc_get_msg_v2().
+  */
+unsigned pbcc_msg_v2_count(struct pbcc_context const* p);
+
+
+/** Returns the v2 message with the given @p index (starting from 0)
+    from the last subscribe V2 response parsed in the context @p p.
+    Doesn't change which message pbcc_get_msg_v2() returns next.
+    Empty structure if @p index is out of range.
+  */
+struct pubnub_v2_message pbcc_get_msg_v2_at(struct pbcc_context const* p,
+                                            unsigned                   index);
+
+
+/** Frees the message index of the context @p p */
+void pbcc_free_msg_v2_index(struct pbcc_context* p);
+
+
 #endif /* !defined INC_PBCC_SUBSCRIBE_V2 */
@@ -2,6 +2,9 @@
 #include "pubnub_internal.h"
 
 #include "core/pubnub_assert.h"
+#include "core/pbgzip_compress.h"
+#include "core/pbmem.h"
+#include "core/pubnub_mutex.h"
 #include "lib/miniz/miniz_tdef.h"
 #include "lib/pbcrc32.h"
 #include "core/pubnub_log.h"
@@ -11,23 +14,106 @@
 /* Percents 'off' message length after compression */
 #define PUBNUB_MINIMAL_ACCEPTABLE_COMPRESSION_RATIO 10
 
+PUBNUB_STATIC_ASSERT(PUBNUB_GZIP_MAX_PROBES <= TDEFL_MAX_PROBES_MASK,
+                     gzip_max_probes_out_of_range_);
+
+/** A compressor state, reused for many messages. It's too big for
+    the stack (especially of small threads) and clearing its hash
+    tables would take longer than compressing a small message.
+ */
+struct pbgzip_compressor {
+    tdefl_compressor comp;
+    /** Next in the list of idle compressors */
+    struct pbgzip_compressor* next;
+};
+
+/** Compressors that are not in use */
+static struct pbgzip_compressor* m_idle_compressors;
+
+/** Number of compressors in #m_idle_compressors */
+static unsigned m_idle_count;
+
+/** Guards the list of idle compressors */
+pubnub_mutex_static_decl_and_init(m_compressors_lock);
+
+
+/** Takes an idle compressor, or allocates a new one, and prepares it
+    for compressing a message.
+ */
+static struct pbgzip_compressor* acquire_compressor(void)
+{
+    struct pbgzip_compressor* compressor;
+
+    pubnub_mutex_init_static(m_compressors_lock);
+    pubnub_mutex_lock(m_compressors_lock);
+    compressor = m_idle_compressors;
+    if (compressor != NULL) {
+        m_idle_compressors = compressor->next;
+        --m_idle_count;
+    }
+    pubnub_mutex_unlock(m_compressors_lock);
+
+    if (NULL == compressor) {
+        /* Zeroed, so the hash tables are clear for the first message */
+        compressor = (struct pbgzip_compressor*)pbmem_calloc(
+            NULL, pbmemcatDecomp, 1, sizeof *compressor);
+        if (NULL == compressor) {
+            return NULL;
+        }
+    }
+    /* Doesn't clear the hash tables and the dictionary, as entries left
+       from previous messages are checked against the current one, so
+       they can only make for (slightly) different, but still correct,
+       compressed data.
+     */
+    tdefl_init(&compressor->comp,
+               NULL,
+               NULL,
+               PUBNUB_GZIP_MAX_PROBES | TDEFL_NONDETERMINISTIC_PARSING_FLAG);
+
+    return compressor;
+}
+
+
+static void release_compressor(struct pbgzip_compressor* compressor)
+{
+    pubnub_mutex_init_static(m_compressors_lock);
+    pubnub_mutex_lock(m_compressors_lock);
+    if (m_idle_count < PUBNUB_GZIP_MAX_IDLE_COMPRESSORS) {
+        compressor->next   = m_idle_compressors;
+        m_idle_compressors = compressor;
+        ++m_idle_count;
+        compressor = NULL;
+    }
+    pubnub_mutex_unlock(m_compressors_lock);
+    pbmem_free(compressor);
+}
+
+
 static enum pubnub_res deflate_total_to_context_buffer(pubnub_t*   pb,
                                                        char const* message,
                                                        size_t      message_size)
 {
     size_t unpacked_size = message_size;
-    size_t compressed = sizeof pb->core.gzip_msg_buf -
+    size_t compressed = PUBNUB_COMPRESSED_MAXLEN -
                         (GZIP_HEADER_LENGTH_BYTES + GZIP_FOOTER_LENGTH_BYTES);
     char* gzip_msg_buf = pb->core.gzip_msg_buf;
-    tdefl_compressor comp;
+    struct pbgzip_compressor* compressor = acquire_compressor();
+    tdefl_status status;
 
-    tdefl_init(&comp, NULL, NULL, TDEFL_DEFAULT_MAX_PROBES);
-    tdefl_status status = tdefl_compress(&comp,
-                                         message,
-                                         &message_size,
-                                         gzip_msg_buf + GZIP_HEADER_LENGTH_BYTES,
-                                         &compressed,
-                                         TDEFL_FINISH);
+    if (NULL == compressor) {
+        PUBNUB_LOG_ERROR("deflate_total_to_context_buffer(pb=%p) - "
+                         "failed to allocate the compressor\n",
+                         pb);
+        return PNR_OUT_OF_MEMORY;
+    }
+    status = tdefl_compress(&compressor->comp,
+                            message,
+                            &message_size,
+                            gzip_msg_buf + GZIP_HEADER_LENGTH_BYTES,
+                            &compressed,
+                            TDEFL_FINISH);
+    release_compressor(compressor);
     switch (status) {
     case TDEFL_STATUS_DONE:
         if (message_size == unpacked_size) {
@@ -103,7 +189,7 @@ static enum pubnub_res deflate_total_to_context_buffer(pubnub_t*   pb,
 }
 
 /* Compile-time assertion */
-PUBNUB_STATIC_ASSERT(sizeof (*(pubnub_t*)(NULL)).core.gzip_msg_buf
+PUBNUB_STATIC_ASSERT(PUBNUB_COMPRESSED_MAXLEN
                      > (GZIP_HEADER_LENGTH_BYTES + GZIP_FOOTER_LENGTH_BYTES),
                      gzip_msg_buf_too_small_);
 
@@ -116,6 +202,12 @@ enum pubnub_res pbgzip_compress(pubnub_t* pb, char const* message)
     PUBNUB_ASSERT_OPT(message != NULL);
 
     pb->core.gzip_msg_len = 0;
+    if (!pbcc_ensure_gzip_msg_buf(&pb->core)) {
+        PUBNUB_LOG_ERROR("pbgzip_compress(pb=%p) - "
+                         "failed to allocate the compression buffer\n",
+                         pb);
+        return PNR_OUT_OF_MEMORY;
+    }
     data = pb->core.gzip_msg_buf;
     /* Gzip format */
     data[0] = 0x1f;
@@ -4,6 +4,28 @@
 
 #include "pubnub_api_types.h"
 
+
+#if !defined PUBNUB_GZIP_MAX_PROBES
+/** The number of dictionary probes per search that the GZIP (deflate)
+    compressor does, from 0 (no LZ matching, just Huffman coding -
+    fastest) to 4095 (slowest, best compression). The default, 128,
+    is the usual "default compression level", while messages of a few
+    hundred bytes don't gain much from more than a dozen of probes.
+ */
+#define PUBNUB_GZIP_MAX_PROBES 128
+#endif
+
+#if !defined PUBNUB_GZIP_MAX_IDLE_COMPRESSORS
+/** The most compressor states (a few hundred KB each) to keep for
+    reuse, process-wide, when no message is being compressed. There
+    is one state for every message being compressed at the same time
+    (in different threads), so, if that happens a lot, keeping more
+    of them saves allocating and freeing them.
+ */
+#define PUBNUB_GZIP_MAX_IDLE_COMPRESSORS 1
+#endif
+
+
 /** Compresses(deflates) @p message into gzip-formatted data stored in context buffer.
     @retval PNR_OK on success,
     @retval PNR_STARTED on poor comression ratio,
@@ -2,12 +2,244 @@
 #include "pubnub_internal.h"
 
 #include "core/pubnub_assert.h"
+#include "core/pbmem.h"
+#include "core/pbcc_reply_pool.h"
 #include "lib/miniz/miniz_tinfl.h"
 #include "core/pubnub_log.h"
 
 #define GZIP_HEADER_LENGTH_BYTES 10
 #define GZIP_FOOTER_LENGTH_BYTES 8
 
+
+/** Checks the gzip header at @p data, of #GZIP_HEADER_LENGTH_BYTES */
+static enum pubnub_res check_header(uint8_t const* data)
+{
+    if ((data[0] != 0x1f) || (data[1] != 0x8b)) {
+        PUBNUB_LOG_ERROR("Compressed data format is not gzip!\n");
+        return PNR_BAD_COMPRESSION_FORMAT;
+    }
+    if (data[2] != 8) {
+        PUBNUB_LOG_ERROR("Unknown compression method %uX - only 'deflate'(8) "
+                         "is supported!\n",
+                         (unsigned)data[2]);
+        return PNR_BAD_COMPRESSION_FORMAT;
+    }
+    if (data[3] != 0) {
+        PUBNUB_LOG_ERROR("GZIP flags should be 0, but are %uX\n",
+                         (unsigned)data[3]);
+        return PNR_BAD_COMPRESSION_FORMAT;
+    }
+    return PNR_OK;
+}
+
+
+/** Unpacked message size is placed at the end of the 'gzip' formated
+    message, in the last four bytes (of the footer at @p footer)
+*/
+static uint32_t unpacked_size_from_footer(uint8_t const* footer)
+{
+    uint32_t unpacked_size = (uint32_t)footer[4];
+    unpacked_size |= (uint32_t)footer[5] << 8;
+    unpacked_size |= (uint32_t)footer[6] << 16;
+    unpacked_size |= (uint32_t)footer[7] << 24;
+    return unpacked_size;
+}
+
+
+#if PUBNUB_DYNAMIC_REPLY_BUFFER
+
+/** State of the decompression of a gzip response body as it arrives */
+struct pbgzip_stream {
+    tinfl_decompressor inflator;
+    /** The gzip header, as it arrives */
+    uint8_t header[GZIP_HEADER_LENGTH_BYTES];
+    /** How much of the header has arrived */
+    unsigned header_len;
+    /** The last bytes received - once all has been received, the
+        gzip footer */
+    uint8_t tail[GZIP_FOOTER_LENGTH_BYTES];
+    /** Total number of (compressed) bytes received */
+    size_t received;
+    /** Length of the decompressed data in the reply buffer */
+    size_t out_len;
+    /** Is the deflate stream finished (the rest is the footer) */
+    bool done;
+};
+
+
+enum pubnub_res pbgzip_stream_start(pubnub_t* pb)
+{
+    struct pbcc_context*  p = &pb->core;
+    struct pbgzip_stream* st;
+
+    if (NULL == p->gzip_stream) {
+        p->gzip_stream = (struct pbgzip_stream*)pbcc_reply_pool_get(
+            PBCC_MEMORY(p), pbmemcatDecomp, sizeof *st, &p->gzip_stream_size);
+        if (NULL == p->gzip_stream) {
+            PUBNUB_LOG_ERROR("pb=%p Failed to allocate decompression state\n", pb);
+            return PNR_REPLY_TOO_BIG;
+        }
+    }
+    st = p->gzip_stream;
+    tinfl_init(&st->inflator);
+    st->header_len = 0;
+    st->received   = 0;
+    st->out_len    = 0;
+    st->done       = false;
+
+    return PNR_OK;
+}
+
+
+/** Makes room for (at least) twice as much decompressed data in the
+    reply buffer, keeping the data that is already there.
+ */
+static enum pubnub_res grow_reply_buffer(pubnub_t* pb)
+{
+    struct pbcc_context* p = &pb->core;
+    size_t               newsize;
+    char*                newbuf = pbcc_reply_pool_get(PBCC_MEMORY(p),
+                                        pbmemcatReply,
+                                        2 * (p->gzip_stream->out_len + 1),
+                                        &newsize);
+    if (NULL == newbuf) {
+        PUBNUB_LOG_ERROR("Failed to reallocate decompression buffer!\n"
+                         "Out length:%lu\n",
+                         (unsigned long)p->gzip_stream->out_len);
+        return PNR_REPLY_TOO_BIG;
+    }
+    if (p->http_reply != NULL) {
+        memcpy(newbuf, p->http_reply, p->gzip_stream->out_len);
+        pbcc_reply_pool_put(p->http_reply, p->http_reply_size);
+    }
+    p->http_reply      = newbuf;
+    p->http_reply_size = newsize;
+
+    return PNR_OK;
+}
+
+
+static void update_tail(struct pbgzip_stream* st, uint8_t const* data, size_t len)
+{
+    if (len >= sizeof st->tail) {
+        memcpy(st->tail, data + len - sizeof st->tail, sizeof st->tail);
+    }
+    else {
+        memmove(st->tail, st->tail + len, sizeof st->tail - len);
+        memcpy(st->tail + sizeof st->tail - len, data, len);
+    }
+}
+
+
+enum pubnub_res pbgzip_stream_feed(pubnub_t* pb, uint8_t const* data, size_t len)
+{
+    struct pbcc_context*  p  = &pb->core;
+    struct pbgzip_stream* st = p->gzip_stream;
+    bool                  more_output = false;
+
+    PUBNUB_ASSERT_OPT(st != NULL);
+
+    st->received += len;
+    update_tail(st, data, len);
+    if (st->header_len < GZIP_HEADER_LENGTH_BYTES) {
+        size_t to_copy = GZIP_HEADER_LENGTH_BYTES - st->header_len;
+        if (to_copy > len) {
+            to_copy = len;
+        }
+        memcpy(st->header + st->header_len, data, to_copy);
+        st->header_len += (unsigned)to_copy;
+        data += to_copy;
+        len -= to_copy;
+        if ((GZIP_HEADER_LENGTH_BYTES == st->header_len)
+            && (check_header(st->header) != PNR_OK)) {
+            return PNR_BAD_COMPRESSION_FORMAT;
+        }
+    }
+    /* Whatever comes after the deflate stream is the footer, which is
+       kept in the tail */
+    while (!st->done && ((len > 0) || more_output)) {
+        size_t       in_size = len;
+        size_t       out_size;
+        tinfl_status status;
+
+        /* Always leave room for the string end */
+        if ((p->http_reply_size <= st->out_len + 1)
+            && (grow_reply_buffer(pb) != PNR_OK)) {
+            return PNR_REPLY_TOO_BIG;
+        }
+        out_size = p->http_reply_size - st->out_len - 1;
+        status   = tinfl_decompress(&st->inflator,
+                                  data,
+                                  &in_size,
+                                  (mz_uint8*)p->http_reply,
+                                  (mz_uint8*)p->http_reply + st->out_len,
+                                  &out_size,
+                                  TINFL_FLAG_HAS_MORE_INPUT
+                                      | TINFL_FLAG_USING_NON_WRAPPING_OUTPUT_BUF);
+        data += in_size;
+        len -= in_size;
+        st->out_len += out_size;
+        more_output = false;
+        switch (status) {
+        case TINFL_STATUS_DONE:
+            st->done = true;
+            break;
+        case TINFL_STATUS_NEEDS_MORE_INPUT:
+            break;
+        case TINFL_STATUS_HAS_MORE_OUTPUT:
+            if (grow_reply_buffer(pb) != PNR_OK) {
+                return PNR_REPLY_TOO_BIG;
+            }
+            more_output = true;
+            break;
+        default:
+            PUBNUB_LOG_ERROR("'Tinfl'-decompress status: %d!\n", status);
+            return PNR_BAD_COMPRESSION_FORMAT;
+        }
+    }
+
+    return PNR_OK;
+}
+
+
+enum pubnub_res pbgzip_stream_finish(pubnub_t* pb)
+{
+    struct pbcc_context*  p  = &pb->core;
+    struct pbgzip_stream* st = p->gzip_stream;
+    uint32_t              unpacked_size;
+
+    PUBNUB_ASSERT_OPT(st != NULL);
+
+    if ((st->received < GZIP_HEADER_LENGTH_BYTES + GZIP_FOOTER_LENGTH_BYTES)
+        || !st->done) {
+        PUBNUB_LOG_ERROR("pb=%p Compressed data is incomplete (%lu bytes)!\n",
+                         pb,
+                         (unsigned long)st->received);
+        return PNR_BAD_COMPRESSION_FORMAT;
+    }
+    unpacked_size = unpacked_size_from_footer(st->tail);
+    if (unpacked_size != (uint32_t)st->out_len) {
+        PUBNUB_LOG_ERROR("Decompressed length[%lu] doesn't match the "
+                         "'unpacked_size' value[%lu]!\n",
+                         (unsigned long)st->out_len,
+                         (unsigned long)unpacked_size);
+        return PNR_BAD_COMPRESSION_FORMAT;
+    }
+    PUBNUB_LOG_TRACE("pbgzip_stream_finish(pb=%p)-Length before:%lu and after "
+                     "decompresion:%lu\n",
+                     pb,
+                     (unsigned long)st->received,
+                     (unsigned long)st->out_len);
+    p->http_buf_len = st->out_len;
+    pbcc_reply_pool_put((char*)st, p->gzip_stream_size);
+    p->gzip_stream      = NULL;
+    p->gzip_stream_size = 0;
+
+    return PNR_OK;
+}
+
+#else
+
 static enum pubnub_res inflate_total_to_context_buffer(pubnub_t*      pb,
                                                        uint8_t const* p_in_buf_next,
                                                        size_t in_buf_size,
@@ -66,25 +298,14 @@ static enum pubnub_res inflate_total_to_context_buffer(pubnub_t*      pb,
     return PNR_BAD_COMPRESSION_FORMAT;
 }
 
-#if !PUBNUB_DYNAMIC_REPLY_BUFFER
 PUBNUB_STATIC_ASSERT(sizeof((pubnub_t*)0)->core.http_reply == sizeof((pubnub_t*)0)->core.decomp_http_reply,
                      http_reply_and_gzip_decompression_buffer_dont_match);
-#endif
 
 static void swap_reply_buffer(pubnub_t* pb)
 {
-#if PUBNUB_DYNAMIC_REPLY_BUFFER
-    char*  aux_buf             = pb->core.http_reply;
-    size_t aux_buf_len         = pb->core.http_buf_len;
-    pb->core.http_reply        = pb->core.decomp_http_reply;
-    pb->core.http_buf_len      = pb->core.decomp_buf_size;
-    pb->core.decomp_http_reply = aux_buf;
-    pb->core.decomp_buf_size   = aux_buf_len;
-#else
     PUBNUB_ASSERT(pb->core.decomp_buf_size < sizeof pb->core.decomp_http_reply);
     memcpy(pb->core.http_reply, pb->core.decomp_http_reply, pb->core.decomp_buf_size);
     pb->core.http_buf_len = pb->core.decomp_buf_size;
-#endif /* PUBNUB_DYNAMIC_REPLY_BUFFER */
     return;
 }
 
@@ -95,18 +316,6 @@ static enum pubnub_res inflate_total(pubnub_t*      pb,
                                      size_t         out_len)
 {
     enum pubnub_res result;
-#if PUBNUB_DYNAMIC_REPLY_BUFFER
-    if (pb->core.decomp_buf_size < out_len) {
-        char* newbuf = (char*)realloc(pb->core.decomp_http_reply, out_len + 1);
-        if (NULL == newbuf) {
-            PUBNUB_LOG_ERROR("Failed to reallocate decompression buffer!\n"
-                             "Out length:%lu\n",
-                             (unsigned long)out_len);
-            return PNR_REPLY_TOO_BIG;
-        }
-        pb->core.decomp_http_reply = newbuf;
-    }
-#else
     if (out_len >= sizeof pb->core.decomp_http_reply) {
         PUBNUB_LOG_ERROR("Decompression buffer too small!\n"
                          "Size of buffer:%lu - Out length:%lu\n",
@@ -114,7 +323,6 @@ static enum pubnub_res inflate_total(pubnub_t*      pb,
                          (unsigned long)out_len);
         return PNR_REPLY_TOO_BIG;
     }
-#endif
     result =
         inflate_total_to_context_buffer(pb, p_in_buf_next, in_buf_size, out_len);
     if (result == PNR_OK) {
@@ -131,29 +339,14 @@ enum pubnub_res pbgzip_decompress(pubnub_t* pb)
     size_t         size = (size_t)pb->core.http_buf_len;
     uint32_t       unpacked_size;
 
-    if ((size < (GZIP_HEADER_LENGTH_BYTES + GZIP_FOOTER_LENGTH_BYTES))
-        || (data[0] != 0x1f) || (data[1] != 0x8b)) {
+    if (size < (GZIP_HEADER_LENGTH_BYTES + GZIP_FOOTER_LENGTH_BYTES)) {
         PUBNUB_LOG_ERROR("Compressed data format is not gzip!\n");
         return PNR_BAD_COMPRESSION_FORMAT;
     }
-    if (data[2] != 8) {
-        PUBNUB_LOG_ERROR("Unknown compression method %uX - only 'deflate'(8) "
-                         "is supported!\n",
-                         (unsigned)data[2]);
-        return PNR_BAD_COMPRESSION_FORMAT;
-    }
-    if (data[3] != 0) {
-        PUBNUB_LOG_ERROR("GZIP flags should be 0, but are %uX\n",
-                         (unsigned)data[3]);
+    if (check_header(data) != PNR_OK) {
         return PNR_BAD_COMPRESSION_FORMAT;
     }
-    /* Unpacked message size is placed at the end of the 'gzip' formated message
-       in the last four bytes
-     */
-    unpacked_size = (uint32_t)data[size - 4];
-    unpacked_size |= (uint32_t)data[size - 3] << 8;
-    unpacked_size |= (uint32_t)data[size - 2] << 16;
-    unpacked_size |= (uint32_t)data[size - 1] << 24;
+    unpacked_size = unpacked_size_from_footer(data + size - GZIP_FOOTER_LENGTH_BYTES);
     PUBNUB_LOG_TRACE("pbgzip_decompress(pb=%p)-Length before:%lu and after "
                      "decompresion:%lu\n",
                      pb,
@@ -164,3 +357,5 @@ enum pubnub_res pbgzip_decompress(pubnub_t* pb)
     return inflate_total(
         pb, data + GZIP_HEADER_LENGTH_BYTES, size, (size_t)unpacked_size);
 }
+
+#endif /* PUBNUB_DYNAMIC_REPLY_BUFFER */
@@ -4,14 +4,49 @@
 
 #include "pubnub_api_types.h"
 
+#include <stdint.h>
+#include <stddef.h>
+
 /* Types of compressed data format */
 enum pubnub_data_compressionType{
     compressionNONE,
     compressionGZIP
 };
 
+/** State of the decompression of a gzip response body as it arrives */
+struct pbgzip_stream;
+
+/** Starts decompressing a gzip response body of the context @p pb
+    as it arrives, borrowing the decompression state from the reply
+    buffer pool. Decompressed data is written straight into the reply
+    buffer, which is grown as needed. Used if
+    #PUBNUB_DYNAMIC_REPLY_BUFFER is true.
+    @retval PNR_OK on success,
+    @retval PNR_REPLY_TOO_BIG lack of memory
+ */
+enum pubnub_res pbgzip_stream_start(pubnub_t *pb);
+
+/** Decompresses the next @p len bytes at @p data of the gzip response
+    body of the context @p pb, started with pbgzip_stream_start().
+    @retval PNR_OK on success,
+    @retval PNR_REPLY_TOO_BIG lack of memory,
+    @retval PNR_BAD_COMPRESSION_FORMAT on error
+ */
+enum pubnub_res pbgzip_stream_feed(pubnub_t *pb, uint8_t const* data, size_t len);
+
+/** Finishes decompressing the gzip response body of the context @p pb,
+    once all of it has been fed with pbgzip_stream_feed(), checking
+    the size in the gzip footer and giving the decompression state back
+    to the pool. On success, the decompressed data is in the reply
+    buffer, like an uncompressed response would be.
+    @retval PNR_OK on success,
+    @retval PNR_BAD_COMPRESSION_FORMAT on error
+ */
+enum pubnub_res pbgzip_stream_finish(pubnub_t *pb);
+
 /** Decompresses(inflates) gzip-formatted data stored in the reply context buffer.
-    After decompression puts it back into the same buffer.
+    After decompression puts it back into the same buffer. Used if
+    #PUBNUB_DYNAMIC_REPLY_BUFFER is false.
     @retval PNR_OK on success,
     @retval PNR_REPLY_TOO_BIG lack of memory,
     @retval PNR_BAD_COMPRESSION_FORMAT on error     
@@ -0,0 +1,97 @@
+/* -*- c-file-style:"stroustrup"; indent-tabs-mode: nil -*- */
+#if !defined INC_PBMEM
+#define      INC_PBMEM
+
+#include "pubnub_config.h"
+#include "pubnub_memory_stats.h"
+
+#include <stddef.h>
+
+
+#if !defined PUBNUB_MEMORY_STATS
+/** If true (!=0), all memory allocated through these functions is
+    accounted for, per category, per context and process-wide - see
+    pubnub_memory_stats(). This costs a small header on every
+    allocation and a (global) lock on every allocation and free.
+ */
+#define PUBNUB_MEMORY_STATS 0
+#endif
+
+
+/** @file pbmem.h
+    Heap allocation for the Pubnub C-core and its PAL modules. These
+    should be used instead of malloc(), realloc() and free(), as they
+    go through the allocator set by pubnub_set_allocator() and, if
+    #PUBNUB_MEMORY_STATS is true, do the memory accounting.
+
+    The allocated memory is accounted for in the given @p category,
+    process-wide and, unless @p account is NULL, in the @p account,
+    which is typically the one of the Pubnub context (see
+    #PBCC_MEMORY()). Memory still accounted for in a context's account
+    when the context is deinitialized is detached from it (see
+    pbmem_account_detach()).
+ */
+
+
+union pbmem_header;
+
+/** A memory account (of a Pubnub context) */
+struct pbmem_account {
+    /** The report of the memory accounted for here */
+    struct pubnub_memory_report report;
+    /** The memory blocks accounted for here, to detach them when the
+        account goes away */
+    union pbmem_header* blocks;
+};
+
+
+/** Allocates @p size bytes, like malloc() */
+void* pbmem_alloc(struct pbmem_account*       account,
+                  enum pubnub_memory_category category,
+                  size_t                      size);
+
+/** Resizes the memory at @p ptr to @p size bytes, like realloc().
+    If @p ptr is not NULL, it stays accounted for where it was when
+    allocated.
+ */
+void* pbmem_realloc(struct pbmem_account*       account,
+                    enum pubnub_memory_category category,
+                    void*                       ptr,
+                    size_t                      size);
+
+/** Allocates and zeroes an array of @p n elements of @p size bytes
+    each, like calloc() */
+void* pbmem_calloc(struct pbmem_account*       account,
+                   enum pubnub_memory_category category,
+                   size_t                      n,
+                   size_t                      size);
+
+/** Frees the memory at @p ptr, like free() */
+void pbmem_free(void* ptr);
+
+/** Moves the accounting of the memory at @p ptr (allocated with
+    one of the functions above) to the @p account and @p category,
+    for memory that is handed over from one owner to another, like
+    the buffers of the reply buffer pool.
+ */
+void pbmem_reassign(void*                       ptr,
+                    struct pbmem_account*       account,
+                    enum pubnub_memory_category category);
+
+/** Detaches all the memory still accounted for in the @p account
+    from it, so that it is accounted for only process-wide, as the
+    @p account is going away, while that memory may outlive it.
+ */
+void pbmem_account_detach(struct pbmem_account* account);
+
+/** Allocates @p size bytes to be handed over to the user, who frees
+    it with pubnub_free_memory() - or free(), if no allocator was set,
+    which is why such memory is not accounted for.
+ */
+void* pbmem_alloc_user(size_t size);
+
+/** Frees the memory allocated with pbmem_alloc_user() */
+void pbmem_free_user(void* ptr);
+
+
+#endif /* !defined INC_PBMEM */
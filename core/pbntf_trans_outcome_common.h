@@ -21,6 +21,7 @@
             PUBNUB_LOG_WARNING("Context %p Resetting time token\n", M_pb_);        \
             M_pb_->core.timetoken[0] = '0';                                        \
             M_pb_->core.timetoken[1] = '\0';                                       \
+            M_pb_->core.timetoken_u64 = 0;                                         \
             break;                                                                 \
         default:                                                                   \
             break;                                                                 \
@@ -0,0 +1,267 @@
+/* -*- c-file-style:"stroustrup"; indent-tabs-mode: nil -*- */
+#include "pubnub_internal.h"
+
+#if PUBNUB_USE_ADVANCED_HISTORY || PUBNUB_USE_OBJECTS_API
+#include "pbpager.h"
+#include "pubnub_pubsubapi.h"
+#if !defined(PUBNUB_CALLBACK_API)
+#include "pubnub_ntf_sync.h"
+#endif
+
+#include "pubnub_assert.h"
+#include "pubnub_log.h"
+
+#include <string.h>
+
+
+/** The data for taking an element from a page of a pager */
+struct pager_progress {
+    /** The pager */
+    struct pbpager* pager;
+    /** Where to put the element */
+    void* elem;
+    /** Set if an element was taken */
+    bool have;
+    /** The context on which the next page is being fetched, NULL if
+        none */
+    pubnub_t* prefetch_pb;
+};
+
+
+/** Takes the next element from the page on @p pb, with the
+    `take_element` of the API, also driving the transaction that
+    fetches the next page (sync interface), if that doesn't block.
+    To be called with the context locked.
+ */
+static enum pubnub_res take_page_element(pubnub_t* pb, void* data)
+{
+    struct pager_progress* pp = (struct pager_progress*)data;
+
+#if !defined(PUBNUB_CALLBACK_API) && PUBNUB_BLOCKING_IO_SETTABLE
+    if ((pp->prefetch_pb != NULL) && !pp->prefetch_pb->options.use_blocking_io) {
+        pubnub_last_result(pp->prefetch_pb);
+    }
+#endif
+    return pp->pager->api->take_element(pb, pp->elem, &pp->have);
+}
+
+
+/** Waits for the next element from the page on @p pb (in the sync
+    interface).
+ */
+static enum pubnub_res await_page_element(pubnub_t* pb, struct pager_progress* pp)
+{
+#if defined(PUBNUB_CALLBACK_API)
+    enum pubnub_res rslt;
+
+    pubnub_mutex_lock(pb->monitor);
+    rslt = take_page_element(pb, pp);
+    pubnub_mutex_unlock(pb->monitor);
+
+    return rslt;
+#else
+    return pbntf_await_progress(pb, take_page_element, pp);
+#endif
+}
+
+
+/** Starts fetching, on the context @p pb, the page of @p pager at
+    @p start (NULL for the first one).
+ */
+static enum pubnub_res start_page(struct pbpager* pager,
+                                  pubnub_t*       pb,
+                                  char const*     start)
+{
+    enum pubnub_res rslt = pager->api->start_page(pager, pb, start);
+    if ((rslt != PNR_STARTED) && (rslt != PNR_OK)) {
+        PUBNUB_LOG_ERROR("pager=%p: Failed to start getting a page, "
+                         "pb=%p, start='%s', error %d\n",
+                         pager,
+                         pb,
+                         (NULL == start) ? "" : start,
+                         rslt);
+    }
+    return rslt;
+}
+
+
+/** Cancels the transaction in progress on @p pb, if any, waiting for it
+    to end (in the sync interface). A finished transaction is left
+    alone, as cancelling would close the connection kept alive.
+ */
+static void cancel_page(pubnub_t* pb)
+{
+    bool in_progress;
+
+    pubnub_mutex_lock(pb->monitor);
+    in_progress = !pbnc_can_start_transaction(pb);
+    pubnub_mutex_unlock(pb->monitor);
+
+    if (in_progress && (PN_CANCEL_STARTED == pubnub_cancel(pb))) {
+#if !defined(PUBNUB_CALLBACK_API)
+        pubnub_await(pb);
+#endif
+    }
+}
+
+
+/** Puts the contexts of @p pager in non-blocking I/O mode (sync
+    interface), remembering the mode they were in. With blocking I/O,
+    the next page could not be fetched while the current one is being
+    taken, as driving its transaction would block.
+ */
+static void set_non_blocking_io(struct pbpager* pager)
+{
+#if !defined(PUBNUB_CALLBACK_API) && PUBNUB_BLOCKING_IO_SETTABLE
+    unsigned i;
+
+    for (i = 0; i < 2; ++i) {
+        pubnub_t* pb = pager->pb[i];
+        pubnub_mutex_lock(pb->monitor);
+        pager->blocking_io[i]       = pb->options.use_blocking_io;
+        pb->options.use_blocking_io = false;
+        pubnub_mutex_unlock(pb->monitor);
+    }
+#else
+    pager->blocking_io[0] = pager->blocking_io[1] = false;
+#endif
+}
+
+
+/** Puts the contexts of @p pager back in the I/O mode they were in
+    before set_non_blocking_io().
+ */
+static void restore_io_mode(struct pbpager* pager)
+{
+#if !defined(PUBNUB_CALLBACK_API) && PUBNUB_BLOCKING_IO_SETTABLE
+    unsigned i;
+
+    for (i = 0; i < 2; ++i) {
+        pubnub_t* pb = pager->pb[i];
+        pubnub_mutex_lock(pb->monitor);
+        pb->options.use_blocking_io = pager->blocking_io[i];
+        pubnub_mutex_unlock(pb->monitor);
+    }
+#else
+    PUBNUB_UNUSED(pager);
+#endif
+}
+
+
+enum pubnub_res pbpager_start(struct pbpager*           pager,
+                              struct pbpager_api const* api,
+                              pubnub_t*                 pb,
+                              pubnub_t*                 prefetch_pb,
+                              unsigned                  page_size)
+{
+    enum pubnub_res rslt;
+
+    PUBNUB_ASSERT_OPT(pager != NULL);
+    PUBNUB_ASSERT_OPT(api != NULL);
+    PUBNUB_ASSERT(pb_valid_ctx_ptr(pb));
+    PUBNUB_ASSERT(pb_valid_ctx_ptr(prefetch_pb));
+    PUBNUB_ASSERT_OPT(pb != prefetch_pb);
+
+    pager->api           = api;
+    pager->pb[0]         = pb;
+    pager->pb[1]         = prefetch_pb;
+    pager->current       = 0;
+    pager->page_size     = page_size;
+    pager->taken         = 0;
+    pager->next          = +1;
+    pager->prefetching   = false;
+    pager->done          = false;
+    pager->next_start[0] = '\0';
+    set_non_blocking_io(pager);
+
+    rslt = start_page(pager, pb, NULL);
+    if ((rslt != PNR_STARTED) && (rslt != PNR_OK)) {
+        restore_io_mode(pager);
+        pager->done = true;
+    }
+    return rslt;
+}
+
+
+enum pubnub_res pbpager_next(struct pbpager* pager, void* elem)
+{
+    PUBNUB_ASSERT_OPT(pager != NULL);
+    PUBNUB_ASSERT_OPT(elem != NULL);
+
+    for (;;) {
+        pubnub_t*             pb    = pager->pb[pager->current];
+        pubnub_t*             other = pager->pb[1 - pager->current];
+        struct pager_progress pp;
+        enum pubnub_res       rslt;
+
+        if (pager->done) {
+            memset(elem, 0, pager->api->elem_size);
+            return PNR_OK;
+        }
+        pp.pager       = pager;
+        pp.elem        = elem;
+        pp.have        = false;
+        pp.prefetch_pb = pager->prefetching ? other : NULL;
+        rslt           = await_page_element(pb, &pp);
+        if (PNR_IN_PROGRESS == rslt) {
+            return rslt;
+        }
+        if (rslt != PNR_OK) {
+            pbpager_stop(pager);
+            return rslt;
+        }
+        if (pp.have) {
+            /* Once the page is here, the next one can be fetched */
+            if (0 == pager->taken++) {
+                pager->next = pager->api->page_received(pager, pb, elem);
+                if (0 == pager->next) {
+                    rslt = start_page(pager, other, pager->next_start);
+                    pager->prefetching = (PNR_STARTED == rslt) || (PNR_OK == rslt);
+                }
+            }
+            return PNR_OK;
+        }
+        /* The current page is done. An empty page, one that is not
+           full, or one that says so, is the last one. */
+        if ((0 == pager->taken) || (pager->taken < pager->page_size)
+            || (pager->next > 0)) {
+            pbpager_stop(pager);
+            continue;
+        }
+        if (pager->next < 0) {
+            pbpager_stop(pager);
+            return PNR_FORMAT_ERROR;
+        }
+        if (!pager->prefetching) {
+            /* Failed to start it before, try again */
+            rslt = start_page(pager, other, pager->next_start);
+            if ((rslt != PNR_STARTED) && (rslt != PNR_OK)) {
+                pbpager_stop(pager);
+                return rslt;
+            }
+        }
+        pager->current     = 1 - pager->current;
+        pager->taken       = 0;
+        pager->next        = +1;
+        pager->prefetching = false;
+    }
+}
+
+
+void pbpager_stop(struct pbpager* pager)
+{
+    PUBNUB_ASSERT_OPT(pager != NULL);
+
+    if (pager->done) {
+        return;
+    }
+    if (pager->prefetching) {
+        cancel_page(pager->pb[1 - pager->current]);
+        pager->prefetching = false;
+    }
+    cancel_page(pager->pb[pager->current]);
+    restore_io_mode(pager);
+    pager->done = true;
+}
+
+#endif /* PUBNUB_USE_ADVANCED_HISTORY || PUBNUB_USE_OBJECTS_API */
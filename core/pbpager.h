@@ -0,0 +1,110 @@
+/* -*- c-file-style:"stroustrup"; indent-tabs-mode: nil -*- */
+#if !defined INC_PBPAGER
+#define INC_PBPAGER
+
+#include "pubnub_api_types.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+
+/** Maximum length of the start of a page (a time token, or a page
+    cursor) that a pager can handle.
+ */
+#if !defined PUBNUB_PAGER_START_MAX_LEN
+#define PUBNUB_PAGER_START_MAX_LEN 256
+#endif
+
+struct pbpager;
+
+/** What a pager needs from the API whose results it goes through,
+    page by page.
+ */
+struct pbpager_api {
+    /** Starts fetching a page on the context @p pb: the first one
+        (if @p start is NULL), or the one at @p start, as remembered
+        by `page_received`. Like the API functions, returns
+        #PNR_STARTED or #PNR_OK if started.
+     */
+    enum pubnub_res (*start_page)(struct pbpager* pager, pubnub_t* pb, char const* start);
+    /** Takes the next element of the page on @p pb, putting it in
+        @p elem. To be called with the context locked. Sets
+        @p o_have to false if there are no more elements in the page.
+        @retval PNR_OK element taken, or no more of them
+        @retval PNR_IN_PROGRESS not (yet) received
+        @retval otherwise error in getting the page
+     */
+    enum pubnub_res (*take_element)(pubnub_t* pb, void* elem, bool* o_have);
+    /** Called when the first element, @p elem, of the page on @p pb
+        is taken. Puts the start of the next page in `next_start` of
+        @p pager.
+        @retval 0 the next page starts at `next_start`
+        @retval +1 this is the last page
+        @retval -1 where the next page starts is not valid
+     */
+    int (*page_received)(struct pbpager* pager, pubnub_t* pb, void const* elem);
+    /** Size of an element */
+    size_t elem_size;
+};
+
+/** The API independent part of a pager, the first member of the
+    pager of an API (so that the callbacks in @ref pbpager_api can get
+    to the rest of it). Uses two contexts, alternately: while the
+    elements of a page are taken from one, the next page is being
+    fetched on the other.
+ */
+struct pbpager {
+    /** The callbacks of the API */
+    struct pbpager_api const* api;
+    /** The contexts to use */
+    pubnub_t* pb[2];
+    /** Index (in `pb`) of the context with the current page */
+    unsigned current;
+    /** Number of elements per page, 0 if not known. A page that has
+        fewer is the last one. */
+    unsigned page_size;
+    /** Number of elements taken from the current page */
+    unsigned taken;
+    /** The result of `page_received` for the current page */
+    int next;
+    /** The next page is being fetched (on the other context) */
+    bool prefetching;
+    /** No more pages */
+    bool done;
+    /** The I/O mode of the contexts (in `pb`) before paging started,
+        to restore when it stops (sync interface) */
+    bool blocking_io[2];
+    /** Where the next page starts, as put by `page_received` */
+    char next_start[PUBNUB_PAGER_START_MAX_LEN + 1];
+};
+
+
+/** Starts going through the pages of @p api with @p pager, using
+    the contexts @p pb and @p prefetch_pb, @p page_size elements per
+    page (0 if not known). In the sync interface, the contexts use
+    non-blocking I/O until the pager is stopped, so that the next page
+    is fetched while the elements of the current one are taken.
+    @return The result of starting to fetch the first page, on @p pb
+ */
+enum pubnub_res pbpager_start(struct pbpager*           pager,
+                              struct pbpager_api const* api,
+                              pubnub_t*                 pb,
+                              pubnub_t*                 prefetch_pb,
+                              unsigned                  page_size);
+
+/** Takes the next element from @p pager, putting it in @p elem,
+    going from page to page.
+    @retval PNR_OK element taken, or, if @p elem is all zeros, there
+                   are no more (the last page is done)
+    @retval PNR_IN_PROGRESS page not received yet (callback interface)
+    @retval otherwise error in getting a page, paging is stopped
+ */
+enum pubnub_res pbpager_next(struct pbpager* pager, void* elem);
+
+/** Stops @p pager, cancelling the transactions it has in progress,
+    and restoring the I/O mode of its contexts.
+ */
+void pbpager_stop(struct pbpager* pager);
+
+
+#endif /* !defined INC_PBPAGER */
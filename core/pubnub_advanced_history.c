@@ -5,10 +5,15 @@
 #include "pubnub_memory_block.h"
 #include "pubnub_advanced_history.h"
 #include "pubnub_json_parse.h"
+#include "pubnub_server_limits.h"
+#include "pubnub_ccore.h"
+#include "pbpager.h"
 
 #include "pubnub_assert.h"
 #include "pubnub_log.h"
 
+#include <string.h>
+
 
 /** Should be called only if server reported an error */
 int pubnub_get_error_message(pubnub_t* pb, pubnub_chamebl_t* o_msg)
@@ -104,6 +109,27 @@ int pubnub_get_chan_msg_counts(pubnub_t* pb,
 }
 
 
+struct pubnub_chan_msg_count pubnub_get_chan_msg_count(pubnub_t* pb)
+{
+    struct pubnub_chan_msg_count rslt;
+
+    PUBNUB_ASSERT(pb_valid_ctx_ptr(pb));
+
+    pubnub_mutex_lock(pb->monitor);
+    if (!pbnc_can_start_transaction(pb)) {
+        pubnub_mutex_unlock(pb->monitor);
+        rslt.channel.ptr   = NULL;
+        rslt.channel.size  = 0;
+        rslt.message_count = 0;
+        return rslt;
+    }
+    rslt = pbcc_get_chan_msg_count(&(pb->core));
+
+    pubnub_mutex_unlock(pb->monitor);
+    return rslt;
+}
+
+
 int pubnub_get_message_counts(pubnub_t* pb, char const* channel, int* o_count)
 {
     int rslt;
@@ -123,4 +149,187 @@ int pubnub_get_message_counts(pubnub_t* pb, char const* channel, int* o_count)
     return rslt;
 }
 
+
+enum pubnub_res pubnub_history_stream(pubnub_t*   pb,
+                                      char const* channel,
+                                      unsigned    count,
+                                      bool        include_token,
+                                      char const* start)
+{
+    enum pubnub_res rslt;
+
+    PUBNUB_ASSERT(pb_valid_ctx_ptr(pb));
+
+    pubnub_mutex_lock(pb->monitor);
+    if (!pbnc_can_start_transaction(pb)) {
+        pubnub_mutex_unlock(pb->monitor);
+        return PNR_IN_PROGRESS;
+    }
+
+    rslt = pbcc_history_prep(&pb->core,
+                             channel,
+                             count,
+                             include_token,
+                             pbccNotSet,
+                             pbccNotSet,
+                             pbccNotSet,
+                             start,
+                             NULL);
+    if (PNR_STARTED == rslt) {
+        if (pbcc_history_stream_request(&pb->core, include_token) != 0) {
+            rslt = PNR_OUT_OF_MEMORY;
+        }
+    }
+    if (PNR_STARTED == rslt) {
+        pb->trans            = PBTT_HISTORY;
+        pb->core.last_result = PNR_STARTED;
+        pbnc_fsm(pb);
+        rslt = pb->core.last_result;
+    }
+
+    pubnub_mutex_unlock(pb->monitor);
+    return rslt;
+}
+
+
+/** Takes the next message from the history stream of @p pb, if there
+    is one, putting it in @p data (a `struct pubnub_history_message`).
+    To be called with the context locked.
+ */
+static enum pubnub_res take_history_message(pubnub_t* pb, void* data)
+{
+    struct pubnub_history_message* msg = (struct pubnub_history_message*)data;
+
+    if (pbcc_history_stream_get(&pb->core, msg)) {
+        return PNR_OK;
+    }
+    if (pbnc_can_start_transaction(pb)) {
+        memset(msg, 0, sizeof *msg);
+        return pb->core.last_result;
+    }
+    return PNR_IN_PROGRESS;
+}
+
+
+/** Waits for the next message from the history stream of @p pb (in
+    the sync interface), calling @p progress to take it.
+ */
+static enum pubnub_res await_history_message(pubnub_t* pb,
+                                             enum pubnub_res (*progress)(pubnub_t*, void*),
+                                             void* data)
+{
+#if defined(PUBNUB_CALLBACK_API)
+    enum pubnub_res rslt;
+
+    pubnub_mutex_lock(pb->monitor);
+    rslt = progress(pb, data);
+    pubnub_mutex_unlock(pb->monitor);
+
+    return rslt;
+#else
+    return pbntf_await_progress(pb, progress, data);
+#endif
+}
+
+
+enum pubnub_res pubnub_history_stream_next(pubnub_t* pb, struct pubnub_history_message* msg)
+{
+    PUBNUB_ASSERT(pb_valid_ctx_ptr(pb));
+    PUBNUB_ASSERT_OPT(msg != NULL);
+
+    return await_history_message(pb, take_history_message, msg);
+}
+
+
+/** Takes the next message of the page on @p pb for the pager */
+static enum pubnub_res take_page_message(pubnub_t* pb, void* elem, bool* o_have)
+{
+    struct pubnub_history_message* msg  = (struct pubnub_history_message*)elem;
+    enum pubnub_res                rslt = take_history_message(pb, msg);
+
+    *o_have = (PNR_OK == rslt) && (msg->message.ptr != NULL);
+
+    return rslt;
+}
+
+
+/** Starts fetching, on the context @p pb, the page of @p pager with
+    messages older than @p start.
+ */
+static enum pubnub_res start_history_page(struct pbpager* pager,
+                                          pubnub_t*       pb,
+                                          char const*     start)
+{
+    struct pubnub_history_pager* hp = (struct pubnub_history_pager*)pager;
+
+    return pubnub_history_stream(pb, hp->channel, pager->page_size, true, start);
+}
+
+
+/** Messages in a page are oldest first, so the next (older) page
+    starts at the time token of the first one.
+ */
+static int history_page_received(struct pbpager* pager, pubnub_t* pb, void const* elem)
+{
+    struct pubnub_history_message const* msg =
+        (struct pubnub_history_message const*)elem;
+
+    PUBNUB_UNUSED(pb);
+    if ((0 == msg->timetoken.size) || (msg->timetoken.size >= sizeof pager->next_start)) {
+        return -1;
+    }
+    memcpy(pager->next_start, msg->timetoken.ptr, msg->timetoken.size);
+    pager->next_start[msg->timetoken.size] = '\0';
+
+    return 0;
+}
+
+
+static struct pbpager_api const m_history_pager_api = {
+    start_history_page,
+    take_page_message,
+    history_page_received,
+    sizeof(struct pubnub_history_message)
+};
+
+
+enum pubnub_res pubnub_history_pager_start(struct pubnub_history_pager* pager,
+                                           pubnub_t*                    pb,
+                                           pubnub_t*                    prefetch_pb,
+                                           char const*                  channel,
+                                           unsigned                     page_size)
+{
+    PUBNUB_ASSERT_OPT(pager != NULL);
+    PUBNUB_ASSERT_OPT(page_size > 0);
+
+    if (page_size > PUBNUB_MAX_HISTORY_COUNT) {
+        PUBNUB_LOG_WARNING("pager=%p: page_size=%u reduced to the maximum of %u\n",
+                           pager,
+                           page_size,
+                           PUBNUB_MAX_HISTORY_COUNT);
+        page_size = PUBNUB_MAX_HISTORY_COUNT;
+    }
+    pager->channel = channel;
+
+    return pbpager_start(&pager->pager, &m_history_pager_api, pb, prefetch_pb, page_size);
+}
+
+
+enum pubnub_res pubnub_history_pager_next(struct pubnub_history_pager* pager,
+                                          struct pubnub_history_message* msg)
+{
+    PUBNUB_ASSERT_OPT(pager != NULL);
+    PUBNUB_ASSERT_OPT(msg != NULL);
+
+    return pbpager_next(&pager->pager, msg);
+}
+
+
+void pubnub_history_pager_stop(struct pubnub_history_pager* pager)
+{
+    PUBNUB_ASSERT_OPT(pager != NULL);
+
+    pbpager_stop(&pager->pager);
+}
+
 #endif /* PUBNUB_USE_ADVANCED_HISTORY */
@@ -3,6 +3,8 @@
 #define INC_PUBNUB_ADVANCED_HISTORY
 
 #include "pbcc_advanced_history.h"
+#include "pubnub_helper.h"
+#include "pbpager.h"
 
 /** Structure containing channel name as char memory block and field with
     message count for messages received on the channel since given point in time
@@ -46,6 +48,24 @@ int pubnub_get_chan_msg_counts(pubnub_t* pb,
                                size_t* io_count, 
                                struct pubnub_chan_msg_count* chan_msg_counters);
 
+/** Returns the next "counter per channel" from the response, without
+    copying anything: the channel name points into the response and
+    is valid until the next transaction is started on @p pb. Call it
+    until the channel name `ptr` is NULL, which means there are no
+    more counters (or a transaction is in progress). The counters
+    returned are not available to pubnub_get_chan_msg_counts() and
+    pubnub_get_message_counts() any more.
+
+    @code
+    struct pubnub_chan_msg_count counter = pubnub_get_chan_msg_count(pb);
+    for (; counter.channel.ptr != NULL; counter = pubnub_get_chan_msg_count(pb)) {
+        printf("%.*s: %zu\n", (int)counter.channel.size, counter.channel.ptr,
+               counter.message_count);
+    }
+    @endcode
+ */
+struct pubnub_chan_msg_count pubnub_get_chan_msg_count(pubnub_t* pb);
+
 /** Array dimension for @p o_count is the number of channels from channel list
     @p channel and it('o_count' array) has to be provided by the user.
     Message counts order in `o_count` is corresponding to channel order in `channel`
@@ -59,5 +79,102 @@ int pubnub_get_chan_msg_counts(pubnub_t* pb,
   */
 int pubnub_get_message_counts(pubnub_t* pb, char const*channel, int* o_count);
 
+/** Starts a "streamed" history transaction on the context @p pb: it
+    gets the history of @p channel (at most @p count messages, with
+    their time tokens if @p include_token), like pubnub_history()
+    does, but the messages are taken with pubnub_history_stream_next()
+    as the response arrives, instead of waiting for all of it.
+
+    In the sync interface, only the messages received but not yet
+    taken are kept (see #PUBNUB_HISTORY_STREAM_MAX_PENDING), so the
+    memory used doesn't depend on the size of the response. For that,
+    the response is not compressed. In the callback interface, the
+    response is received whole, as usual, and then streamed.
+
+    @param pb The Pubnub context
+    @param channel The channel to get the history of
+    @param count Maximum number of messages to get
+    @param include_token Whether to get the time tokens of the messages
+    @param start If not NULL, get only messages older than this time
+    token
+    @retval PNR_STARTED transaction started
+    @retval PNR_IN_PROGRESS can't start, a transaction is in progress
+    @retval PNR_OUT_OF_MEMORY can't allocate the history stream
+    @retval otherwise, as for any other transaction
+ */
+enum pubnub_res pubnub_history_stream(pubnub_t*   pb,
+                                      char const* channel,
+                                      unsigned    count,
+                                      bool        include_token,
+                                      char const* start);
+
+/** Takes the next message from the history stream on the context
+    @p pb (started by pubnub_history_stream()), putting it in @p msg.
+    The message is valid until the next call of this function on @p pb.
+
+    In the sync interface, this waits (driving the transaction) until
+    a message arrives or the transaction ends. In the callback
+    interface, it doesn't wait.
+
+    @retval PNR_OK @p msg has the message or, if `msg->message.ptr` is
+    NULL, there are no more messages
+    @retval PNR_IN_PROGRESS (callback interface only) no message yet,
+    try again later
+    @retval otherwise the transaction failed, after all the messages
+    received before the failure were taken
+ */
+enum pubnub_res pubnub_history_stream_next(pubnub_t* pb, struct pubnub_history_message* msg);
+
+
+/** Gets the whole history of a channel, page by page (newest page
+    first), prefetching the next page while the current one is read.
+    Uses two contexts, alternately: while the messages of a page are
+    taken from one, the next page is being fetched on the other. Both
+    contexts have to be initialized, and not used by anything else
+    while paging. The members are internal, use the
+    pubnub_history_pager_*() functions.
+ */
+struct pubnub_history_pager {
+    /** The part common to all pagers, has to be the first member */
+    struct pbpager pager;
+    /** The channel to get the history of */
+    char const* channel;
+};
+
+/** Starts getting the history of @p channel, @p page_size messages
+    per page, with @p pager, using the contexts @p pb and
+    @p prefetch_pb. The time tokens of the messages are always
+    requested, as they are needed to fetch the next page. A
+    @p page_size larger than #PUBNUB_MAX_HISTORY_COUNT is reduced
+    to it.
+
+    In the sync interface, both contexts use non-blocking I/O (see
+    pubnub_set_non_blocking_io()) until the pager is stopped, or the
+    last page is done, when the I/O mode they had before is restored.
+    That way, the next page is read in the background while the
+    messages of the current one are taken, at the price of polling
+    the sockets while waiting.
+    @return The result of starting the history stream for the first
+    page, on @p pb
+ */
+enum pubnub_res pubnub_history_pager_start(struct pubnub_history_pager* pager,
+                                           pubnub_t*                    pb,
+                                           pubnub_t*                    prefetch_pb,
+                                           char const*                  channel,
+                                           unsigned                     page_size);
+
+/** Takes the next message from @p pager, putting it in @p msg. Same as
+    pubnub_history_stream_next(), just going from page to page: only
+    when the last page is done does it report there are no more
+    messages.
+ */
+enum pubnub_res pubnub_history_pager_next(struct pubnub_history_pager* pager,
+                                          struct pubnub_history_message* msg);
+
+/** Stops @p pager, cancelling the transactions it has in progress,
+    and restoring the I/O mode of its contexts.
+ */
+void pubnub_history_pager_stop(struct pubnub_history_pager* pager);
+
 
 #endif /* !defined INC_PUBNUB_ADVANCED_HISTORY */
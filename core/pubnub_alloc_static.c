@@ -3,12 +3,37 @@
 #include "pubnub_auto_heartbeat.h"
 #include "pubnub_assert.h"
 #include "pubnub_log.h"
+#include "pbmem.h"
 
 #include "pbpal.h"
 
+#include <string.h>
+
+
+#if PUBNUB_DYNAMIC_HTTP_BUFFER
+#error Dynamic HTTP buffer (PUBNUB_DYNAMIC_HTTP_BUFFER) needs dynamic allocation of contexts (pubnub_alloc_std.c)
+#endif
 
 static struct pubnub_ m_aCtx[PUBNUB_CTX_MAX];
 
+/** Marks the end of the free list */
+#define PBALLOC_NO_SLOT PUBNUB_CTX_MAX
+
+/** Free list of context slots: for every free slot, the index of the
+    next free slot (or PBALLOC_NO_SLOT). Has no meaning for slots in
+    use.
+ */
+static unsigned m_free_next[PUBNUB_CTX_MAX];
+
+/** Index of the first free slot, PBALLOC_NO_SLOT if all are in use */
+static unsigned m_free_head;
+
+/** Whether the free list was set up (lazily, on first allocation) */
+static bool m_free_list_ready;
+
+/** Guards the free list */
+pubnub_mutex_static_decl_and_init(m_lock);
+
 
 bool pb_valid_ctx_ptr(pubnub_t const *pb)
 {
@@ -25,21 +50,57 @@ pubnub_t *pballoc_get_ctx(unsigned idx)
 }
 
 
-pubnub_t *pubnub_alloc(void)
+/** Puts all the slots, in order, to the free list. Must be called
+    with the lock held. */
+static void free_list_setup(void)
 {
-    size_t i;
+    unsigned i;
 
     for (i = 0; i < PUBNUB_CTX_MAX; ++i) {
-        pubnub_mutex_lock(m_aCtx[i].monitor);
-        if (m_aCtx[i].state == PBS_NULL) {
-            m_aCtx[i].state = PBS_IDLE;
-            pubnub_mutex_unlock(m_aCtx[i].monitor);
-            return m_aCtx + i;
-        }
-        pubnub_mutex_unlock(m_aCtx[i].monitor);
+        m_free_next[i] = i + 1;
     }
+    m_free_head       = 0;
+    m_free_list_ready = true;
+}
 
-    return NULL;
+
+pubnub_t *pubnub_alloc(void)
+{
+    pubnub_t *pb = NULL;
+
+    pubnub_mutex_init_static(m_lock);
+    pubnub_mutex_lock(m_lock);
+    if (!m_free_list_ready) {
+        free_list_setup();
+    }
+    if (m_free_head != PBALLOC_NO_SLOT) {
+        pb          = m_aCtx + m_free_head;
+        m_free_head = m_free_next[m_free_head];
+        PUBNUB_ASSERT_OPT(pb->state == PBS_NULL);
+        pb->state = PBS_IDLE;
+#if PUBNUB_MEMORY_STATS
+        memset(&pb->core.memory, 0, sizeof pb->core.memory);
+#endif
+#if PUBNUB_PROXY_API
+        pb->proxy_saved_path      = NULL;
+        pb->proxy_saved_path_size = 0;
+#endif
+    }
+    pubnub_mutex_unlock(m_lock);
+
+    return pb;
+}
+
+
+/** Puts the slot of @p pb back to (the front of) the free list */
+static void release_slot(pubnub_t *pb)
+{
+    unsigned idx = (unsigned)(pb - m_aCtx);
+
+    pubnub_mutex_lock(m_lock);
+    m_free_next[idx] = m_free_head;
+    m_free_head      = idx;
+    pubnub_mutex_unlock(m_lock);
 }
 
 
@@ -52,9 +113,13 @@ void pballoc_free_at_last(pubnub_t *pb)
     PUBNUB_ASSERT_OPT(pb->state == PBS_NULL);
 
     pbcc_deinit(&pb->core);
+#if PUBNUB_PROXY_API
+    pbmem_free(pb->proxy_saved_path);
+#endif
     pbpal_free(pb);
     pubnub_mutex_unlock(pb->monitor);
     pubnub_mutex_destroy(pb->monitor);
+    release_slot(pb);
 }
 
 
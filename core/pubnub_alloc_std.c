@@ -2,6 +2,7 @@
 #include "pubnub_internal.h"
 #include "pubnub_auto_heartbeat.h"
 #include "pubnub_assert.h"
+#include "pbmem.h"
 #include "pubnub_log.h"
 
 #include "pbpal.h"
@@ -10,72 +11,145 @@
 #include <string.h>
 
 
-#if defined       PUBNUB_ASSERT_LEVEL_EX
-static pubnub_t** m_allocated;
-static unsigned   m_n;
-static unsigned   m_cap;
 pubnub_mutex_static_decl_and_init(m_lock);
-#endif
 
 
-static void save_allocated(pubnub_t* pb)
+#if defined PUBNUB_ASSERT_LEVEL_EX
+/** Number of contexts in a slab */
+#define PBALLOC_SLAB_SIZE 32
+
+/** Value of the tag of a slot that holds an allocated context */
+#define PBALLOC_SLOT_IN_USE 0x5ba1107eu
+
+/** A slot for one context. The slot of an allocated context is
+    tagged, so checking if a context pointer is valid only has to
+    find the slab the pointer is in, not search all the contexts.
+ */
+struct pballoc_slot {
+    /** The context. Must be the first member, so that a pointer to
+        the context is also a pointer to its slot. */
+    pubnub_t pb;
+    /** #PBALLOC_SLOT_IN_USE while the context is allocated */
+    unsigned volatile tag;
+    /** Next slot in the free list, if this one is free */
+    struct pballoc_slot* next_free;
+};
+
+/** Contexts are allocated in slabs of slots. Slabs are never
+    released, so checking a stale context pointer (one that was
+    freed) reads memory that is still ours.
+ */
+struct pballoc_slab {
+    struct pballoc_slab* next;
+    struct pballoc_slot  slot[PBALLOC_SLAB_SIZE];
+};
+
+static struct pballoc_slab* m_slabs;
+static struct pballoc_slot* m_free;
+
+
+/** Takes a slot from the free list, adding a new slab if there are
+    no free slots. Must be called with the lock held.
+ */
+static struct pballoc_slot* take_slot(void)
+{
+    struct pballoc_slot* slot;
+
+    if (NULL == m_free) {
+        size_t               i;
+        struct pballoc_slab* slab = (struct pballoc_slab*)pbmem_alloc(
+            NULL, pbmemcatContext, sizeof *slab);
+        if (NULL == slab) {
+            return NULL;
+        }
+        for (i = PBALLOC_SLAB_SIZE; i > 0; --i) {
+            slab->slot[i - 1].tag       = 0;
+            slab->slot[i - 1].next_free = m_free;
+            m_free                      = &slab->slot[i - 1];
+        }
+        slab->next = m_slabs;
+        m_slabs    = slab;
+    }
+    slot      = m_free;
+    m_free    = slot->next_free;
+    slot->tag = PBALLOC_SLOT_IN_USE;
+
+    return slot;
+}
+
+
+/** Puts the slot of the context @p pb back to the free list. Must be
+    called with the lock held.
+ */
+static void release_slot(pubnub_t* pb)
+{
+    struct pballoc_slot* slot = (struct pballoc_slot*)pb;
+
+    slot->tag       = 0;
+    slot->next_free = m_free;
+    m_free          = slot;
+}
+#endif /* defined PUBNUB_ASSERT_LEVEL_EX */
+
+
+static pubnub_t* alloc_ctx(void)
 {
 #if defined PUBNUB_ASSERT_LEVEL_EX
+    struct pballoc_slot* slot;
+
     pubnub_mutex_init_static(m_lock);
     pubnub_mutex_lock(m_lock);
-    if (m_n == m_cap) {
-        pubnub_t** npalloc =
-            (pubnub_t**)realloc(m_allocated, sizeof m_allocated[0] * (m_n + 1));
-        if (NULL == npalloc) {
-            PUBNUB_LOG_WARNING("Couldn't allocate memory for pubnub_alloc_std bookkeeping");
-            pubnub_mutex_unlock(m_lock);
-            return;
-        }
-        m_allocated        = npalloc;
-        m_allocated[m_n++] = pb;
-        m_cap              = m_n;
-    }
-    else {
-        m_allocated[m_n++] = pb;
-    }
+    slot = take_slot();
     pubnub_mutex_unlock(m_lock);
+
+    return (NULL == slot) ? NULL : &slot->pb;
+#else
+    return (pubnub_t*)pbmem_alloc(NULL, pbmemcatContext, sizeof(pubnub_t));
 #endif
 }
 
 
-static void remove_allocated(pubnub_t* pb)
+/** Frees the context @p pb. In "extra" assert mode, must be called
+    with the lock held.
+ */
+static void free_ctx(pubnub_t* pb)
 {
 #if defined PUBNUB_ASSERT_LEVEL_EX
-    size_t i;
-    for (i = 0; i < m_n; ++i) {
-        if (m_allocated[i] == pb) {
-            if (i != m_n - 1) {
-                memmove(m_allocated + i,
-                        m_allocated + i + 1,
-                        sizeof m_allocated[0] * (m_n - i - 1));
-            }
-            if (0 == --m_n) {
-                free(m_allocated);
-                m_allocated = NULL;
-                m_cap = 0;
-            }
-            break;
-        }
-    }
+    release_slot(pb);
+#else
+    pbmem_free(pb);
 #endif
 }
 
 
-static bool check_ctx_ptr(pubnub_t const* pb)
-{
 #if defined PUBNUB_ASSERT_LEVEL_EX
-    size_t i;
-    for (i = 0; i < m_n; ++i) {
-        if (m_allocated[i] == pb) {
-            return true;
+/** Returns true if @p pb points to the start of a slot in one of the
+    slabs, so that its tag can be read.
+ */
+static bool is_slot(pubnub_t const* pb)
+{
+    struct pballoc_slab const* slab;
+
+    for (slab = m_slabs; slab != NULL; slab = slab->next) {
+        char const* first = (char const*)slab->slot;
+        char const* end   = (char const*)(slab->slot + PBALLOC_SLAB_SIZE);
+        if (((char const*)pb >= first) && ((char const*)pb < end)) {
+            return 0 == ((char const*)pb - first) % sizeof(struct pballoc_slot);
         }
     }
     return false;
+}
+#endif /* defined PUBNUB_ASSERT_LEVEL_EX */
+
+
+static bool check_ctx_ptr(pubnub_t const* pb)
+{
+#if defined PUBNUB_ASSERT_LEVEL_EX
+    /* This doesn't need the lock, as slabs are linked only when
+       initialized and never released, and a context freed while
+       being checked is a bug of the user anyway */
+    return (pb != NULL) && is_slot(pb)
+           && (((struct pballoc_slot const*)pb)->tag == PBALLOC_SLOT_IN_USE);
 #else
     return pb != NULL;
 #endif
@@ -84,27 +158,53 @@ static bool check_ctx_ptr(pubnub_t const* pb)
 
 bool pb_valid_ctx_ptr(pubnub_t const* pb)
 {
-#if defined PUBNUB_ASSERT_LEVEL_EX
-    bool result;
+    return check_ctx_ptr(pb);
+}
 
-    pubnub_mutex_init_static(m_lock);
-    pubnub_mutex_lock(m_lock);
-    result = check_ctx_ptr(pb);
-    pubnub_mutex_unlock(m_lock);
 
-    return result;
-#else
-    return pb != NULL;
+#if PUBNUB_DYNAMIC_HTTP_BUFFER
+/** Allocates the HTTP buffer of the context @p pb, of the default
+    size (#PUBNUB_BUF_MAXLEN). Other buffers are allocated on first
+    use.
+ */
+static int alloc_buffers(pubnub_t* pb)
+{
+    pb->core.http_buf      = NULL;
+    pb->core.http_buf_size = 0;
+#if PUBNUB_CRYPTO_API
+    pb->core.encrypted_msg_buf = NULL;
+#endif
+#if PUBNUB_USE_GZIP_COMPRESSION
+    pb->core.gzip_msg_buf = NULL;
 #endif
+    return pbcc_set_http_buf_size(&pb->core, PUBNUB_BUF_MAXLEN);
 }
+#endif /* PUBNUB_DYNAMIC_HTTP_BUFFER */
 
 
 pubnub_t* pubnub_alloc(void)
 {
-    pubnub_t* pb = (pubnub_t*)malloc(sizeof(pubnub_t));
-    if (pb != NULL) {
-        save_allocated(pb);
+    pubnub_t* pb = alloc_ctx();
+    if (NULL == pb) {
+        return NULL;
     }
+#if PUBNUB_MEMORY_STATS
+    memset(&pb->core.memory, 0, sizeof pb->core.memory);
+#endif
+#if PUBNUB_PROXY_API
+    pb->proxy_saved_path      = NULL;
+    pb->proxy_saved_path_size = 0;
+#endif
+#if PUBNUB_DYNAMIC_HTTP_BUFFER
+    if (0 != alloc_buffers(pb)) {
+        PUBNUB_LOG_ERROR("Couldn't allocate the HTTP buffer of the context\n");
+        pubnub_mutex_init_static(m_lock);
+        pubnub_mutex_lock(m_lock);
+        free_ctx(pb);
+        pubnub_mutex_unlock(m_lock);
+        return NULL;
+    }
+#endif
     return pb;
 }
 
@@ -124,12 +224,14 @@ void pballoc_free_at_last(pubnub_t* pb)
     PUBNUB_ASSERT_OPT(pb->state == PBS_NULL);
 
     pbcc_deinit(&pb->core);
+#if PUBNUB_PROXY_API
+    pbmem_free(pb->proxy_saved_path);
+#endif
     pbpal_free(pb);
-    remove_allocated(pb);
     pubnub_mutex_unlock(pb->monitor);
     pubnub_mutex_destroy(pb->monitor);
+    free_ctx(pb);
     pubnub_mutex_unlock(m_lock);
-    free(pb);
 }
 
 
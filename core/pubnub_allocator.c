@@ -0,0 +1,413 @@
+/* -*- c-file-style:"stroustrup"; indent-tabs-mode: nil -*- */
+#include "pubnub_internal.h"
+
+#include "pubnub_allocator.h"
+#include "pubnub_memory_stats.h"
+#include "pbmem.h"
+#include "pubnub_mutex.h"
+#include "pubnub_assert.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+
+static void* std_allocate(size_t size, void* user)
+{
+    PUBNUB_UNUSED(user);
+    return malloc(size);
+}
+
+
+static void* std_reallocate(void* ptr, size_t size, void* user)
+{
+    PUBNUB_UNUSED(user);
+    return realloc(ptr, size);
+}
+
+
+static void std_deallocate(void* ptr, void* user)
+{
+    PUBNUB_UNUSED(user);
+    free(ptr);
+}
+
+
+/** The allocator in use */
+static struct pubnub_allocator m_allocator = {
+    std_allocate, std_reallocate, std_deallocate, NULL
+};
+
+
+int pubnub_set_allocator(struct pubnub_allocator const* allocator)
+{
+    if (NULL == allocator) {
+        m_allocator.allocate   = std_allocate;
+        m_allocator.reallocate = std_reallocate;
+        m_allocator.deallocate = std_deallocate;
+        m_allocator.user       = NULL;
+        return 0;
+    }
+    if ((NULL == allocator->allocate) || (NULL == allocator->reallocate)
+        || (NULL == allocator->deallocate)) {
+        return -1;
+    }
+    m_allocator = *allocator;
+
+    return 0;
+}
+
+
+void pubnub_free_memory(void* ptr)
+{
+    pbmem_free_user(ptr);
+}
+
+
+void* pbmem_alloc_user(size_t size)
+{
+    return m_allocator.allocate(size, m_allocator.user);
+}
+
+
+void pbmem_free_user(void* ptr)
+{
+    m_allocator.deallocate(ptr, m_allocator.user);
+}
+
+
+#if PUBNUB_MEMORY_STATS
+
+/** Put in front of every allocated memory block, to know where
+    it is accounted for when it is freed or resized.
+ */
+union pbmem_header {
+    struct {
+        /** The account of the context, NULL if none */
+        struct pbmem_account* account;
+        /** Previous and next memory block in the list of the blocks
+            of the @p account */
+        union pbmem_header* prev;
+        union pbmem_header* next;
+        /** Size of the memory block, without the header */
+        size_t size;
+        /** The category the memory is accounted for */
+        enum pubnub_memory_category category;
+    } h;
+    /* The rest are here just to align the memory after the header */
+    long double align_ld;
+    long long   align_ll;
+    void*       align_p;
+};
+
+/** The process-wide memory report */
+static struct pubnub_memory_report m_global;
+
+/** Guards the process-wide memory report and all the context
+    accounts */
+pubnub_mutex_static_decl_and_init(m_stats_lock);
+
+
+static void usage_add(struct pubnub_memory_usage* usage, size_t size)
+{
+    usage->current += size;
+    if (usage->current > usage->peak) {
+        usage->peak = usage->current;
+    }
+}
+
+
+static void report_update(struct pubnub_memory_report* report,
+                          enum pubnub_memory_category  category,
+                          size_t                       freed,
+                          size_t                       allocated)
+{
+    PUBNUB_ASSERT_OPT(report->category[category].current >= freed);
+    report->category[category].current -= freed;
+    report->total.current -= freed;
+    usage_add(&report->category[category], allocated);
+    usage_add(&report->total, allocated);
+}
+
+
+/** Puts the memory block with the header @p hdr to the list of its
+    account, if it has one. Call with the stats lock held. */
+static void link_block(union pbmem_header* hdr)
+{
+    struct pbmem_account* account = hdr->h.account;
+
+    hdr->h.prev = NULL;
+    if (NULL == account) {
+        hdr->h.next = NULL;
+        return;
+    }
+    hdr->h.next = account->blocks;
+    if (account->blocks != NULL) {
+        account->blocks->h.prev = hdr;
+    }
+    account->blocks = hdr;
+}
+
+
+/** Takes the memory block with the header @p hdr out of the list of
+    its account, if it has one. Call with the stats lock held. */
+static void unlink_block(union pbmem_header* hdr)
+{
+    if (NULL == hdr->h.account) {
+        return;
+    }
+    if (hdr->h.prev != NULL) {
+        hdr->h.prev->h.next = hdr->h.next;
+    }
+    else {
+        hdr->h.account->blocks = hdr->h.next;
+    }
+    if (hdr->h.next != NULL) {
+        hdr->h.next->h.prev = hdr->h.prev;
+    }
+}
+
+
+/** Updates the reports for the memory block with the header @p hdr
+    that had @p freed bytes and now has @p allocated bytes. Call with
+    the stats lock held.
+ */
+static void update_reports(union pbmem_header const* hdr, size_t freed, size_t allocated)
+{
+    report_update(&m_global, hdr->h.category, freed, allocated);
+    if (hdr->h.account != NULL) {
+        report_update(&hdr->h.account->report, hdr->h.category, freed, allocated);
+    }
+}
+
+
+void* pbmem_alloc(struct pbmem_account*       account,
+                  enum pubnub_memory_category category,
+                  size_t                      size)
+{
+    union pbmem_header* hdr;
+
+    PUBNUB_ASSERT_OPT(category < pbmemcatCount);
+    if (size > (size_t)-1 - sizeof *hdr) {
+        return NULL;
+    }
+    hdr = (union pbmem_header*)m_allocator.allocate(sizeof *hdr + size,
+                                                    m_allocator.user);
+    if (NULL == hdr) {
+        return NULL;
+    }
+    hdr->h.account  = account;
+    hdr->h.size     = size;
+    hdr->h.category = category;
+    pubnub_mutex_init_static(m_stats_lock);
+    pubnub_mutex_lock(m_stats_lock);
+    link_block(hdr);
+    update_reports(hdr, 0, size);
+    pubnub_mutex_unlock(m_stats_lock);
+
+    return hdr + 1;
+}
+
+
+void* pbmem_realloc(struct pbmem_account*       account,
+                    enum pubnub_memory_category category,
+                    void*                       ptr,
+                    size_t                      size)
+{
+    union pbmem_header* hdr;
+    union pbmem_header* newhdr;
+
+    if (NULL == ptr) {
+        return pbmem_alloc(account, category, size);
+    }
+    if (size > (size_t)-1 - sizeof *hdr) {
+        return NULL;
+    }
+    hdr = (union pbmem_header*)ptr - 1;
+    PUBNUB_ASSERT_OPT(hdr->h.category == category);
+    /* The block may move, so it's out of the list while resized, and
+       the list is not to be walked until it's back in */
+    pubnub_mutex_init_static(m_stats_lock);
+    pubnub_mutex_lock(m_stats_lock);
+    unlink_block(hdr);
+    newhdr = (union pbmem_header*)m_allocator.reallocate(
+        hdr, sizeof *hdr + size, m_allocator.user);
+    if (NULL == newhdr) {
+        link_block(hdr);
+        pubnub_mutex_unlock(m_stats_lock);
+        return NULL;
+    }
+    link_block(newhdr);
+    update_reports(newhdr, newhdr->h.size, size);
+    newhdr->h.size = size;
+    pubnub_mutex_unlock(m_stats_lock);
+
+    return newhdr + 1;
+}
+
+
+void pbmem_free(void* ptr)
+{
+    union pbmem_header* hdr;
+
+    if (NULL == ptr) {
+        return;
+    }
+    hdr = (union pbmem_header*)ptr - 1;
+    pubnub_mutex_init_static(m_stats_lock);
+    pubnub_mutex_lock(m_stats_lock);
+    unlink_block(hdr);
+    update_reports(hdr, hdr->h.size, 0);
+    pubnub_mutex_unlock(m_stats_lock);
+    m_allocator.deallocate(hdr, m_allocator.user);
+}
+
+
+void pbmem_reassign(void*                       ptr,
+                    struct pbmem_account*       account,
+                    enum pubnub_memory_category category)
+{
+    union pbmem_header* hdr;
+
+    PUBNUB_ASSERT_OPT(category < pbmemcatCount);
+    if (NULL == ptr) {
+        return;
+    }
+    hdr = (union pbmem_header*)ptr - 1;
+    pubnub_mutex_init_static(m_stats_lock);
+    pubnub_mutex_lock(m_stats_lock);
+    unlink_block(hdr);
+    update_reports(hdr, hdr->h.size, 0);
+    hdr->h.account  = account;
+    hdr->h.category = category;
+    link_block(hdr);
+    update_reports(hdr, 0, hdr->h.size);
+    pubnub_mutex_unlock(m_stats_lock);
+}
+
+
+void pbmem_account_detach(struct pbmem_account* account)
+{
+    union pbmem_header* hdr;
+
+    if (NULL == account) {
+        return;
+    }
+    pubnub_mutex_init_static(m_stats_lock);
+    pubnub_mutex_lock(m_stats_lock);
+    for (hdr = account->blocks; hdr != NULL; hdr = hdr->h.next) {
+        report_update(&account->report, hdr->h.category, hdr->h.size, 0);
+        hdr->h.account = NULL;
+        hdr->h.prev    = NULL;
+    }
+    account->blocks = NULL;
+    pubnub_mutex_unlock(m_stats_lock);
+}
+
+
+int pubnub_memory_stats(pubnub_t* pb, struct pubnub_memory_report* report)
+{
+    PUBNUB_ASSERT_OPT(pb != NULL);
+    PUBNUB_ASSERT_OPT(report != NULL);
+
+    pubnub_mutex_init_static(m_stats_lock);
+    pubnub_mutex_lock(m_stats_lock);
+    *report = pb->core.memory.report;
+    pubnub_mutex_unlock(m_stats_lock);
+
+    return 0;
+}
+
+
+int pubnub_memory_stats_global(struct pubnub_memory_report* report)
+{
+    PUBNUB_ASSERT_OPT(report != NULL);
+
+    pubnub_mutex_init_static(m_stats_lock);
+    pubnub_mutex_lock(m_stats_lock);
+    *report = m_global;
+    pubnub_mutex_unlock(m_stats_lock);
+
+    return 0;
+}
+
+#else
+
+void* pbmem_alloc(struct pbmem_account*       account,
+                  enum pubnub_memory_category category,
+                  size_t                      size)
+{
+    PUBNUB_UNUSED(account);
+    PUBNUB_UNUSED(category);
+    return m_allocator.allocate(size, m_allocator.user);
+}
+
+
+void* pbmem_realloc(struct pbmem_account*       account,
+                    enum pubnub_memory_category category,
+                    void*                       ptr,
+                    size_t                      size)
+{
+    PUBNUB_UNUSED(account);
+    PUBNUB_UNUSED(category);
+    return m_allocator.reallocate(ptr, size, m_allocator.user);
+}
+
+
+void pbmem_free(void* ptr)
+{
+    m_allocator.deallocate(ptr, m_allocator.user);
+}
+
+
+void pbmem_reassign(void*                       ptr,
+                    struct pbmem_account*       account,
+                    enum pubnub_memory_category category)
+{
+    PUBNUB_UNUSED(ptr);
+    PUBNUB_UNUSED(account);
+    PUBNUB_UNUSED(category);
+}
+
+
+void pbmem_account_detach(struct pbmem_account* account)
+{
+    PUBNUB_UNUSED(account);
+}
+
+
+int pubnub_memory_stats(pubnub_t* pb, struct pubnub_memory_report* report)
+{
+    PUBNUB_UNUSED(pb);
+    PUBNUB_ASSERT_OPT(report != NULL);
+    memset(report, 0, sizeof *report);
+    return -1;
+}
+
+
+int pubnub_memory_stats_global(struct pubnub_memory_report* report)
+{
+    PUBNUB_ASSERT_OPT(report != NULL);
+    memset(report, 0, sizeof *report);
+    return -1;
+}
+
+#endif /* PUBNUB_MEMORY_STATS */
+
+
+void* pbmem_calloc(struct pbmem_account*       account,
+                   enum pubnub_memory_category category,
+                   size_t                      n,
+                   size_t                      size)
+{
+    void* rslt;
+
+    if ((size != 0) && (n > (size_t)-1 / size)) {
+        return NULL;
+    }
+    rslt = pbmem_alloc(account, category, n * size);
+    if (rslt != NULL) {
+        memset(rslt, 0, n * size);
+    }
+
+    return rslt;
+}
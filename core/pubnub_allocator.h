@@ -0,0 +1,59 @@
+/* -*- c-file-style:"stroustrup"; indent-tabs-mode: nil -*- */
+#if !defined INC_PUBNUB_ALLOCATOR
+#define      INC_PUBNUB_ALLOCATOR
+
+#include <stddef.h>
+
+
+/** @file pubnub_allocator.h
+    Pluggable heap allocator. All the heap memory that the Pubnub
+    C-core and its platform modules allocate (contexts, reply
+    buffers, crypto and TLS bookkeeping, auto heartbeat data, the
+    callback poller...) is allocated through the allocator set here.
+    By default, the standard C library is used.
+
+    This does not include the memory that third party libraries
+    (like OpenSSL) allocate on their own.
+ */
+
+
+/** The allocator that Pubnub should use. All three functions have to
+    be set and have the same semantics as their standard C library
+    counterparts (malloc(), realloc() and free()), including the
+    handling of NULL pointers, with @p user passed to each of them.
+ */
+struct pubnub_allocator {
+    /** Allocates @p size bytes, returns NULL on failure */
+    void* (*allocate)(size_t size, void* user);
+    /** Resizes the memory at @p ptr (which may be NULL) to @p size
+        bytes, returns NULL on failure (leaving @p ptr untouched) */
+    void* (*reallocate)(void* ptr, size_t size, void* user);
+    /** Frees the memory at @p ptr (which may be NULL) */
+    void (*deallocate)(void* ptr, void* user);
+    /** User defined data, passed to each of the functions */
+    void* user;
+};
+
+
+/** Sets the allocator for Pubnub to use. As memory allocated with one
+    allocator can't be freed with another, this should be called
+    before any other Pubnub function, and not while any Pubnub
+    context exists. It is not thread-safe.
+
+    @param allocator The allocator to use (it is copied), if NULL,
+    the standard C library will be used
+    @retval 0 allocator set
+    @retval -1 invalid allocator (some of the functions not set),
+    nothing changed
+ */
+int pubnub_set_allocator(struct pubnub_allocator const* allocator);
+
+/** Frees the memory which Pubnub allocated and gave to the user, like
+    the memory block returned by pubnub_get_decrypted_alloc(). Such
+    memory must be freed with this function (instead of free()) if
+    an allocator was set with pubnub_set_allocator().
+ */
+void pubnub_free_memory(void* ptr);
+
+
+#endif /* !defined INC_PUBNUB_ALLOCATOR */
@@ -6,6 +6,7 @@
 #include "pubnub_pubsubapi.h"
 #include "pubnub_mutex.h"
 #include "pubnub_assert.h"
+#include "pbmem.h"
 #include "pubnub_log.h"
 
 
@@ -66,7 +67,8 @@ pubnub_subloop_t* pubnub_subloop_define(pubnub_t*                       p,
                                         struct pubnub_subscribe_options options,
                                         pubnub_subloop_callback_t       cb)
 {
-    pubnub_subloop_t* rslt = (pubnub_subloop_t*)malloc(sizeof(pubnub_subloop_t));
+    pubnub_subloop_t* rslt = (pubnub_subloop_t*)pbmem_alloc(
+        NULL, pbmemcatContext, sizeof(pubnub_subloop_t));
     if (NULL == rslt) {
         return NULL;
     }
@@ -134,5 +136,5 @@ void pubnub_subloop_undef(pubnub_subloop_t* pbsld)
     pubnub_mutex_unlock(pbsld->monitor);
     pubnub_mutex_destroy(pbsld->monitor);
 
-    free(pbsld);
+    pbmem_free(pbsld);
 }
@@ -6,6 +6,9 @@
 #include "pubnub_internal.h"
 #include "pubnub_json_parse.h"
 #include "pubnub_log.h"
+#if PUBNUB_USE_ADVANCED_HISTORY
+#include "pbcc_advanced_history.h"
+#endif
 
 #include <stdio.h>
 
@@ -39,6 +42,11 @@ enum pubnub_res pbcc_parse_time_response(struct pbcc_context* p)
 
 enum pubnub_res pbcc_parse_history_response(struct pbcc_context* p)
 {
+#if PUBNUB_USE_ADVANCED_HISTORY
+    if (pbcc_history_stream_requested(p)) {
+        return pbcc_parse_history_stream_response(p);
+    }
+#endif
     return simple_parse_response(p);
 }
 
@@ -110,16 +118,17 @@ enum pubnub_res pbcc_leave_prep(struct pbcc_context* pb,
     pb->http_content_len = 0;
 
     /* Make sure next subscribe() will be a join. */
-    pb->timetoken[0] = '0';
-    pb->timetoken[1] = '\0';
+    pb->timetoken[0]  = '0';
+    pb->timetoken[1]  = '\0';
+    pb->timetoken_u64 = 0;
 
     pb->http_buf_len = snprintf(pb->http_buf,
-                                sizeof pb->http_buf,
+                                PBCC_HTTP_BUF_SIZE(pb),
                                 "/v2/presence/sub-key/%s/channel/",
                                 pb->subscribe_key);
     APPEND_URL_ENCODED_M(pb, channel);
     pb->http_buf_len += snprintf(pb->http_buf + pb->http_buf_len,
-                                 sizeof pb->http_buf - pb->http_buf_len,
+                                 PBCC_HTTP_BUF_SIZE(pb) - pb->http_buf_len,
                                  "/leave?pnsdk=%s",
                                  pubnub_uname());
     APPEND_URL_PARAM_M(pb, "channel-group", channel_group, '&');
@@ -142,7 +151,7 @@ enum pubnub_res pbcc_time_prep(struct pbcc_context* pb)
     pb->msg_ofs = pb->msg_end = 0;
 
     pb->http_buf_len = snprintf(
-        pb->http_buf, sizeof pb->http_buf, "/time/0?pnsdk=%s", pubnub_uname());
+        pb->http_buf, PBCC_HTTP_BUF_SIZE(pb), "/time/0?pnsdk=%s", pubnub_uname());
     APPEND_URL_PARAM_M(pb, "uuid", uuid, '&');
     APPEND_URL_PARAM_M(pb, "auth", pb->auth, '&');
 
@@ -168,9 +177,12 @@ enum pubnub_res pbcc_history_prep(struct pbcc_context* pb,
 
     pb->http_content_len = 0;
     pb->msg_ofs = pb->msg_end = 0;
+#if PUBNUB_USE_ADVANCED_HISTORY
+    pbcc_history_stream_reset(pb);
+#endif
 
     pb->http_buf_len = snprintf(pb->http_buf,
-                                sizeof pb->http_buf,
+                                PBCC_HTTP_BUF_SIZE(pb),
                                 "/v2/history/sub-key/%s/channel/",
                                 pb->subscribe_key);
     APPEND_URL_ENCODED_M(pb, channel);
@@ -182,7 +194,7 @@ enum pubnub_res pbcc_history_prep(struct pbcc_context* pb,
     APPEND_URL_PARAM_TRIBOOL_SIMBOL_M(pb, "reverse", reverse, '&');
     APPEND_URL_PARAM_TRIBOOL_SIMBOL_M(pb, "include_meta", include_meta, '&');
     APPEND_URL_PARAM_M(pb, "start", start, '&');
-    APPEND_URL_PARAM_M(pb, "start", end, '&');
+    APPEND_URL_PARAM_M(pb, "end", end, '&');
 
     return PNR_STARTED;
 }
@@ -208,12 +220,12 @@ enum pubnub_res pbcc_heartbeat_prep(struct pbcc_context* pb,
     pb->msg_ofs = pb->msg_end = 0;
 
     pb->http_buf_len = snprintf(pb->http_buf,
-                                sizeof pb->http_buf,
+                                PBCC_HTTP_BUF_SIZE(pb),
                                 "/v2/presence/sub-key/%s/channel/",
                                 pb->subscribe_key);
     APPEND_URL_ENCODED_M(pb, channel);
     pb->http_buf_len  += snprintf(pb->http_buf + pb->http_buf_len,
-                                  sizeof pb->http_buf - pb->http_buf_len,
+                                  PBCC_HTTP_BUF_SIZE(pb) - pb->http_buf_len,
                                   "/heartbeat?pnsdk=%s",
                                   pubnub_uname());
     APPEND_URL_PARAM_M(pb, "channel-group", channel_group, '&');
@@ -246,7 +258,7 @@ enum pubnub_res pbcc_here_now_prep(struct pbcc_context* pb,
     pb->msg_ofs = pb->msg_end = 0;
 
     pb->http_buf_len = snprintf(pb->http_buf,
-                                sizeof pb->http_buf,
+                                PBCC_HTTP_BUF_SIZE(pb),
                                 "/v2/presence/sub-key/%s%s",
                                 pb->subscribe_key,
                                 channel ? "/channel/" : "");
@@ -274,7 +286,7 @@ enum pubnub_res pbcc_where_now_prep(struct pbcc_context* pb, const char* uuid)
     pb->msg_ofs = pb->msg_end = 0;
 
     pb->http_buf_len = snprintf(pb->http_buf,
-                                sizeof pb->http_buf,
+                                PBCC_HTTP_BUF_SIZE(pb),
                                 "/v2/presence/sub-key/%s/uuid/%s?pnsdk=%s",
                                 pb->subscribe_key,
                                 uuid,
@@ -304,12 +316,12 @@ enum pubnub_res pbcc_set_state_prep(struct pbcc_context* pb,
     }
 
     pb->http_buf_len = snprintf(pb->http_buf,
-                                sizeof pb->http_buf,
+                                PBCC_HTTP_BUF_SIZE(pb),
                                 "/v2/presence/sub-key/%s/channel/",
                                 pb->subscribe_key);
     APPEND_URL_ENCODED_M(pb, channel);
     pb->http_buf_len += snprintf(pb->http_buf + pb->http_buf_len,
-                                 sizeof pb->http_buf - pb->http_buf_len,
+                                 PBCC_HTTP_BUF_SIZE(pb) - pb->http_buf_len,
                                  "/uuid/%s/data?pnsdk=%s&state=%s",
                                  uuid,
                                  pubnub_uname(),
@@ -339,12 +351,12 @@ enum pubnub_res pbcc_state_get_prep(struct pbcc_context* pb,
     }
 
     pb->http_buf_len = snprintf(pb->http_buf,
-                                sizeof pb->http_buf,
+                                PBCC_HTTP_BUF_SIZE(pb),
                                 "/v2/presence/sub-key/%s/channel/",
                                 pb->subscribe_key);
     APPEND_URL_ENCODED_M(pb, channel);
     pb->http_buf_len += snprintf(pb->http_buf + pb->http_buf_len,
-                                 sizeof pb->http_buf - pb->http_buf_len,
+                                 PBCC_HTTP_BUF_SIZE(pb) - pb->http_buf_len,
                                  "/uuid/%s?pnsdk=%s",
                                  uuid,
                                  pubnub_uname());
@@ -362,7 +374,7 @@ enum pubnub_res pbcc_remove_channel_group_prep(struct pbcc_context* pb,
 
     pb->http_buf_len = snprintf(
         pb->http_buf,
-        sizeof pb->http_buf,
+        PBCC_HTTP_BUF_SIZE(pb),
         "/v1/channel-registration/sub-key/%s/channel-group/%s/remove?pnsdk=%s",
         pb->subscribe_key,
         channel_group,
@@ -382,7 +394,7 @@ enum pubnub_res pbcc_channel_registry_prep(struct pbcc_context* pb,
 
     pb->http_buf_len = snprintf(
         pb->http_buf,
-        sizeof pb->http_buf,
+        PBCC_HTTP_BUF_SIZE(pb),
         "/v1/channel-registration/sub-key/%s/channel-group/%s?pnsdk=%s",
         pb->subscribe_key,
         channel_group,
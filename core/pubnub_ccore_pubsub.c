@@ -2,11 +2,20 @@
 #include "pubnub_internal.h"
 #include "pubnub_version.h"
 #include "pubnub_assert.h"
+#include "pbmem.h"
 #include "pubnub_json_parse.h"
+#include "pubnub_helper.h"
 #include "pubnub_log.h"
 #include "pubnub_url_encode.h"
 #include "lib/pb_strnlen_s.h"
 #include "pubnub_ccore_pubsub.h"
+#include "pbcc_reply_pool.h"
+#if PUBNUB_USE_SUBSCRIBE_V2
+#include "pbcc_subscribe_v2.h"
+#endif
+#if PUBNUB_USE_ADVANCED_HISTORY
+#include "pbcc_advanced_history.h"
+#endif
 
 
 #include <stdio.h>
@@ -19,17 +28,31 @@ void pbcc_init(struct pbcc_context* p, const char* publish_key, const char* subs
     p->subscribe_key = subscribe_key;
     p->timetoken[0]  = '0';
     p->timetoken[1]  = '\0';
+    p->timetoken_u64 = 0;
     p->uuid[0]       = '\0';
     p->auth          = NULL;
     p->msg_ofs = p->msg_end = 0;
 #if PUBNUB_DYNAMIC_REPLY_BUFFER
-    p->http_reply = NULL;
+    p->http_reply      = NULL;
+    p->http_reply_size = 0;
 #if PUBNUB_RECEIVE_GZIP_RESPONSE
-    p->decomp_buf_size   = (size_t)0;
-    p->decomp_http_reply = NULL;
+    p->gzip_stream      = NULL;
+    p->gzip_stream_size = 0;
 #endif /* PUBNUB_RECEIVE_GZIP_RESPONSE */
 #endif /* PUBNUB_DYNAMIC_REPLY_BUFFER */
     p->message_to_send = NULL;
+#if PUBNUB_USE_SUBSCRIBE_V2
+    p->region          = 0;
+    p->msg_v2_index    = NULL;
+    p->msg_v2_capacity = 0;
+    p->msg_v2_count = p->msg_v2_next = 0;
+#endif
+#if PUBNUB_USE_ADVANCED_HISTORY
+    p->history_stream = NULL;
+#endif
+#if PUBNUB_USE_OBJECTS_API
+    p->data_ofs = p->data_end = 0;
+#endif
 
 #if PUBNUB_CRYPTO_API
     p->secret_key = NULL;
@@ -39,29 +62,115 @@ void pbcc_init(struct pbcc_context* p, const char* publish_key, const char* subs
 
 void pbcc_deinit(struct pbcc_context* p)
 {
-#if PUBNUB_DYNAMIC_REPLY_BUFFER
-    if (p->http_reply != NULL) {
-        free(p->http_reply);
-        p->http_reply = NULL;
+    pbcc_release_reply_buffer(p);
+#if PUBNUB_USE_ADVANCED_HISTORY
+    pbcc_history_stream_free(p);
+#endif
+#if PUBNUB_DYNAMIC_HTTP_BUFFER
+    if (p->http_buf != NULL) {
+        pbmem_free(p->http_buf);
+        p->http_buf      = NULL;
+        p->http_buf_size = 0;
     }
-#if PUBNUB_RECEIVE_GZIP_RESPONSE
-    if (p->decomp_http_reply != NULL) {
-        free(p->decomp_http_reply);
-        p->decomp_http_reply = NULL;
+#if PUBNUB_CRYPTO_API
+    if (p->encrypted_msg_buf != NULL) {
+        pbmem_free(p->encrypted_msg_buf);
+        p->encrypted_msg_buf = NULL;
     }
-#endif /* PUBNUB_RECEIVE_GZIP_RESPONSE */
-#endif /* PUBNUB_DYNAMIC_REPLY_BUFFER */
+#endif
+#if PUBNUB_USE_GZIP_COMPRESSION
+    if (p->gzip_msg_buf != NULL) {
+        pbmem_free(p->gzip_msg_buf);
+        p->gzip_msg_buf = NULL;
+    }
+#endif
+#endif /* PUBNUB_DYNAMIC_HTTP_BUFFER */
+    pbmem_account_detach(PBCC_MEMORY(p));
+}
+
+
+int pbcc_set_http_buf_size(struct pbcc_context* p, size_t size)
+{
+#if PUBNUB_DYNAMIC_HTTP_BUFFER
+    char* newbuf = (char*)pbmem_realloc(
+        PBCC_MEMORY(p), pbmemcatContext, p->http_buf, size);
+    if (NULL == newbuf) {
+        return -1;
+    }
+    p->http_buf      = newbuf;
+    p->http_buf_size = size;
+#if PUBNUB_CRYPTO_API
+    if (p->encrypted_msg_buf != NULL) {
+        pbmem_free(p->encrypted_msg_buf);
+        p->encrypted_msg_buf = NULL;
+    }
+#endif
+    return 0;
+#else
+    PUBNUB_UNUSED(p);
+    return (size == sizeof p->http_buf) ? 0 : -1;
+#endif
+}
+
+
+bool pbcc_ensure_encrypted_msg_buf(struct pbcc_context* p)
+{
+#if PUBNUB_DYNAMIC_HTTP_BUFFER && PUBNUB_CRYPTO_API
+    if (NULL == p->encrypted_msg_buf) {
+        p->encrypted_msg_buf = (char*)pbmem_alloc(
+            PBCC_MEMORY(p), pbmemcatCrypto, p->http_buf_size);
+        if (NULL == p->encrypted_msg_buf) {
+            return false;
+        }
+    }
+#else
+    PUBNUB_UNUSED(p);
+#endif
+    return true;
+}
+
+
+bool pbcc_ensure_gzip_msg_buf(struct pbcc_context* p)
+{
+#if PUBNUB_DYNAMIC_HTTP_BUFFER && PUBNUB_USE_GZIP_COMPRESSION
+    if (NULL == p->gzip_msg_buf) {
+        p->gzip_msg_buf = (char*)pbmem_alloc(
+            PBCC_MEMORY(p), pbmemcatDecomp, PUBNUB_COMPRESSED_MAXLEN);
+        if (NULL == p->gzip_msg_buf) {
+            return false;
+        }
+    }
+#else
+    PUBNUB_UNUSED(p);
+#endif
+    return true;
 }
 
 
 int pbcc_realloc_reply_buffer(struct pbcc_context* p, unsigned bytes)
 {
 #if PUBNUB_DYNAMIC_REPLY_BUFFER
-    char* newbuf = (char*)realloc(p->http_reply, bytes + 1);
+    size_t newsize;
+    char*  newbuf;
+
+    if ((size_t)bytes < p->http_reply_size) {
+        return 0;
+    }
+    newbuf = pbcc_reply_pool_get(
+        PBCC_MEMORY(p), pbmemcatReply, (size_t)bytes + 1, &newsize);
     if (NULL == newbuf) {
         return -1;
     }
-    p->http_reply = newbuf;
+    if (p->http_reply != NULL) {
+        /* A chunked reply grows as chunks arrive */
+        memcpy(newbuf,
+               p->http_reply,
+               (p->http_buf_len < p->http_reply_size) ? p->http_buf_len
+                                                      : p->http_reply_size);
+        pbcc_reply_pool_put(p->http_reply, p->http_reply_size);
+    }
+    p->http_reply      = newbuf;
+    p->http_reply_size = newsize;
     return 0;
 #else
     if (bytes < sizeof p->http_reply / sizeof p->http_reply[0]) {
@@ -77,16 +186,35 @@ bool pbcc_ensure_reply_buffer(struct pbcc_context* p)
 #if PUBNUB_DYNAMIC_REPLY_BUFFER
     if (NULL == p->http_reply) {
         /* Need just one byte for string end */
-        p->http_reply = (char*)malloc(1);
-        if (NULL == p->http_reply) {
-            return false;
-        }
+        return 0 == pbcc_realloc_reply_buffer(p, 0);
     }
 #endif
     return true;
 }
 
 
+void pbcc_release_reply_buffer(struct pbcc_context* p)
+{
+#if PUBNUB_DYNAMIC_REPLY_BUFFER
+    pbcc_reply_pool_put(p->http_reply, p->http_reply_size);
+    p->http_reply      = NULL;
+    p->http_reply_size = 0;
+#if PUBNUB_RECEIVE_GZIP_RESPONSE
+    pbcc_reply_pool_put((char*)p->gzip_stream, p->gzip_stream_size);
+    p->gzip_stream      = NULL;
+    p->gzip_stream_size = 0;
+#endif /* PUBNUB_RECEIVE_GZIP_RESPONSE */
+#else
+    p->http_reply[0] = '\0';
+#endif /* PUBNUB_DYNAMIC_REPLY_BUFFER */
+#if PUBNUB_USE_SUBSCRIBE_V2
+    pbcc_free_msg_v2_index(p);
+#endif
+    p->msg_ofs = p->msg_end = 0;
+    p->chan_ofs = p->chan_end = 0;
+}
+
+
 char const* pbcc_get_msg(struct pbcc_context* pb)
 {
     if (pb->msg_ofs < pb->msg_end) {
@@ -101,6 +229,22 @@ char const* pbcc_get_msg(struct pbcc_context* pb)
 }
 
 
+size_t pbcc_get_msg_batch(struct pbcc_context* pb, char const** out, size_t max)
+{
+    size_t n;
+
+    for (n = 0; n < max; ++n) {
+        char const* msg = pbcc_get_msg(pb);
+        if (NULL == msg) {
+            break;
+        }
+        out[n] = msg;
+    }
+
+    return n;
+}
+
+
 char const* pbcc_get_channel(struct pbcc_context* pb)
 {
     if (pb->chan_ofs < pb->chan_end) {
@@ -157,43 +301,7 @@ static int find_string_start(char const* buf, int len)
 
 bool pbcc_split_array(char* buf)
 {
-    bool escaped       = false;
-    bool in_string     = false;
-    int  bracket_level = 0;
-
-    for (; *buf != '\0'; ++buf) {
-        if (escaped) {
-            escaped = false;
-        }
-        else if ('"' == *buf) {
-            in_string = !in_string;
-        }
-        else if (in_string) {
-            escaped = ('\\' == *buf);
-        }
-        else {
-            switch (*buf) {
-            case '[':
-            case '{':
-                bracket_level++;
-                break;
-            case ']':
-            case '}':
-                bracket_level--;
-                break;
-                /* if at root, split! */
-            case ',':
-                if (bracket_level == 0) {
-                    *buf = '\0';
-                }
-                break;
-            default:
-                break;
-            }
-        }
-    }
-
-    return !(escaped || in_string || (bracket_level > 0));
+    return pbjson_split_array(buf, buf + strlen(buf));
 }
 
 
@@ -307,10 +415,12 @@ enum pubnub_res pbcc_parse_subscribe_response(struct pbcc_context* p)
     /* Setup timetoken. */
     time_token_length = previous_i - (i + 1);
     if (time_token_length >= sizeof p->timetoken) {
-        p->timetoken[0] = '\0';
+        p->timetoken[0]  = '\0';
+        p->timetoken_u64 = 0;
         return PNR_FORMAT_ERROR;
     }
     memcpy(p->timetoken, reply + i + 1, time_token_length + 1);
+    p->timetoken_u64 = pubnub_timetoken_to_u64(p->timetoken, time_token_length);
 
     /* terminate the [] message array (before the `]`!) */
     reply[i - 2] = 0;
@@ -332,7 +442,7 @@ enum pubnub_res pbcc_append_url_param(struct pbcc_context* pb,
 {
     size_t param_val_len = strlen(param_val);
     if (pb->http_buf_len + 1 + param_name_len + 1 + param_val_len + 1
-        > sizeof pb->http_buf) {
+        > PBCC_HTTP_BUF_SIZE(pb)) {
         return PNR_TX_BUFF_TOO_SMALL;
     }
 
@@ -384,7 +494,7 @@ enum pubnub_res pbcc_url_encode(struct pbcc_context* pb, char const* what)
 
     url_encoded_length = pubnub_url_encode(pb->http_buf + pb->http_buf_len,
                                            what,
-                                           sizeof pb->http_buf - pb->http_buf_len);
+                                           PBCC_HTTP_BUF_SIZE(pb) - pb->http_buf_len);
     if (url_encoded_length < 0) {
         pb->http_buf_len = 0;
         return PNR_TX_BUFF_TOO_SMALL;
@@ -401,7 +511,7 @@ enum pubnub_res pbcc_append_url_param_encoded(struct pbcc_context* pb,
                                               char const* param_val,
                                               char        separator)
 {
-    if (pb->http_buf_len + 1 + param_name_len + 1 > sizeof pb->http_buf) {
+    if (pb->http_buf_len + 1 + param_name_len + 1 > PBCC_HTTP_BUF_SIZE(pb)) {
         return PNR_TX_BUFF_TOO_SMALL;
     }
 
@@ -429,7 +539,7 @@ enum pubnub_res pbcc_publish_prep(struct pbcc_context* pb,
 
     pb->http_content_len = 0;
     pb->http_buf_len     = snprintf(pb->http_buf,
-                                sizeof pb->http_buf,
+                                PBCC_HTTP_BUF_SIZE(pb),
                                 "/publish/%s/%s/0/",
                                 pb->publish_key,
                                 pb->subscribe_key);
@@ -450,7 +560,7 @@ enum pubnub_res pbcc_publish_prep(struct pbcc_context* pb,
     }
     if ((PNR_OK == rslt) && (meta != NULL)) {
         size_t const param_name_len = sizeof "meta" - 1;
-        if (pb->http_buf_len + 1 + param_name_len + 1 + 1 > sizeof pb->http_buf) {
+        if (pb->http_buf_len + 1 + param_name_len + 1 + 1 > PBCC_HTTP_BUF_SIZE(pb)) {
             return PNR_TX_BUFF_TOO_SMALL;
         }
         pb->http_buf[pb->http_buf_len++] = '&';
@@ -478,7 +588,7 @@ enum pubnub_res pbcc_signal_prep(struct pbcc_context* pb,
 
     pb->http_content_len = 0;
     pb->http_buf_len = snprintf(pb->http_buf,
-                                sizeof pb->http_buf,
+                                PBCC_HTTP_BUF_SIZE(pb),
                                 "/signal/%s/%s/0/",
                                 pb->publish_key,
                                 pb->subscribe_key);
@@ -515,10 +625,10 @@ enum pubnub_res pbcc_subscribe_prep(struct pbcc_context* p,
     p->msg_ofs = p->msg_end = 0;
 
     p->http_buf_len = snprintf(
-        p->http_buf, sizeof p->http_buf, "/subscribe/%s/", p->subscribe_key);
+        p->http_buf, PBCC_HTTP_BUF_SIZE(p), "/subscribe/%s/", p->subscribe_key);
     APPEND_URL_ENCODED_M(p, channel);
     p->http_buf_len += snprintf(p->http_buf + p->http_buf_len,
-                                sizeof p->http_buf - p->http_buf_len,
+                                PBCC_HTTP_BUF_SIZE(p) - p->http_buf_len,
                                 "/0/%s?pnsdk=%s",
                                 p->timetoken,
                                 pubnub_uname());
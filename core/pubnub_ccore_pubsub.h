@@ -5,12 +5,41 @@
 #include "pubnub_config.h"
 #include "pubnub_api_types.h"
 #include "pubnub_generate_uuid.h"
+#include "pbmem.h"
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
 
+#if !defined PUBNUB_DYNAMIC_HTTP_BUFFER
+/** If true (!=0), the HTTP ("scratch") buffer of a context is
+    allocated dynamically, and its size may be changed per context
+    (see pubnub_set_http_buffer_size()), while the auxiliary (crypto,
+    GZIP, proxy) buffers are allocated only on first use.  If false
+    (0), all of them are a part of the context, of the size set at
+    compile time.
+ */
+#define PUBNUB_DYNAMIC_HTTP_BUFFER 0
+#endif
+
+/** The minimal size of the HTTP buffer that can be set. It has to
+    hold the lines of the HTTP response header, too.
+ */
+#define PUBNUB_MIN_HTTP_BUF_SIZE 512
+
+#if !defined PUBNUB_MAX_HTTP_BUF_SIZE
+/** The maximal size of the HTTP buffer that can be set. Large buffers
+    (hundreds of KB) let contexts that do bulk transfers (publishing
+    big messages, fetching long history) do fewer, larger, reads and
+    writes, but they are of little use beyond that, so this is just a
+    sanity limit.
+ */
+#define PUBNUB_MAX_HTTP_BUF_SIZE (1024 * 1024)
+#endif
+
+
 /** @file pubnub_ccore_pubsub.h
 
     This has the functions for formating and parsing the requests and
@@ -37,16 +66,50 @@ struct pbcc_context {
     /** The last recived subscribe time token. */
     char timetoken[20];
 
+    /** The last received subscribe time token, as an integer (0 if
+        there is none or it's not valid) */
+    uint64_t timetoken_u64;
+
 #if PUBNUB_USE_SUBSCRIBE_V2
     /** The last received subscribe V2 region */
     int region;
+    /** Index of the messages in the last subscribe V2 response */
+    struct pbcc_msg_v2_entry* msg_v2_index;
+    /** Number of messages in the index */
+    unsigned msg_v2_count;
+    /** Number of entries allocated for the index */
+    unsigned msg_v2_capacity;
+    /** Index (in the index) of the message to get next */
+    unsigned msg_v2_next;
+#endif
+
+#if PUBNUB_USE_ADVANCED_HISTORY
+    /** The history stream (see pbcc_advanced_history.h), NULL if
+        none was requested yet */
+    struct pbcc_history_stream* history_stream;
+#endif
+
+#if PUBNUB_USE_OBJECTS_API
+    /** Offset (in the reply) of the next element of the "data" array
+        of the last Objects API response */
+    unsigned data_ofs;
+    /** Offset of the end of the "data" array */
+    unsigned data_end;
 #endif
 
     /** The result of the last Pubnub transaction */
     enum pubnub_res last_result;
 
+#if PUBNUB_DYNAMIC_HTTP_BUFFER
+    /** The "scratch" buffer for HTTP data */
+    char* http_buf;
+
+    /** The size of the "scratch" buffer for HTTP data */
+    size_t http_buf_size;
+#else
     /** The "scratch" buffer for HTTP data */
     char http_buf[PUBNUB_BUF_MAXLEN];
+#endif
 
     /** The length of the data currently in the HTTP buffer ("scratch"
         or reply, depending on the state).
@@ -54,19 +117,31 @@ struct pbcc_context {
     size_t http_buf_len;
 
 #if PUBNUB_CRYPTO_API
+#if PUBNUB_DYNAMIC_HTTP_BUFFER
+    /** Holds encrypted message. Allocated on first use, has the
+        same size as the HTTP buffer. */
+    char* encrypted_msg_buf;
+#else
     /** Holds encrypted message */
     char encrypted_msg_buf[PUBNUB_BUF_MAXLEN];
 #endif
+#endif
 
 #if PUBNUB_USE_GZIP_COMPRESSION
+#if PUBNUB_DYNAMIC_HTTP_BUFFER
+    /** Buffer for compressed message, of #PUBNUB_COMPRESSED_MAXLEN
+        bytes. Allocated on first use. */
+    char* gzip_msg_buf;
+#else
     /** Buffer for compressed message */
     char gzip_msg_buf[PUBNUB_COMPRESSED_MAXLEN];
+#endif
     
     /** The length of compressed data in 'comp_http_buf' ready to be sent */
     size_t gzip_msg_len;
 #endif
 
-#if PUBNUB_RECEIVE_GZIP_RESPONSE
+#if PUBNUB_RECEIVE_GZIP_RESPONSE && !PUBNUB_DYNAMIC_REPLY_BUFFER
     /** The length of the decompressed data currently in the decompressing
      * buffer ("scratch").
      */
@@ -78,9 +153,18 @@ struct pbcc_context {
     unsigned http_content_len;
 
 #if PUBNUB_DYNAMIC_REPLY_BUFFER
+    /** The reply buffer, borrowed from the reply buffer pool (see
+        pbcc_reply_pool.h), NULL if none is borrowed */
     char* http_reply;
+    /** The size of the (borrowed) reply buffer */
+    size_t http_reply_size;
 #if PUBNUB_RECEIVE_GZIP_RESPONSE
-    char* decomp_http_reply;
+    /** The state of decompressing a gzip response as it arrives
+        (straight into the reply buffer), borrowed from the reply
+        buffer pool, NULL if none is borrowed */
+    struct pbgzip_stream* gzip_stream;
+    /** The size of the (borrowed) decompression state */
+    size_t gzip_stream_size;
 #endif /* PUBNUB_RECEIVE_GZIP_RESPONSE */
 #else
     /** The contents of a HTTP reply/reponse */
@@ -108,9 +192,28 @@ struct pbcc_context {
     /** Secret key to use for encryption/decryption */
     char const* secret_key;
 #endif
+
+#if PUBNUB_MEMORY_STATS
+    /** Memory accounting of this context */
+    struct pbmem_account memory;
+#endif
 };
 
 
+#if PUBNUB_DYNAMIC_HTTP_BUFFER
+#define PBCC_HTTP_BUF_SIZE(pbc) ((pbc)->http_buf_size)
+#else
+#define PBCC_HTTP_BUF_SIZE(pbc) (sizeof (pbc)->http_buf)
+#endif
+
+/** The memory account of the context @p pbc, to pass to pbmem
+    functions */
+#if PUBNUB_MEMORY_STATS
+#define PBCC_MEMORY(pbc) (&(pbc)->memory)
+#else
+#define PBCC_MEMORY(pbc) NULL
+#endif
+
 #define APPEND_URL_PARAM_M(pbc, name, var, separator)                          \
     if ((var) != NULL) {                                                       \
         const char      param_[] = name;                                       \
@@ -123,11 +226,11 @@ struct pbcc_context {
 
 #define APPEND_URL_LITERAL_M_IMP(pbc, string_literal)                          \
     do {                                                                       \
-        if ((pbc)->http_buf_len + sizeof(string_literal) > sizeof (pbc)->http_buf) {\
+        if ((pbc)->http_buf_len + sizeof(string_literal) > PBCC_HTTP_BUF_SIZE(pbc)) {\
             PUBNUB_LOG_ERROR("Error: Request buffer too small - cannot append url literal:\n"\
                              "current_buffer_size = %lu\n"                     \
                              "required_buffer_size = %lu\n",                   \
-                             (unsigned long)(sizeof (pbc)->http_buf),          \
+                             (unsigned long)PBCC_HTTP_BUF_SIZE(pbc),           \
                              (unsigned long)((pbc)->http_buf_len + 1 + sizeof(string_literal)));\
             return PNR_TX_BUFF_TOO_SMALL;                                      \
         }                                                                      \
@@ -143,16 +246,16 @@ struct pbcc_context {
         if (M_s_ != NULL) {                                                    \
             struct pbcc_context* M_pbc_ = pbc;                                 \
             size_t M_n_ = n;                                                   \
-            if (M_pbc_->http_buf_len + M_n_ > sizeof M_pbc_->http_buf) {       \
+            if (M_pbc_->http_buf_len + M_n_ > PBCC_HTTP_BUF_SIZE(M_pbc_)) {    \
                 PUBNUB_LOG_ERROR("Error: Request buffer too small - cannot append url string:\n"\
                                  "current_buffer_size = %lu\n"                 \
                                  "required_buffer_size = %lu\n",               \
-                                 (unsigned long)(sizeof M_pbc_->http_buf),     \
+                                 (unsigned long)PBCC_HTTP_BUF_SIZE(M_pbc_),    \
                                  (unsigned long)(M_pbc_->http_buf_len + 1 + M_n_));\
                 return PNR_TX_BUFF_TOO_SMALL;                                  \
             }                                                                  \
             M_pbc_->http_buf_len += snprintf(M_pbc_->http_buf + M_pbc_->http_buf_len,\
-                                             sizeof M_pbc_->http_buf - M_pbc_->http_buf_len - 1,\
+                                             PBCC_HTTP_BUF_SIZE(M_pbc_) - M_pbc_->http_buf_len - 1,\
                                              "%.*s",                           \
                                              (int)M_n_,                        \
                                              M_s_);                            \
@@ -239,11 +342,11 @@ struct pbcc_context {
 #define APPEND_MESSAGE_BODY_M(rslt, pbc, message)                              \
     if ((PNR_OK == (rslt)) && ((message) != NULL)) {                           \
         if (NOT_COMPRESSED_AND(pbc)(pb_strnlen_s(message, PUBNUB_MAX_OBJECT_LENGTH) >\
-                                    sizeof (pbc)->http_buf - (pbc)->http_buf_len - 2)) {\
+                                    PBCC_HTTP_BUF_SIZE(pbc) - (pbc)->http_buf_len - 2)) {\
             PUBNUB_LOG_ERROR("Error: Request buffer too small - cannot pack the message body:\n"\
                              "current_buffer_size = %lu\n"                     \
                              "required_buffer_size = %lu\n",                   \
-                             (unsigned long)(sizeof (pbc)->http_buf),          \
+                             (unsigned long)PBCC_HTTP_BUF_SIZE(pbc),           \
                              (unsigned long)((pbc)->http_buf_len + 2 + pb_strnlen_s(message,\
                                                                                     PUBNUB_MAX_OBJECT_LENGTH)));\
             return PNR_TX_BUFF_TOO_SMALL;                                      \
@@ -260,6 +363,27 @@ void pbcc_init(struct pbcc_context* pbcc,
 /** Deinitializes the Pubnub C core context */
 void pbcc_deinit(struct pbcc_context* p);
 
+/** Sets the size of the HTTP ("scratch") buffer in the C core
+    context @p p to @p size, (re)allocating it. The crypto buffer, if
+    allocated, is released, to be allocated with the new size on
+    next use.
+    Has effect only if #PUBNUB_DYNAMIC_HTTP_BUFFER is true.
+    @return 0: OK, -1: failed, buffer not changed
+*/
+int pbcc_set_http_buf_size(struct pbcc_context* p, size_t size);
+
+/** Ensures the buffer for the encrypted message in the C core
+    context @p p exists.
+    @return true: OK, false: failed to allocate
+*/
+bool pbcc_ensure_encrypted_msg_buf(struct pbcc_context* p);
+
+/** Ensures the buffer for the GZIP compressed message in the C core
+    context @p p exists.
+    @return true: OK, false: failed to allocate
+*/
+bool pbcc_ensure_gzip_msg_buf(struct pbcc_context* p);
+
 /** Reallocates the reply buffer in the C core context @p p to have
     @p bytes.
     @return 0: OK, allocated, -1: failed
@@ -273,11 +397,24 @@ int pbcc_realloc_reply_buffer(struct pbcc_context* p, unsigned bytes);
 */
 bool pbcc_ensure_reply_buffer(struct pbcc_context* p);
 
+/** Returns the reply buffer (and decompression state) of the C core context
+    @p p to the reply buffer pool, dropping the reply that's in it,
+    (if #PUBNUB_DYNAMIC_REPLY_BUFFER is false, just drops the reply).
+    A new buffer will be borrowed when the next reply is received.
+*/
+void pbcc_release_reply_buffer(struct pbcc_context* p);
+
 /** Returns the next message from the Pubnub C Core context. NULL if
     there are no (more) messages
 */
 char const* pbcc_get_msg(struct pbcc_context* pb);
 
+/** Gets the next (up to) @p max messages from the Pubnub C Core
+    context into @p out, as if pbcc_get_msg() was called for each of
+    them. Returns the number of messages put into @p out.
+*/
+size_t pbcc_get_msg_batch(struct pbcc_context* pb, char const** out, size_t max);
+
 /** Returns the next channel from the Pubnub C Core context. NULL if
     there are no (more) messages.
 */
@@ -6,10 +6,16 @@
 #include "pubnub_server_limits.h"
 #include "pubnub_pubsubapi.h"
 #include "pubnub_coreapi.h"
+#if PUBNUB_USE_SUBSCRIBE_V2
+#include "pubnub_subscribe_v2.h"
+#endif
 #if PUBNUB_USE_ADVANCED_HISTORY
 #include "pubnub_memory_block.h"
 #include "pubnub_advanced_history.h"
 #endif
+#if PUBNUB_USE_OBJECTS_API
+#include "pubnub_objects_api.h"
+#endif
 #include "pubnub_assert.h"
 #include "pubnub_alloc.h"
 #include "pubnub_log.h"
@@ -17,9 +23,11 @@
 #include "pbpal.h"
 #include "pubnub_version_internal.h"
 #include "pubnub_keep_alive.h"
+#include "pubnub_netcore.h"
 #include "test/pubnub_test_helper.h"
 
 #include "pubnub_json_parse.h"
+#include "pubnub_helper.h"
 
 #include <stdlib.h>
 #include <string.h>
@@ -126,17 +134,52 @@ int pbntf_watch_in_events(pubnub_t* pb)
     return (int)mock(pb);
 }
 
+enum pubnub_res pbntf_await_progress(pubnub_t* pb,
+                                     enum pubnub_res (*progress)(pubnub_t* pb, void* data),
+                                     void* data)
+{
+    enum pubnub_res result;
+
+    while (PNR_IN_PROGRESS == (result = progress(pb, data))) {
+        if (pbnc_can_start_transaction(pb)) {
+            return pb->core.last_result;
+        }
+        pbnc_fsm(pb);
+    }
+    return result;
+}
+
+/* The sync interface functions used by the history pager, without
+   the timeout, like pbntf_await_progress() above */
+enum pubnub_res pubnub_last_result(pubnub_t* pb)
+{
+    if (!pbnc_can_start_transaction(pb)) {
+        pbnc_fsm(pb);
+    }
+    return pb->core.last_result;
+}
+
+enum pubnub_res pubnub_await(pubnub_t* pb)
+{
+    while (!pbnc_can_start_transaction(pb)) {
+        pbnc_fsm(pb);
+    }
+    return pb->core.last_result;
+}
+
 
 /* The Pubnub PAL mocks and stubs */
 
 static void buf_setup(pubnub_t* pb)
 {
     pb->ptr  = (uint8_t*)pb->core.http_buf;
-    pb->left = sizeof pb->core.http_buf / sizeof pb->core.http_buf[0];
+    pb->left = PBCC_HTTP_BUF_SIZE(&pb->core);
 }
 
 void pbpal_init(pubnub_t* pb)
 {
+    pb->sock_state = STATE_NONE;
+    pb->unreadlen  = 0;
     buf_setup(pb);
 }
 
@@ -216,19 +259,19 @@ int pbpal_send_status(pubnub_t* pb)
 
 int pbpal_start_read_line(pubnub_t* pb)
 {
-    unsigned distance;
+    size_t distance;
 
     PUBNUB_ASSERT_INT_OPT(pb->sock_state, ==, STATE_NONE);
 
     if (pb->unreadlen > 0) {
         PUBNUB_ASSERT_OPT((char*)(pb->ptr + pb->unreadlen)
-                          <= (char*)(pb->core.http_buf + PUBNUB_BUF_MAXLEN));
+                          <= (char*)(pb->core.http_buf + PBCC_HTTP_BUF_SIZE(&pb->core)));
         memmove(pb->core.http_buf, pb->ptr, pb->unreadlen);
     }
     distance = pb->ptr - (uint8_t*)pb->core.http_buf;
     PUBNUB_ASSERT_UINT((distance + pb->left + pb->unreadlen),
                        ==,
-                       (sizeof pb->core.http_buf / sizeof pb->core.http_buf[0]));
+                       PBCC_HTTP_BUF_SIZE(&pb->core));
     pb->ptr -= distance;
     pb->left += distance;
 
@@ -326,7 +369,7 @@ enum pubnub_res pbpal_line_read_status(pubnub_t* pb)
     if (pb->unreadlen == 0) {
         int recvres;
         PUBNUB_ASSERT_OPT((char*)(pb->ptr + pb->left)
-                          == (char*)(pb->core.http_buf + PUBNUB_BUF_MAXLEN));
+                          == (char*)(pb->core.http_buf + PBCC_HTTP_BUF_SIZE(&pb->core)));
         recvres = my_recv((char*)pb->ptr, pb->left);
         if (recvres < 0) {
             return PNR_IN_PROGRESS;
@@ -335,7 +378,7 @@ enum pubnub_res pbpal_line_read_status(pubnub_t* pb)
             pb->sock_state = STATE_NONE;
             return PNR_TIMEOUT;
         }
-        PUBNUB_ASSERT_OPT(recvres <= pb->left);
+        PUBNUB_ASSERT_OPT((size_t)recvres <= pb->left);
         PUBNUB_LOG_TRACE(
             "pb=%p have new data of length=%d: %.*s\n", pb, recvres, recvres, pb->ptr);
         pb->unreadlen = recvres;
@@ -350,7 +393,7 @@ enum pubnub_res pbpal_line_read_status(pubnub_t* pb)
             PUBNUB_LOG_TRACE("pb=%p, newline found, line length: %d, ",
                              pb,
                              pbpal_read_len(pb));
-            WATCH_USHORT(pb->unreadlen);
+            WATCH_SIZE_T(pb->unreadlen);
             pb->sock_state = STATE_NONE;
             return PNR_OK;
         }
@@ -368,23 +411,23 @@ enum pubnub_res pbpal_line_read_status(pubnub_t* pb)
 
 int pbpal_start_read(pubnub_t* pb, size_t n)
 {
-    unsigned distance;
+    size_t distance;
 
     PUBNUB_ASSERT_UINT_OPT(n, >, 0);
     PUBNUB_ASSERT_INT_OPT(pb->sock_state, ==, STATE_NONE);
 
-    WATCH_USHORT(pb->unreadlen);
-    WATCH_USHORT(pb->left);
+    WATCH_SIZE_T(pb->unreadlen);
+    WATCH_SIZE_T(pb->left);
     if (pb->unreadlen > 0) {
         PUBNUB_ASSERT_OPT((char*)(pb->ptr + pb->unreadlen)
-                          <= (char*)(pb->core.http_buf + PUBNUB_BUF_MAXLEN));
+                          <= (char*)(pb->core.http_buf + PBCC_HTTP_BUF_SIZE(&pb->core)));
         memmove(pb->core.http_buf, pb->ptr, pb->unreadlen);
     }
     distance = pb->ptr - (uint8_t*)pb->core.http_buf;
-    WATCH_UINT(distance);
+    WATCH_SIZE_T(distance);
     PUBNUB_ASSERT_UINT(distance + pb->unreadlen + pb->left,
                        ==,
-                       sizeof pb->core.http_buf / sizeof pb->core.http_buf[0]);
+                       PBCC_HTTP_BUF_SIZE(&pb->core));
     pb->ptr -= distance;
     pb->left += distance;
 
@@ -401,7 +444,7 @@ enum pubnub_res pbpal_read_status(pubnub_t* pb)
     PUBNUB_ASSERT_OPT(STATE_READ == pb->sock_state);
 
     if (0 == pb->unreadlen) {
-        unsigned to_recv = pb->len;
+        size_t to_recv = pb->len;
         if (to_recv > pb->left) {
             to_recv = pb->left;
         }
@@ -414,11 +457,11 @@ enum pubnub_res pbpal_read_status(pubnub_t* pb)
             pb->sock_state = STATE_NONE;
             return PNR_TIMEOUT;
         }
-        PUBNUB_ASSERT_OPT(pb->left >= have_read);
+        PUBNUB_ASSERT_OPT(pb->left >= (size_t)have_read);
         pb->left -= have_read;
     }
     else {
-        have_read = (pb->unreadlen >= pb->len) ? pb->len : pb->unreadlen;
+        have_read = (int)((pb->unreadlen >= pb->len) ? pb->len : pb->unreadlen);
         pb->unreadlen -= have_read;
     }
 
@@ -751,6 +794,187 @@ Ensure(/*pbjson_parse, */ gibberish_json)
            is_true);
 }
 
+Ensure(/*pbjson_parse, */ object_iterator_valid)
+{
+    char const* json = "{ \"d\":{\"a\":[1,2]}, \"c\" : \"ch\\\"1\",\"e\":1 }";
+    struct pbjson_elem            elem = { json, json + strlen(json) };
+    struct pbjson_object_iterator it;
+    struct pbjson_elem            key;
+    struct pbjson_elem            value;
+
+    attest(pbjson_object_iterator_init(&it, &elem), equals(jonmpOK));
+    attest(pbjson_object_next_pair(&it, &key, &value), equals(jonmpOK));
+    attest(pbjson_elem_equals_string(&key, "d"), is_true);
+    attest(pbjson_elem_equals_string(&value, "{\"a\":[1,2]}"), is_true);
+    attest(pbjson_object_next_pair(&it, &key, &value), equals(jonmpOK));
+    attest(pbjson_elem_equals_string(&key, "c"), is_true);
+    attest(pbjson_elem_equals_string(&value, "\"ch\\\"1\""), is_true);
+    attest(pbjson_object_next_pair(&it, &key, &value), equals(jonmpOK));
+    attest(pbjson_elem_equals_string(&key, "e"), is_true);
+    attest(pbjson_elem_equals_string(&value, "1"), is_true);
+    attest(pbjson_object_next_pair(&it, &key, &value), equals(jonmpKeyNotFound));
+    attest(*it.s, equals('}'));
+
+    json       = "{ }";
+    elem.start = json;
+    elem.end   = json + strlen(json);
+    attest(pbjson_object_iterator_init(&it, &elem), equals(jonmpOK));
+    attest(pbjson_object_next_pair(&it, &key, &value), equals(jonmpKeyNotFound));
+}
+
+Ensure(/*pbjson_parse, */ object_iterator_invalid)
+{
+    char const* json = "[1,2]";
+    struct pbjson_elem            elem = { json, json + strlen(json) };
+    struct pbjson_object_iterator it;
+    struct pbjson_elem            key;
+    struct pbjson_elem            value;
+
+    attest(pbjson_object_iterator_init(&it, &elem), equals(jonmpNoStartCurly));
+
+    json       = "{\"a\":1 \"b\":2}";
+    elem.start = json;
+    elem.end   = json + strlen(json);
+    attest(pbjson_object_iterator_init(&it, &elem), equals(jonmpOK));
+    attest(pbjson_object_next_pair(&it, &key, &value),
+           equals(jonmpMissingValueSeparator));
+
+    json       = "{\"a\":1,\"b\" 2}";
+    elem.start = json;
+    elem.end   = json + strlen(json);
+    attest(pbjson_object_iterator_init(&it, &elem), equals(jonmpOK));
+    attest(pbjson_object_next_pair(&it, &key, &value), equals(jonmpOK));
+    attest(pbjson_object_next_pair(&it, &key, &value), equals(jonmpMissingColon));
+
+    json       = "{\"a\":[1,2";
+    elem.start = json;
+    elem.end   = json + strlen(json);
+    attest(pbjson_object_iterator_init(&it, &elem), equals(jonmpOK));
+    attest(pbjson_object_next_pair(&it, &key, &value), equals(jonmpValueIncomplete));
+}
+
+
+Ensure(/*pbjson_parse, */ scanners_agree)
+{
+    /* Escapes, quotes, brackets and braces at all positions relative
+       to the SIMD blocks (16 and 32 characters) */
+    static char const* tails[] = { "\\\"x\"]}", "\\\\\"]}x\"}",
+                                   "\\\\\\\"x\"}]", "}]\"{[\\\\\"}",
+                                   "x\"}" };
+    enum pbjson_scanner dflt = pbjson_current_scanner();
+    char                json[128];
+    unsigned            pad;
+    unsigned            t;
+    int                 scanner;
+
+    for (t = 0; t < sizeof tails / sizeof tails[0]; ++t) {
+        for (pad = 0; pad < 70; ++pad) {
+            char const* end;
+            char const* expected_complex;
+            char const* expected_string;
+
+            strcpy(json, "{\"k\":[{\"v\":\"");
+            memset(json + strlen(json), 'a', pad);
+            strcpy(json + strlen("{\"k\":[{\"v\":\"") + pad, tails[t]);
+            end = json + strlen(json);
+
+            attest(pbjson_select_scanner(pbjsonScannerScalar), is_true);
+            expected_complex = pbjson_find_end_complex(json, end);
+            expected_string  = pbjson_find_end_string(json + 12, end);
+            for (scanner = pbjsonScannerSSE2; scanner <= pbjsonScannerNEON; ++scanner) {
+                if (pbjson_select_scanner((enum pbjson_scanner)scanner)) {
+                    attest(pbjson_find_end_complex(json, end), equals(expected_complex));
+                    attest(pbjson_find_end_string(json + 12, end),
+                           equals(expected_string));
+                }
+            }
+        }
+    }
+    attest(pbjson_select_scanner(dflt), is_true);
+}
+
+
+Ensure(/*pbjson_parse, */ scanners_fuzz)
+{
+    /* Lots of the interesting characters, to get all kinds of
+       nesting and escaping */
+    static char const   alphabet[] = "{}[]\"\\\\\\,,ab \0";
+    enum pbjson_scanner dflt       = pbjson_current_scanner();
+    unsigned long       seed       = 1;
+    unsigned            round;
+
+    for (round = 0; round < 20000; ++round) {
+        char        json[200];
+        char        expected_split[sizeof json];
+        char        split[sizeof json];
+        bool        expected_split_rslt;
+        char const* expected_complex;
+        char const* expected_string;
+        size_t      len;
+        size_t      i;
+        int         scanner;
+
+        seed = seed * 1103515245 + 12345;
+        len  = 1 + (seed >> 16) % (sizeof json - 1);
+        for (i = 0; i < len; ++i) {
+            seed    = seed * 1103515245 + 12345;
+            json[i] = alphabet[(seed >> 16) % (sizeof alphabet - 1)];
+        }
+        json[0] = (round % 2) ? '{' : '[';
+
+        attest(pbjson_select_scanner(pbjsonScannerScalar), is_true);
+        expected_complex = pbjson_find_end_complex(json, json + len);
+        expected_string  = pbjson_find_end_string(json + 1, json + len);
+        memcpy(expected_split, json, len);
+        expected_split_rslt = pbjson_split_array(expected_split + 1, expected_split + len);
+        for (scanner = pbjsonScannerSSE2; scanner <= pbjsonScannerNEON; ++scanner) {
+            if (pbjson_select_scanner((enum pbjson_scanner)scanner)) {
+                attest(pbjson_find_end_complex(json, json + len), equals(expected_complex));
+                attest(pbjson_find_end_string(json + 1, json + len),
+                       equals(expected_string));
+                memcpy(split, json, len);
+                attest(pbjson_split_array(split + 1, split + len),
+                       equals(expected_split_rslt));
+                attest(memcmp(split, expected_split, len), equals(0));
+            }
+        }
+    }
+    attest(pbjson_select_scanner(dflt), is_true);
+}
+
+
+Ensure(/*pubnub_helper, */ timetoken_u64_conversion)
+{
+    char buf[PUBNUB_TIMETOKEN_U64_MAX_LEN + 1];
+
+    attest(pubnub_timetoken_to_u64("15160149789251234", 17)
+               == UINT64_C(15160149789251234),
+           is_true);
+    attest(pubnub_timetoken_to_u64("\"15160149789251234\"", 19)
+               == UINT64_C(15160149789251234),
+           is_true);
+    attest(pubnub_timetoken_to_u64("0", 1) == 0, is_true);
+    attest(pubnub_timetoken_to_u64("18446744073709551615", 20) == UINT64_MAX,
+           is_true);
+    attest(pubnub_timetoken_to_u64("18446744073709551616", 20) == 0, is_true);
+    attest(pubnub_timetoken_to_u64("99999999999999999999", 20) == 0, is_true);
+    attest(pubnub_timetoken_to_u64("123456789012345678901", 21) == 0, is_true);
+    attest(pubnub_timetoken_to_u64("1516a", 5) == 0, is_true);
+    attest(pubnub_timetoken_to_u64("\"\"", 2) == 0, is_true);
+    attest(pubnub_timetoken_to_u64("", 0) == 0, is_true);
+
+    attest(pubnub_u64_to_timetoken(UINT64_C(15160149789251234), buf, sizeof buf),
+           equals(17));
+    attest(buf, streqs("15160149789251234"));
+    attest(pubnub_u64_to_timetoken(0, buf, sizeof buf), equals(1));
+    attest(buf, streqs("0"));
+    attest(pubnub_u64_to_timetoken(UINT64_MAX, buf, sizeof buf), equals(20));
+    attest(buf, streqs("18446744073709551615"));
+    attest(pubnub_u64_to_timetoken(100, buf, 3), equals(0));
+    attest(pubnub_u64_to_timetoken(100, buf, 4), equals(3));
+    attest(buf, streqs("100"));
+}
+
 
 Describe(single_context_pubnub);
 
@@ -807,7 +1031,20 @@ void expect_have_dns_for_pubnub_origin()
 }
 
 
-static inline void expect_outgoing_with_url(char const* url)
+/** DNS resolution not yet available, so the request is not sent */
+void expect_wait_dns_for_pubnub_origin()
+{
+    expect(pbntf_enqueue_for_processing, when(pb, equals(pbp)), returns(0));
+    expect(pbntf_got_socket, when(pb, equals(pbp)), returns(+1));
+    expect(pbpal_resolv_and_connect,
+           when(pb, equals(pbp)),
+           returns(pbpal_resolv_sent));
+    expect(pbntf_watch_in_events, when(pb, equals(pbp)), returns(0));
+}
+
+
+static inline void expect_outgoing_with_url_and_fin_head(char const* url,
+                                                         char const* fin_head)
 {
     expect(pbpal_send_str, when(s, streqs("GET ")), returns(0));
     expect(pbpal_send_status, returns(0));
@@ -817,15 +1054,26 @@ static inline void expect_outgoing_with_url(char const* url)
     expect(pbpal_send_status, returns(0));
     expect(pbpal_send_str, when(s, streqs(PUBNUB_ORIGIN)), returns(0));
     expect(pbpal_send_status, returns(0));
-    expect(pbpal_send_str,
-           when(s,
-                streqs("\r\nUser-Agent: POSIX-PubNub-C-core/" PUBNUB_SDK_VERSION
-                       "\r\n" ACCEPT_ENCODING "\r\n")),
-           returns(0));
+    expect(pbpal_send_str, when(s, streqs(fin_head)), returns(0));
     expect(pbpal_send_status, returns(0));
     expect(pbntf_watch_in_events, when(pb, equals(pbp)), returns(0));
 }
 
+static inline void expect_outgoing_with_url(char const* url)
+{
+    expect_outgoing_with_url_and_fin_head(
+        url,
+        "\r\nUser-Agent: POSIX-PubNub-C-core/" PUBNUB_SDK_VERSION
+        "\r\n" ACCEPT_ENCODING "\r\n");
+}
+
+/** Streamed responses are not to be compressed */
+static inline void expect_outgoing_uncompressed_with_url(char const* url)
+{
+    expect_outgoing_with_url_and_fin_head(
+        url, "\r\nUser-Agent: POSIX-PubNub-C-core/" PUBNUB_SDK_VERSION "\r\n\r\n");
+}
+
 
 static inline void incoming(char const* str, struct uint8_block* p_data)
 {
@@ -869,6 +1117,52 @@ static void cancel_and_cleanup(pubnub_t* pbp)
     attest(pbp->core.last_result, equals(PNR_CANCELLED));
 }
 
+/** Expects a (whole) page of a pager to be fetched on @p ctx, on
+    the connection @p kept_alive from the previous page, or a new one
+ */
+static void expect_page(pubnub_t*   ctx,
+                        bool        kept_alive,
+                        char const* url,
+                        char const* fin_head,
+                        char const* response)
+{
+    expect(pbntf_enqueue_for_processing, when(pb, equals(ctx)), returns(0));
+    if (!kept_alive) {
+        expect(pbpal_resolv_and_connect,
+               when(pb, equals(ctx)),
+               returns(pbpal_connect_success));
+    }
+    expect(pbntf_got_socket, when(pb, equals(ctx)), returns(0));
+    expect(pbpal_send_str, when(s, streqs("GET ")), returns(0));
+    expect(pbpal_send_status, returns(0));
+    expect(pbpal_send_str, when(s, streqs(url)), returns(0));
+    expect(pbpal_send_status, returns(0));
+    expect(pbpal_send, when(data, streqs(" HTTP/1.1\r\nHost: ")), returns(0));
+    expect(pbpal_send_status, returns(0));
+    expect(pbpal_send_str, when(s, streqs(PUBNUB_ORIGIN)), returns(0));
+    expect(pbpal_send_status, returns(0));
+    expect(pbpal_send_str, when(s, streqs(fin_head)), returns(0));
+    expect(pbpal_send_status, returns(0));
+    expect(pbntf_watch_in_events, when(pb, equals(ctx)), returns(0));
+    incoming(response, NULL);
+    expect(pbntf_lost_socket, when(pb, equals(ctx)));
+    expect(pbntf_trans_outcome, when(pb, equals(ctx)));
+}
+
+
+/** Frees the second context of a pager */
+static void free_prefetch_context(pubnub_t* ctx)
+{
+    if (ctx->state != PBS_IDLE) {
+        expect(pbpal_close, when(pb, equals(ctx)), returns(0));
+        expect(pbpal_closed, when(pb, equals(ctx)), returns(true));
+        expect(pbpal_forget, when(pb, equals(ctx)));
+    }
+    expect(pbntf_trans_outcome, when(pb, equals(ctx)));
+    expect(pbpal_free, when(pb, equals(ctx)));
+    attest(pubnub_free(ctx), equals(0));
+}
+
 /* -- LEAVE operation -- */
 Ensure(single_context_pubnub, leave_have_dns)
 {
@@ -1168,6 +1462,42 @@ Ensure(single_context_pubnub, time_in_progress)
     cancel_and_cleanup(pbp);
 }
 
+/* The request head, as sent in TLS early data, is the same as the one
+   sent piece by piece (see expect_outgoing_with_url()). It is
+   formatted before the connection is established, like here, while
+   DNS resolution is in progress. */
+Ensure(single_context_pubnub, request_head_is_the_one_sent)
+{
+    char        buf[256];
+    char const* head = "GET /time/0?pnsdk=unit-test-0.1 HTTP/1.1\r\nHost: " PUBNUB_ORIGIN
+                       "\r\nUser-Agent: POSIX-PubNub-C-core/" PUBNUB_SDK_VERSION
+                       "\r\n" ACCEPT_ENCODING "\r\n";
+
+    pubnub_init(pbp, "pubkey", "subkey");
+
+    expect_wait_dns_for_pubnub_origin();
+    attest(pubnub_time(pbp), equals(PNR_STARTED));
+
+    attest(pbnc_request_head(pbp, buf, sizeof buf), equals(strlen(head)));
+    attest(buf, streqs(head));
+    attest(pbnc_request_head(pbp, buf, strlen(head)), equals(0));
+    attest(pbnc_request_replayable(pbp), is_true);
+
+    cancel_and_cleanup(pbp);
+}
+
+Ensure(single_context_pubnub, request_of_publish_is_not_replayable)
+{
+    pubnub_init(pbp, "pubkey", "subkey");
+
+    expect_wait_dns_for_pubnub_origin();
+    attest(pubnub_publish(pbp, "jarak", "4443"), equals(PNR_STARTED));
+
+    attest(pbnc_request_replayable(pbp), is_false);
+
+    cancel_and_cleanup(pbp);
+}
+
 /* -- PUBLISH operation -- */
 
 
@@ -1299,6 +1629,83 @@ Ensure(single_context_pubnub, publish_msg_too_long)
     attest(pubnub_last_publish_result(pbp), streqs(""));
 }
 
+#if PUBNUB_DYNAMIC_HTTP_BUFFER
+/* More than 64 KB, as the positions of reading and sending used to be
+   tracked in 16 bits */
+#define LARGE_MSG_LEN 70000
+
+Ensure(single_context_pubnub, publish_msg_larger_than_64KB)
+{
+    char const url_start[] = "/publish/publkey/subkey/0/w/0/";
+    char const url_end[]   = "?pnsdk=unit-test-0.1";
+    char*      msg         = malloc(LARGE_MSG_LEN + 1);
+    char*      url = malloc(sizeof url_start + LARGE_MSG_LEN + sizeof url_end);
+
+    assert((msg != NULL) && (url != NULL));
+    memset(msg, 'A', LARGE_MSG_LEN);
+    msg[LARGE_MSG_LEN] = '\0';
+    strcpy(url, url_start);
+    strcat(url, msg);
+    strcat(url, url_end);
+
+    pubnub_init(pbp, "publkey", "subkey");
+    attest(pubnub_publish(pbp, "w", msg), equals(PNR_TX_BUFF_TOO_SMALL));
+    attest(pubnub_set_http_buffer_size(pbp, 256 * 1024), equals(0));
+
+    expect_have_dns_for_pubnub_origin();
+    expect_outgoing_with_url(url);
+    incoming("HTTP/1.1 200\r\nContent-Length: "
+             "30\r\n\r\n[1,\"Sent\",\"14178940800777403\"]",
+             NULL);
+    expect(pbntf_lost_socket, when(pb, equals(pbp)));
+    expect(pbntf_trans_outcome, when(pb, equals(pbp)));
+    attest(pubnub_publish(pbp, "w", msg), equals(PNR_OK));
+    attest(pubnub_last_publish_result(pbp), streqs("\"Sent\""));
+
+    free(url);
+    free(msg);
+}
+
+
+Ensure(single_context_pubnub, receive_reply_larger_than_64KB)
+{
+    char const head[] = "HTTP/1.1 200\r\nContent-Length: 70010\r\n\r\n[[\"";
+    char const tail[] = "\"],1,2]";
+    char*      response =
+        malloc(sizeof head - 1 + LARGE_MSG_LEN + sizeof tail);
+    char const* msg;
+
+    assert(response != NULL);
+    strcpy(response, head);
+    memset(response + sizeof head - 1, 'B', LARGE_MSG_LEN);
+    strcpy(response + sizeof head - 1 + LARGE_MSG_LEN, tail);
+
+    pubnub_init(pbp, "publhis", "subhis");
+    /* So that the whole response is received in one go */
+    attest(pubnub_set_http_buffer_size(pbp, 256 * 1024), equals(0));
+
+    expect_have_dns_for_pubnub_origin();
+    expect_outgoing_with_url("/v2/history/sub-key/subhis/channel/"
+                             "ch?pnsdk=unit-test-0.1&count=1&include_token="
+                             "false");
+    incoming(response, NULL);
+    expect(pbntf_lost_socket, when(pb, equals(pbp)));
+    expect(pbntf_trans_outcome, when(pb, equals(pbp)));
+    attest(pubnub_history(pbp, "ch", 1, false), equals(PNR_OK));
+
+    msg = pubnub_get(pbp);
+    attest(msg, is_non_null);
+    attest(strlen(msg), equals(LARGE_MSG_LEN + 4));
+    attest(strncmp(msg, "[\"B", 3), equals(0));
+    attest(msg + LARGE_MSG_LEN, streqs("BB\"]"));
+    attest(pubnub_get(pbp), streqs("1"));
+    attest(pubnub_get(pbp), streqs("2"));
+    attest(pubnub_get(pbp), equals(NULL));
+
+    free(response);
+}
+#endif /* PUBNUB_DYNAMIC_HTTP_BUFFER */
+
 
 Ensure(single_context_pubnub, publish_in_progress)
 {
@@ -1512,9 +1919,233 @@ Ensure(single_context_pubnub, history_bad_response)
     attest(pubnub_history(pbp, "ttt", 10, false), equals(PNR_FORMAT_ERROR));
 }
 
-/* -- ADVANCED HISTORY message_counts -- */
+/* -- ADVANCED HISTORY stream -- */
 
 #if PUBNUB_USE_ADVANCED_HISTORY
+Ensure(single_context_pubnub, history_stream_with_timetoken)
+{
+    struct pubnub_history_message msg;
+
+    pubnub_init(pbp, "publhis", "subhis");
+
+    expect_have_dns_for_pubnub_origin();
+    expect_outgoing_uncompressed_with_url(
+        "/v2/history/sub-key/subhis/channel/"
+        "ch?pnsdk=unit-test-0.1&count=22&include_token=true&start="
+        "14370863958459999");
+    incoming("HTTP/1.1 200\r\nTransfer-Encoding: chunked\r\n\r\n34\r\n"
+             "[[{\"message\":[1,\"]\"],\"timetoken\":14370863460777883},"
+             "\r\n",
+             NULL);
+    incoming("6b\r\n {\"message\":\"2,\\\"\",\"timetoken\":\"14370863461279046\"}"
+             ",{\"message\":{\"a\":3},\"timetoken\":14370863958459501}],1,2]"
+             "\r\n0\r\n\r\n",
+             NULL);
+    expect(pbntf_lost_socket, when(pb, equals(pbp)));
+    expect(pbntf_trans_outcome, when(pb, equals(pbp)));
+    attest(pubnub_history_stream(pbp, "ch", 22, true, "14370863958459999"),
+           equals(PNR_OK));
+
+    attest(pubnub_history_stream_next(pbp, &msg), equals(PNR_OK));
+    attest(strncmp(msg.message.ptr, "[1,\"]\"]", msg.message.size), equals(0));
+    attest(msg.tt_u64, equals(14370863460777883ULL));
+    attest(pubnub_history_stream_next(pbp, &msg), equals(PNR_OK));
+    attest(strncmp(msg.message.ptr, "\"2,\\\"\"", msg.message.size), equals(0));
+    attest(strncmp(msg.timetoken.ptr, "14370863461279046", msg.timetoken.size),
+           equals(0));
+    attest(pubnub_history_stream_next(pbp, &msg), equals(PNR_OK));
+    attest(strncmp(msg.message.ptr, "{\"a\":3}", msg.message.size), equals(0));
+    attest(pubnub_history_stream_next(pbp, &msg), equals(PNR_OK));
+    attest(msg.message.ptr, equals(NULL));
+    attest(pubnub_get(pbp), equals(NULL));
+    attest(pubnub_last_http_code(pbp), equals(200));
+}
+
+
+Ensure(single_context_pubnub, history_stream_bad_response)
+{
+    struct pubnub_history_message msg;
+
+    pubnub_init(pbp, "pubkey", "Xsub");
+
+    expect_have_dns_for_pubnub_origin();
+    expect_outgoing_uncompressed_with_url(
+        "/v2/history/sub-key/Xsub/channel/"
+        "ttt?pnsdk=unit-test-0.1&count=10&include_token=false");
+    incoming("HTTP/1.1 200\r\nContent-Length: 9\r\n\r\n[[1,2],{}", NULL);
+    expect(pbntf_lost_socket, when(pb, equals(pbp)));
+    expect(pbntf_trans_outcome, when(pb, equals(pbp)));
+    attest(pubnub_history_stream(pbp, "ttt", 10, false, NULL),
+           equals(PNR_FORMAT_ERROR));
+
+    attest(pubnub_history_stream_next(pbp, &msg), equals(PNR_OK));
+    attest(strncmp(msg.message.ptr, "1", msg.message.size), equals(0));
+    attest(msg.timetoken.ptr, equals(NULL));
+    attest(pubnub_history_stream_next(pbp, &msg), equals(PNR_OK));
+    attest(strncmp(msg.message.ptr, "2", msg.message.size), equals(0));
+    attest(pubnub_history_stream_next(pbp, &msg), equals(PNR_FORMAT_ERROR));
+}
+
+
+Ensure(single_context_pubnub, history_stream_request_head_is_uncompressed)
+{
+    char        buf[256];
+    char const* head = "GET /v2/history/sub-key/subhis/channel/"
+                       "ch?pnsdk=unit-test-0.1&count=5&include_token=false "
+                       "HTTP/1.1\r\nHost: " PUBNUB_ORIGIN
+                       "\r\nUser-Agent: POSIX-PubNub-C-core/" PUBNUB_SDK_VERSION
+                       "\r\n\r\n";
+
+    pubnub_init(pbp, "publhis", "subhis");
+
+    expect_wait_dns_for_pubnub_origin();
+    attest(pubnub_history_stream(pbp, "ch", 5, false, NULL), equals(PNR_STARTED));
+
+    attest(pbnc_request_head(pbp, buf, sizeof buf), equals(strlen(head)));
+    attest(buf, streqs(head));
+    attest(pbnc_request_replayable(pbp), is_true);
+
+    cancel_and_cleanup(pbp);
+}
+
+
+/** Expects a (whole) history page to be fetched on @p ctx */
+static void expect_history_page(pubnub_t*   ctx,
+                                bool        kept_alive,
+                                char const* url,
+                                char const* response)
+{
+    expect_page(ctx,
+                kept_alive,
+                url,
+                "\r\nUser-Agent: POSIX-PubNub-C-core/" PUBNUB_SDK_VERSION "\r\n\r\n",
+                response);
+}
+
+
+Ensure(single_context_pubnub, history_pager_goes_to_older_pages_until_a_short_one)
+{
+    struct pubnub_history_pager   pager;
+    struct pubnub_history_message msg;
+    pubnub_t*                     pbp_2 = pubnub_alloc();
+
+    attest(pbp_2, is_not_equal_to(NULL));
+    pubnub_origin_set(pbp_2, NULL);
+    pubnub_init(pbp, "pub", "sub");
+    pubnub_init(pbp_2, "pub", "sub");
+
+    expect_history_page(
+        pbp,
+        false,
+        "/v2/history/sub-key/sub/channel/"
+        "ch?pnsdk=unit-test-0.1&count=2&include_token=true",
+        "HTTP/1.1 200\r\nContent-Length: 71\r\n\r\n"
+        "[[{\"message\":3,\"timetoken\":\"15\"},"
+        "{\"message\":4,\"timetoken\":\"16\"}],15,16]");
+    attest(pubnub_history_pager_start(&pager, pbp, pbp_2, "ch", 2),
+           equals(PNR_OK));
+    /* So that the next page is fetched while this one is taken */
+    attest(pbp->options.use_blocking_io, is_false);
+    attest(pbp_2->options.use_blocking_io, is_false);
+
+    /* The first message of a page gives the start of the next one */
+    expect_history_page(
+        pbp_2,
+        false,
+        "/v2/history/sub-key/sub/channel/"
+        "ch?pnsdk=unit-test-0.1&count=2&include_token=true&start=15",
+        "HTTP/1.1 200\r\nContent-Length: 40\r\n\r\n"
+        "[[{\"message\":2,\"timetoken\":\"14\"}],14,14]");
+    attest(pubnub_history_pager_next(&pager, &msg), equals(PNR_OK));
+    attest(strncmp(msg.message.ptr, "3", msg.message.size), equals(0));
+    attest(pubnub_history_pager_next(&pager, &msg), equals(PNR_OK));
+    attest(strncmp(msg.message.ptr, "4", msg.message.size), equals(0));
+
+    expect_history_page(
+        pbp,
+        true,
+        "/v2/history/sub-key/sub/channel/"
+        "ch?pnsdk=unit-test-0.1&count=2&include_token=true&start=14",
+        "HTTP/1.1 200\r\nContent-Length: 8\r\n\r\n[[],0,0]");
+    attest(pubnub_history_pager_next(&pager, &msg), equals(PNR_OK));
+    attest(strncmp(msg.message.ptr, "2", msg.message.size), equals(0));
+
+    /* Not a full page, so the last one */
+    attest(pubnub_history_pager_next(&pager, &msg), equals(PNR_OK));
+    attest(msg.message.ptr, equals(NULL));
+    attest(pubnub_history_pager_next(&pager, &msg), equals(PNR_OK));
+    attest(msg.message.ptr, equals(NULL));
+    attest(pbp->options.use_blocking_io, is_true);
+    attest(pbp_2->options.use_blocking_io, is_true);
+
+    free_prefetch_context(pbp_2);
+}
+
+
+Ensure(single_context_pubnub, history_pager_ends_on_an_empty_page)
+{
+    struct pubnub_history_pager   pager;
+    struct pubnub_history_message msg;
+    pubnub_t*                     pbp_2 = pubnub_alloc();
+
+    attest(pbp_2, is_not_equal_to(NULL));
+    pubnub_origin_set(pbp_2, NULL);
+    pubnub_init(pbp, "pub", "sub");
+    pubnub_init(pbp_2, "pub", "sub");
+
+    expect_history_page(
+        pbp,
+        false,
+        "/v2/history/sub-key/sub/channel/"
+        "ch?pnsdk=unit-test-0.1&count=1&include_token=true",
+        "HTTP/1.1 200\r\nContent-Length: 40\r\n\r\n"
+        "[[{\"message\":1,\"timetoken\":\"15\"}],15,15]");
+    attest(pubnub_history_pager_start(&pager, pbp, pbp_2, "ch", 1),
+           equals(PNR_OK));
+
+    expect_history_page(
+        pbp_2,
+        false,
+        "/v2/history/sub-key/sub/channel/"
+        "ch?pnsdk=unit-test-0.1&count=1&include_token=true&start=15",
+        "HTTP/1.1 200\r\nContent-Length: 8\r\n\r\n[[],0,0]");
+    attest(pubnub_history_pager_next(&pager, &msg), equals(PNR_OK));
+    attest(strncmp(msg.message.ptr, "1", msg.message.size), equals(0));
+
+    attest(pubnub_history_pager_next(&pager, &msg), equals(PNR_OK));
+    attest(msg.message.ptr, equals(NULL));
+
+    free_prefetch_context(pbp_2);
+}
+
+
+Ensure(single_context_pubnub, history_pager_limits_page_size)
+{
+    struct pubnub_history_pager   pager;
+    struct pubnub_history_message msg;
+    pubnub_t*                     pbp_2 = pubnub_alloc();
+
+    attest(pbp_2, is_not_equal_to(NULL));
+    pubnub_init(pbp, "pub", "sub");
+    pubnub_init(pbp_2, "pub", "sub");
+
+    expect_history_page(
+        pbp,
+        false,
+        "/v2/history/sub-key/sub/channel/"
+        "ch?pnsdk=unit-test-0.1&count=100&include_token=true",
+        "HTTP/1.1 200\r\nContent-Length: 8\r\n\r\n[[],0,0]");
+    attest(pubnub_history_pager_start(&pager, pbp, pbp_2, "ch", 1000),
+           equals(PNR_OK));
+
+    attest(pubnub_history_pager_next(&pager, &msg), equals(PNR_OK));
+    attest(msg.message.ptr, equals(NULL));
+
+    free_prefetch_context(pbp_2);
+}
+
+/* -- ADVANCED HISTORY message_counts -- */
+
 Ensure(single_context_pubnub, gets_advanced_history_message_counts_for_two_channels_since_timetoken)
 {
     size_t io_count = 2;
@@ -1588,6 +2219,66 @@ Ensure(single_context_pubnub, gets_message_counts_for_two_channels_since_channel
     attest(pubnub_last_http_code(pbp), equals(200));
 }
 
+Ensure(single_context_pubnub, iterates_advanced_history_message_counts)
+{
+    struct pubnub_chan_msg_count counter;
+
+    pubnub_init(pbp, "pub-nina", "sub-pinta");
+
+    expect_have_dns_for_pubnub_origin();
+
+    expect_outgoing_with_url("/v3/history/sub-key/sub-pinta/message-counts/"
+                             "some,bad,other?pnsdk=unit-test-0.1&timetoken=14378854953886727");
+    incoming("HTTP/1.1 200\r\nContent-Length: 98\r\n\r\n"
+             "{\"status\":200, \"error\": false, \"error_message\": \"\", \"channels\": {\"some\":1, \"bad\":-2,\"other\" : 50}}",
+             NULL);
+    expect(pbntf_lost_socket, when(pb, equals(pbp)));
+    expect(pbntf_trans_outcome, when(pb, equals(pbp)));
+    attest(pubnub_message_counts(pbp, "some,bad,other", "14378854953886727"), equals(PNR_OK));
+
+    counter = pubnub_get_chan_msg_count(pbp);
+    attest(strncmp(counter.channel.ptr, "some", counter.channel.size), equals(0));
+    attest(counter.channel.size, equals(4));
+    attest(counter.message_count, equals(1));
+    counter = pubnub_get_chan_msg_count(pbp);
+    attest(strncmp(counter.channel.ptr, "other", counter.channel.size), equals(0));
+    attest(counter.channel.size, equals(5));
+    attest(counter.message_count, equals(50));
+    counter = pubnub_get_chan_msg_count(pbp);
+    attest(counter.channel.ptr, equals(NULL));
+
+    attest(pubnub_last_http_code(pbp), equals(200));
+}
+
+
+Ensure(single_context_pubnub, gets_message_counts_for_many_channels)
+{
+    int o_count[10];
+
+    pubnub_init(pbp, "pub-nina", "sub-pinta");
+
+    expect_have_dns_for_pubnub_origin();
+
+    expect_outgoing_with_url("/v3/history/sub-key/sub-pinta/message-counts/"
+                             "ch0,ch1,ch2,ch3,ch4,ch5,ch6,ch7,ch8,ch9?pnsdk=unit-test-0.1&timetoken=14378854953886727");
+    incoming("HTTP/1.1 200\r\nContent-Length: 105\r\n\r\n"
+             "{\"status\":200, \"error\": false, \"error_message\": \"\", \"channels\": {\"ch9\":9,\"ch0\":0,\"ch4\":4,\"ch7\":7,\"xy\":1}}",
+             NULL);
+    expect(pbntf_lost_socket, when(pb, equals(pbp)));
+    expect(pbntf_trans_outcome, when(pb, equals(pbp)));
+    attest(pubnub_message_counts(pbp, "ch0,ch1,ch2,ch3,ch4,ch5,ch6,ch7,ch8,ch9", "14378854953886727"), equals(PNR_OK));
+
+    attest(pubnub_get_message_counts(pbp, "ch0,ch1,ch2,ch3,ch4,ch5,ch6,ch7,ch8,ch9", o_count), equals(0));
+    attest(o_count[0], equals(0));
+    attest(o_count[1] < 0, is_true);
+    attest(o_count[4], equals(4));
+    attest(o_count[7], equals(7));
+    attest(o_count[8] < 0, is_true);
+    attest(o_count[9], equals(9));
+
+    attest(pubnub_last_http_code(pbp), equals(200));
+}
+
 Ensure(single_context_pubnub,
        get_message_counts_gets_message_counts_for_three_channels_since_channel_timetokens)
 {
@@ -1909,6 +2600,202 @@ Ensure(single_context_pubnub,
 
 #endif /* -- ADVANCED HISTORY message_counts -- */
 
+/* -- OBJECTS API data elements and pager -- */
+
+#if PUBNUB_USE_OBJECTS_API
+
+/** Expects a (whole) Objects API response to be fetched on @p ctx */
+static void expect_objects_page(pubnub_t*   ctx,
+                                bool        kept_alive,
+                                char const* url,
+                                char const* response)
+{
+    expect_page(ctx,
+                kept_alive,
+                url,
+                "\r\nUser-Agent: POSIX-PubNub-C-core/" PUBNUB_SDK_VERSION
+                "\r\n" ACCEPT_ENCODING "\r\n",
+                response);
+}
+
+
+static bool chamebl_equals(pubnub_chamebl_t block, char const* str)
+{
+    return (block.ptr != NULL) && (block.size == strlen(str))
+           && (0 == memcmp(block.ptr, str, block.size));
+}
+
+
+Ensure(single_context_pubnub, objects_data_elements_of_an_array)
+{
+    pubnub_chamebl_t cursor;
+
+    pubnub_init(pbp, "pub", "sub");
+
+    expect_objects_page(
+        pbp,
+        false,
+        "/v1/objects/sub/users?pnsdk=unit-test-0.1&limit=2",
+        "HTTP/1.1 200\r\nContent-Length: 70\r\n\r\n"
+        "{\"status\":200,\"data\":[{\"id\":\"a\"}, {\"id\":\"b\"}],"
+        "\"next\":\"Mg\",\"prev\":\"MQ\"}");
+    attest(pubnub_get_users(pbp, NULL, 0, 2, NULL, NULL, pbccNotSet), equals(PNR_OK));
+
+    attest(chamebl_equals(pubnub_get_objects_data_element(pbp), "{\"id\":\"a\"}"),
+           is_true);
+    attest(chamebl_equals(pubnub_get_objects_data_element(pbp), "{\"id\":\"b\"}"),
+           is_true);
+    attest(pubnub_get_objects_data_element(pbp).ptr, equals(NULL));
+    attest(pubnub_get_objects_data_element(pbp).ptr, equals(NULL));
+
+    attest(pubnub_get_objects_next_cursor(pbp, &cursor), equals(0));
+    attest(chamebl_equals(cursor, "Mg"), is_true);
+    attest(pubnub_get_objects_prev_cursor(pbp, &cursor), equals(0));
+    attest(chamebl_equals(cursor, "MQ"), is_true);
+}
+
+
+Ensure(single_context_pubnub, objects_data_element_of_a_single_object)
+{
+    pubnub_chamebl_t cursor;
+
+    pubnub_init(pbp, "pub", "sub");
+
+    expect_objects_page(
+        pbp,
+        false,
+        "/v1/objects/sub/users/a?pnsdk=unit-test-0.1",
+        "HTTP/1.1 200\r\nContent-Length: 40\r\n\r\n"
+        "{\"status\":200,\"data\":{\"id\":\"a\",\"x\":[1]}}");
+    attest(pubnub_get_user(pbp, NULL, 0, "a"), equals(PNR_OK));
+
+    attest(chamebl_equals(pubnub_get_objects_data_element(pbp),
+                          "{\"id\":\"a\",\"x\":[1]}"),
+           is_true);
+    attest(pubnub_get_objects_data_element(pbp).ptr, equals(NULL));
+
+    attest(pubnub_get_objects_next_cursor(pbp, &cursor), equals(-1));
+    attest(pubnub_get_objects_prev_cursor(pbp, &cursor), equals(-1));
+}
+
+
+Ensure(single_context_pubnub, objects_data_elements_of_an_empty_page)
+{
+    pubnub_chamebl_t cursor;
+
+    pubnub_init(pbp, "pub", "sub");
+
+    expect_objects_page(pbp,
+                        false,
+                        "/v1/objects/sub/spaces?pnsdk=unit-test-0.1",
+                        "HTTP/1.1 200\r\nContent-Length: 37\r\n\r\n"
+                        "{\"status\":200,\"data\":[ ],\"prev\":\"MQ\"}");
+    attest(pubnub_get_spaces(pbp, NULL, 0, 0, NULL, NULL, pbccNotSet), equals(PNR_OK));
+
+    attest(pubnub_get_objects_data_element(pbp).ptr, equals(NULL));
+    attest(pubnub_get_objects_next_cursor(pbp, &cursor), equals(-1));
+    attest(pubnub_get_objects_prev_cursor(pbp, &cursor), equals(0));
+    attest(chamebl_equals(cursor, "MQ"), is_true);
+}
+
+
+Ensure(single_context_pubnub, objects_data_elements_not_while_in_progress)
+{
+    pubnub_chamebl_t cursor;
+
+    pubnub_init(pbp, "pub", "sub");
+
+    expect_wait_dns_for_pubnub_origin();
+    attest(pubnub_get_users(pbp, NULL, 0, 0, NULL, NULL, pbccNotSet),
+           equals(PNR_STARTED));
+
+    attest(pubnub_get_objects_data_element(pbp).ptr, equals(NULL));
+    attest(pubnub_get_objects_next_cursor(pbp, &cursor), equals(-1));
+
+    cancel_and_cleanup(pbp);
+}
+
+
+Ensure(single_context_pubnub, objects_pager_goes_to_next_pages_until_one_without_a_cursor)
+{
+    struct pubnub_objects_pager pager;
+    pubnub_chamebl_t            elem;
+    pubnub_t*                   pbp_2 = pubnub_alloc();
+
+    attest(pbp_2, is_not_equal_to(NULL));
+    pubnub_origin_set(pbp_2, NULL);
+    pubnub_init(pbp, "pub", "sub");
+    pubnub_init(pbp_2, "pub", "sub");
+
+    expect_objects_page(
+        pbp,
+        false,
+        "/v1/objects/sub/users?pnsdk=unit-test-0.1&limit=2",
+        "HTTP/1.1 200\r\nContent-Length: 57\r\n\r\n"
+        "{\"status\":200,\"data\":[{\"id\":\"a\"},{\"id\":\"b\"}],\"next\":\"Mg\"}");
+    attest(pubnub_objects_pager_start(&pager, pbp, pbp_2, pbolUsers, NULL, NULL, 0, 2),
+           equals(PNR_OK));
+
+    /* Once a page is received, the next one is fetched with its cursor */
+    expect_objects_page(
+        pbp_2,
+        false,
+        "/v1/objects/sub/users?pnsdk=unit-test-0.1&limit=2&start=Mg",
+        "HTTP/1.1 200\r\nContent-Length: 46\r\n\r\n"
+        "{\"status\":200,\"data\":[{\"id\":\"c\"}],\"prev\":\"MQ\"}");
+    attest(pubnub_objects_pager_next(&pager, &elem), equals(PNR_OK));
+    attest(chamebl_equals(elem, "{\"id\":\"a\"}"), is_true);
+    attest(pubnub_objects_pager_next(&pager, &elem), equals(PNR_OK));
+    attest(chamebl_equals(elem, "{\"id\":\"b\"}"), is_true);
+    attest(pubnub_objects_pager_next(&pager, &elem), equals(PNR_OK));
+    attest(chamebl_equals(elem, "{\"id\":\"c\"}"), is_true);
+
+    /* No "next" cursor, so the last page */
+    attest(pubnub_objects_pager_next(&pager, &elem), equals(PNR_OK));
+    attest(elem.ptr, equals(NULL));
+    attest(pubnub_objects_pager_next(&pager, &elem), equals(PNR_OK));
+    attest(elem.ptr, equals(NULL));
+
+    free_prefetch_context(pbp_2);
+}
+
+
+Ensure(single_context_pubnub, objects_pager_ends_on_an_empty_page)
+{
+    struct pubnub_objects_pager pager;
+    pubnub_chamebl_t            elem;
+    pubnub_t*                   pbp_2 = pubnub_alloc();
+
+    attest(pbp_2, is_not_equal_to(NULL));
+    pubnub_origin_set(pbp_2, NULL);
+    pubnub_init(pbp, "pub", "sub");
+    pubnub_init(pbp_2, "pub", "sub");
+
+    expect_objects_page(
+        pbp,
+        false,
+        "/v1/objects/sub/users/u/spaces?pnsdk=unit-test-0.1",
+        "HTTP/1.1 200\r\nContent-Length: 46\r\n\r\n"
+        "{\"status\":200,\"data\":[{\"id\":\"a\"}],\"next\":\"Mg\"}");
+    attest(pubnub_objects_pager_start(&pager, pbp, pbp_2, pbolMemberships, "u", NULL, 0, 0),
+           equals(PNR_OK));
+
+    expect_objects_page(pbp_2,
+                        false,
+                        "/v1/objects/sub/users/u/spaces?pnsdk=unit-test-0.1&start=Mg",
+                        "HTTP/1.1 200\r\nContent-Length: 36\r\n\r\n"
+                        "{\"status\":200,\"data\":[],\"next\":\"Mw\"}");
+    attest(pubnub_objects_pager_next(&pager, &elem), equals(PNR_OK));
+    attest(chamebl_equals(elem, "{\"id\":\"a\"}"), is_true);
+
+    /* Even with a "next" cursor, an empty page is the last one */
+    attest(pubnub_objects_pager_next(&pager, &elem), equals(PNR_OK));
+    attest(elem.ptr, equals(NULL));
+
+    free_prefetch_context(pbp_2);
+}
+#endif /* PUBNUB_USE_OBJECTS_API */
+
 /* -- SET_STATE operation -- */
 
 
@@ -3082,6 +3969,8 @@ Ensure(single_context_pubnub, subscribe)
     expect(pbntf_trans_outcome, when(pb, equals(pbp)));
     attest(pubnub_subscribe(pbp, "health", NULL), equals(PNR_OK));
     attest(pubnub_last_time_token(pbp), streqs("1516714978925123457"));
+    attest(pubnub_last_time_token_u64(pbp) == UINT64_C(1516714978925123457),
+           is_true);
 
     attest(pubnub_get(pbp), streqs("pomegranate_juice"));
     attest(pubnub_get(pbp), streqs("papaya"));
@@ -3091,6 +3980,31 @@ Ensure(single_context_pubnub, subscribe)
     attest(pubnub_last_http_code(pbp), equals(200));
 }
 
+Ensure(single_context_pubnub, subscribe_get_batch)
+{
+    char const* msgs[2];
+
+    pubnub_init(pbp, "publ-magazin", "sub-magazin");
+    expect_have_dns_for_pubnub_origin();
+    expect_outgoing_with_url(
+        "/subscribe/sub-magazin/health/0/0?pnsdk=unit-test-0.1");
+    incoming("HTTP/1.1 200\r\nContent-Length: "
+             "56\r\n\r\n[[pomegranate_juice,papaya,mango],"
+             "\"1516714978925123457\"]",
+             NULL);
+    expect(pbntf_lost_socket, when(pb, equals(pbp)));
+    expect(pbntf_trans_outcome, when(pb, equals(pbp)));
+    attest(pubnub_subscribe(pbp, "health", NULL), equals(PNR_OK));
+
+    attest(pubnub_get_batch(pbp, msgs, 2), equals(2));
+    attest(msgs[0], streqs("pomegranate_juice"));
+    attest(msgs[1], streqs("papaya"));
+    attest(pubnub_get_batch(pbp, msgs, 2), equals(1));
+    attest(msgs[0], streqs("mango"));
+    attest(pubnub_get_batch(pbp, msgs, 2), equals(0));
+    attest(pubnub_get(pbp), equals(NULL));
+}
+
 Ensure(single_context_pubnub, subscribe_channel_groups)
 {
     pubnub_init(pbp, "publ-bulletin", "sub-bulletin");
@@ -3368,6 +4282,135 @@ Ensure(single_context_pubnub, subscribe_parse_response_format_error)
            equals(PNR_FORMAT_ERROR));
 }
 
+#if PUBNUB_USE_SUBSCRIBE_V2
+static void subscribe_v2_to_fruits(void)
+{
+    pubnub_init(pbp, "publ-magazin", "sub-magazin");
+    expect_have_dns_for_pubnub_origin();
+    expect_outgoing_with_url("/v2/subscribe/sub-magazin/ch/0?tt=0"
+                             "&pnsdk=unit-test-0.1&tr=0&uuid=&heartbeat=270");
+    incoming("HTTP/1.1 200\r\nContent-Length: 195\r\n\r\n"
+             "{\"t\":{\"t\":\"15628652479932717\",\"r\":4},\"m\":["
+             "{\"c\":\"ch\",\"d\":\"kiwi\",\"p\":{\"t\":\"15628652479933927\"}},"
+             "{\"c\":\"ch\",\"d\":7,\"e\":1,"
+             "\"p\":{\"t\":\"15628652479933928\",\"r\":4}},"
+             "{\"c\":\"ch\",\"d\":\"fig\",\"u\":1,\"p\":{\"t\":\"1\"}}]}",
+             NULL);
+    expect(pbntf_lost_socket, when(pb, equals(pbp)));
+    expect(pbntf_trans_outcome, when(pb, equals(pbp)));
+    attest(pubnub_subscribe_v2(pbp, "ch", pubnub_subscribe_v2_defopts()),
+           equals(PNR_OK));
+}
+
+static bool mem_block_equals(struct pubnub_char_mem_block block, char const* str)
+{
+    return (block.ptr != NULL) && (block.size == strlen(str))
+           && (0 == strncmp(block.ptr, str, block.size));
+}
+
+Ensure(single_context_pubnub, subscribe_v2_message_count)
+{
+    pubnub_init(pbp, "publ-magazin", "sub-magazin");
+    attest(pubnub_v2_message_count(pbp), equals(0));
+
+    subscribe_v2_to_fruits();
+    attest(pubnub_last_time_token(pbp), streqs("15628652479932717"));
+    attest(pubnub_v2_message_count(pbp), equals(3));
+
+    /* Getting the messages doesn't change the count */
+    attest(mem_block_equals(pubnub_get_v2(pbp).payload, "\"kiwi\""), is_true);
+    attest(pubnub_v2_message_count(pbp), equals(3));
+    while (pubnub_get_v2(pbp).payload.ptr != NULL) {
+    }
+    attest(pubnub_v2_message_count(pbp), equals(3));
+
+    /* Next transaction drops the index */
+    expect(pbntf_enqueue_for_processing, when(pb, equals(pbp)), returns(0));
+    expect(pbntf_got_socket, when(pb, equals(pbp)), returns(0));
+    expect_outgoing_with_url("/time/0?pnsdk=unit-test-0.1");
+    incoming("HTTP/1.1 200\r\nContent-Length: 9\r\n\r\n[1643405]", NULL);
+    expect(pbntf_lost_socket, when(pb, equals(pbp)));
+    expect(pbntf_trans_outcome, when(pb, equals(pbp)));
+    attest(pubnub_time(pbp), equals(PNR_OK));
+    attest(pubnub_v2_message_count(pbp), equals(0));
+}
+
+Ensure(single_context_pubnub, subscribe_v2_get_at)
+{
+    struct pubnub_v2_message msg;
+
+    subscribe_v2_to_fruits();
+
+    msg = pubnub_get_v2_at(pbp, 1);
+    attest(mem_block_equals(msg.payload, "7"), is_true);
+    attest(mem_block_equals(msg.channel, "ch"), is_true);
+    attest(mem_block_equals(msg.tt, "15628652479933928"), is_true);
+    attest(msg.tt_u64 == UINT64_C(15628652479933928), is_true);
+    attest(msg.message_type, equals(pbsbSignal));
+    attest(msg.region, equals(4));
+    attest(msg.metadata.ptr, equals(NULL));
+
+    msg = pubnub_get_v2_at(pbp, 2);
+    attest(mem_block_equals(msg.payload, "\"fig\""), is_true);
+    attest(mem_block_equals(msg.metadata, "1"), is_true);
+    attest(msg.message_type, equals(pbsbPublished));
+
+    attest(pubnub_get_v2_at(pbp, 3).payload.ptr, equals(NULL));
+
+    /* Random access doesn't move the sequential one, and vice versa */
+    attest(mem_block_equals(pubnub_get_v2(pbp).payload, "\"kiwi\""), is_true);
+    attest(mem_block_equals(pubnub_get_v2_at(pbp, 0).payload, "\"kiwi\""),
+           is_true);
+    attest(mem_block_equals(pubnub_get_v2(pbp).payload, "7"), is_true);
+    attest(mem_block_equals(pubnub_get_v2(pbp).payload, "\"fig\""), is_true);
+    attest(pubnub_get_v2(pbp).payload.ptr, equals(NULL));
+    attest(mem_block_equals(pubnub_get_v2_at(pbp, 2).payload, "\"fig\""), is_true);
+}
+
+Ensure(single_context_pubnub, subscribe_v2_get_batch)
+{
+    struct pubnub_v2_message msgs[3];
+
+    subscribe_v2_to_fruits();
+
+    attest(pubnub_get_v2_batch(pbp, msgs, 2), equals(2));
+    attest(mem_block_equals(msgs[0].payload, "\"kiwi\""), is_true);
+    attest(msgs[0].tt_u64 == UINT64_C(15628652479933927), is_true);
+    attest(mem_block_equals(msgs[1].payload, "7"), is_true);
+    attest(msgs[1].message_type, equals(pbsbSignal));
+    attest(pubnub_get_v2_batch(pbp, msgs, 3), equals(1));
+    attest(mem_block_equals(msgs[0].payload, "\"fig\""), is_true);
+    attest(mem_block_equals(msgs[0].metadata, "1"), is_true);
+    attest(pubnub_get_v2_batch(pbp, msgs, 3), equals(0));
+}
+
+Ensure(single_context_pubnub, subscribe_v2_get_batch_skips_invalid_messages)
+{
+    struct pubnub_v2_message msgs[3];
+
+    pubnub_init(pbp, "publ-magazin", "sub-magazin");
+    expect_have_dns_for_pubnub_origin();
+    expect_outgoing_with_url("/v2/subscribe/sub-magazin/ch/0?tt=0"
+                             "&pnsdk=unit-test-0.1&tr=0&uuid=&heartbeat=270");
+    incoming("HTTP/1.1 200\r\nContent-Length: 187\r\n\r\n"
+             "{\"t\":{\"t\":\"15628652479932717\",\"r\":4},\"m\":["
+             "{\"c\":\"ch\",\"d\":\"kiwi\",\"p\":{\"t\":\"15628652479933927\"}},"
+             "{\"c\":\"ch\",\"p\":{\"t\":\"15628652479933928\"}},"
+             "{\"c\":\"ch\",\"d\":\"fig\",\"p\":{\"t\":\"15628652479933929\"}}]}",
+             NULL);
+    expect(pbntf_lost_socket, when(pb, equals(pbp)));
+    expect(pbntf_trans_outcome, when(pb, equals(pbp)));
+    attest(pubnub_subscribe_v2(pbp, "ch", pubnub_subscribe_v2_defopts()),
+           equals(PNR_OK));
+
+    attest(pubnub_get_v2_batch(pbp, msgs, 3), equals(2));
+    attest(mem_block_equals(msgs[0].payload, "\"kiwi\""), is_true);
+    attest(mem_block_equals(msgs[1].payload, "\"fig\""), is_true);
+    attest(msgs[1].tt_u64 == UINT64_C(15628652479933929), is_true);
+    attest(pubnub_get_v2_batch(pbp, msgs, 3), equals(0));
+}
+#endif /* PUBNUB_USE_SUBSCRIBE_V2 */
+
 Ensure(single_context_pubnub, subscribe_reestablishing_broken_keep_alive_conection)
 {
     pubnub_init(pbp, "publ-key", "sub-Key");
@@ -4936,6 +5979,8 @@ Ensure(single_context_pubnub, illegal_context_fires_assert)
     pubnub_assert_set_handler((pubnub_assert_handler_t)test_assert_handler);
 
     expect_assert_in(pubnub_init(NULL, "k", "u"), "pubnub_pubsubapi.c");
+    /* Not every allocator makes the context ready for transactions */
+    pubnub_init(pbp, "k", "u");
     expect_assert_in(pubnub_publish(NULL, "x", "0"), "pubnub_pubsubapi.c");
     expect_assert_in(pubnub_last_publish_result(NULL), "pubnub_pubsubapi.c");
     expect_assert_in(pubnub_history(NULL, "ch", 22, true), "pubnub_coreapi.c");
@@ -4977,8 +6022,14 @@ Ensure(single_context_pubnub, illegal_context_fires_assert)
                      "pubnub_pubsubapi.c");
     expect_assert_in(pubnub_origin_set(NULL, "origin_server"), "pubnub_pubsubapi.c");
     expect_assert_in(pubnub_get_origin(NULL), "pubnub_pubsubapi.c");
+#if PUBNUB_DYNAMIC_HTTP_BUFFER
+    /* The dynamic HTTP buffer is tested with the "standard" allocator */
+    expect_assert_in(pubnub_free((pubnub_t*)((char*)pbp + 10000)),
+                     "pubnub_alloc_std.c");
+#else
     expect_assert_in(pubnub_free((pubnub_t*)((char*)pbp + 10000)),
                      "pubnub_alloc_static.c");
+#endif
 #if PUBNUB_USE_ADVANCED_HISTORY
     expect_assert_in(pubnub_get_error_message(NULL, o_msg), "pubnub_advanced_history.c");
     expect_assert_in(pubnub_get_chan_msg_counts_size(NULL), "pubnub_advanced_history.c");
@@ -45,13 +45,19 @@ enum pubnub_res pubnub_publish_ex(pubnub_t*                     pb,
 #if PUBNUB_CRYPTO_API
     if (NULL != opts.cipher_key) {
         pubnub_bymebl_t to_encrypt;
-        char* encrypted_msg = pb->core.encrypted_msg_buf;
-        size_t          n  = sizeof pb->core.encrypted_msg_buf - sizeof("\"\"");
+        char*           encrypted_msg;
+        size_t          n = PBCC_HTTP_BUF_SIZE(&pb->core) - sizeof("\"\"");
 
+        if (!pbcc_ensure_encrypted_msg_buf(&pb->core)) {
+            pubnub_mutex_unlock(pb->monitor);
+            return PNR_OUT_OF_MEMORY;
+        }
+        encrypted_msg    = pb->core.encrypted_msg_buf;
         to_encrypt.ptr   = (uint8_t*)message;
         to_encrypt.size  = strlen(message);
         encrypted_msg[0] = '"';
         if (0 != pubnub_encrypt(opts.cipher_key, to_encrypt, encrypted_msg + 1, &n)) {
+            pubnub_mutex_unlock(pb->monitor);
             return PNR_INTERNAL_ERROR;
         }
         encrypted_msg[++n] = '"';
@@ -2,6 +2,7 @@
 #include "core/pubnub_crypto.h"
 
 #include "core/pubnub_assert.h"
+#include "core/pbmem.h"
 #include "pubnub_internal.h"
 #include "core/pubnub_pubsubapi.h"
 #include "core/pubnub_coreapi_ex.h"
@@ -89,7 +90,7 @@ int pubnub_encrypt(char const *cipher_key, pubnub_bymebl_t msg, char *base64_str
         return -1;
     }
     result = pbbase64_encode_std(encrypted, base64_str, n);
-    free(encrypted.ptr);
+    pbmem_free_user(encrypted.ptr);
 
     return result;
 }
@@ -122,7 +123,7 @@ int pubnub_decrypt(char const *cipher_key, char const *base64_str, pubnub_bymebl
 
         decoded.ptr[decoded.size] = '\0';
         result = pbaes256_decrypt(decoded, key, iv, data);
-        free(decoded.ptr);
+        pbmem_free_user(decoded.ptr);
 
         return result;
     }
@@ -160,7 +161,7 @@ pubnub_bymebl_t pubnub_decrypt_alloc(char const *cipher_key, char const *base64_
 
         decoded.ptr[decoded.size] = '\0';
         result = pbaes256_decrypt_alloc(decoded, key, iv);
-        free(decoded.ptr);
+        pbmem_free_user(decoded.ptr);
 
         return result;
     }
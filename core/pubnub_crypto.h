@@ -88,6 +88,7 @@ int pubnub_decrypt_buffered(char const *cipher_key, char const *base64_str, pubn
     @param base64_str String to Base64 decode and decrypt
     @result Memory block (pointer and size) of the decoded and decrypted
     message. On failure, pointer will be NULL and size is undefined.
+    Free the memory with pubnub_free_memory().
 */
 pubnub_bymebl_t pubnub_decrypt_alloc(char const *cipher_key, char const *base64_str);
 
@@ -118,8 +119,8 @@ enum pubnub_res pubnub_get_decrypted(pubnub_t *pb, char const* cipher_key, char
 
 /** This function is very similar to pubnub_get_decrypted(), but it
     allocates the (memory for the) decrypted string and returns it as
-    its result. It is the caller's responsibility to free() thus
-    allocated string.
+    its result. It is the caller's responsibility to free thus
+    allocated string, with pubnub_free_memory().
 
     Thus, usage of this function can be simpler, as the user doesn't
     have to "guess" the size of the message. But, keep in mind that
@@ -98,6 +98,81 @@ char const* pbpal_resolv_n_connect_res_2_string(enum pbpal_resolv_n_connect_resu
 }
 
 
+uint64_t pubnub_timetoken_to_u64(char const* tt, size_t len)
+{
+    uint64_t rslt = 0;
+    size_t   i;
+
+    PUBNUB_ASSERT_OPT((tt != NULL) || (0 == len));
+
+    if ((len >= 2) && ('"' == tt[0]) && ('"' == tt[len - 1])) {
+        ++tt;
+        len -= 2;
+    }
+    if ((0 == len) || (len > PUBNUB_TIMETOKEN_U64_MAX_LEN)) {
+        return 0;
+    }
+    /* Up to 19 digits always fit, so check for overflow only on the
+       last of 20 */
+    for (i = 0; i < len; ++i) {
+        unsigned digit = (unsigned char)tt[i] - '0';
+        if (digit > 9) {
+            return 0;
+        }
+        if ((i == PUBNUB_TIMETOKEN_U64_MAX_LEN - 1)
+            && ((rslt > UINT64_MAX / 10) || (rslt * 10 > UINT64_MAX - digit))) {
+            return 0;
+        }
+        rslt = rslt * 10 + digit;
+    }
+
+    return rslt;
+}
+
+
+size_t pubnub_u64_to_timetoken(uint64_t tt, char* buf, size_t size)
+{
+    static char const digit_pairs[] = "00010203040506070809"
+                                      "10111213141516171819"
+                                      "20212223242526272829"
+                                      "30313233343536373839"
+                                      "40414243444546474849"
+                                      "50515253545556575859"
+                                      "60616263646566676869"
+                                      "70717273747576777879"
+                                      "80818283848586878889"
+                                      "90919293949596979899";
+    char   digits[PUBNUB_TIMETOKEN_U64_MAX_LEN];
+    char*  s = digits + sizeof digits;
+    size_t len;
+
+    PUBNUB_ASSERT_OPT((buf != NULL) || (0 == size));
+
+    /* Two digits at a time, from the end */
+    while (tt >= 100) {
+        unsigned pair = (unsigned)(tt % 100) * 2;
+        tt /= 100;
+        *--s = digit_pairs[pair + 1];
+        *--s = digit_pairs[pair];
+    }
+    if (tt >= 10) {
+        *--s = digit_pairs[tt * 2 + 1];
+        *--s = digit_pairs[tt * 2];
+    }
+    else {
+        *--s = (char)('0' + tt);
+    }
+    len = digits + sizeof digits - s;
+    if (len >= size) {
+        return 0;
+    }
+    memcpy(buf, s, len);
+    buf[len] = '\0';
+
+    return len;
+}
+
+
 #if PUBNUB_USE_SUBSCRIBE_V2
 char const* pubnub_msg_type_to_str(enum pubnub_message_type type)
 {
@@ -6,6 +6,8 @@
 #include "pubnub_api_types.h"
 #include "pbpal.h"
 
+#include <stdint.h>
+
 
 /** @file pubnub_helper.h 
 
@@ -56,6 +58,34 @@ char const* pubnub_res_2_string(enum pubnub_res e);
  */
 char const* pbpal_resolv_n_connect_res_2_string(enum pbpal_resolv_n_connect_result e);
 
+/** Maximum length of a time token (as a string), that is, of the
+    decimal representation of a 64-bit unsigned integer.
+ */
+#define PUBNUB_TIMETOKEN_U64_MAX_LEN 20
+
+/** Converts the time token @p tt, of length @p len, to an integer.
+    The time token may be quoted (as it is in JSON, for example, in
+    the time tokens of message actions), quotes are ignored.
+
+    Time tokens are integers (number of 100ns since the epoch), kept
+    as strings because not all platforms have 64-bit integers. Where
+    they do, comparing (sorting, checkpointing...) the integers is
+    much simpler and faster than comparing the strings.
+
+    @return The time token as an integer, 0 if @p tt is not a valid
+    time token (empty, not a decimal number or too large)
+ */
+uint64_t pubnub_timetoken_to_u64(char const* tt, size_t len);
+
+/** Writes the time token @p tt to @p buf (of size @p size) as
+    a (NUL terminated) string. To fit any time token, @p size should
+    be at least #PUBNUB_TIMETOKEN_U64_MAX_LEN + 1.
+
+    @return Length of the written string (excluding the NUL), 0 if
+    it doesn't fit into @p buf
+ */
+size_t pubnub_u64_to_timetoken(uint64_t tt, char* buf, size_t size);
+
 #if PUBNUB_USE_SUBSCRIBE_V2
 #include "pubnub_subscribe_v2_message.h"
 /** Returns a string literal describing enum value @p type
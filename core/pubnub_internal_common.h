@@ -199,6 +199,12 @@ struct pubnub_options {
     bool use_system_certificate_store : 1;
     /** Re-use SSL session on a new connection */
     bool reuse_SSL_session : 1;
+    /** Send the request of idempotent (GET) transactions as TLS 1.3
+        early data (0-RTT) when resuming a session that allows it */
+    bool use_tls_early_data : 1;
+    /** Offload TLS record encryption/decryption to the kernel (Linux
+        kTLS), if available */
+    bool use_ktls : 1;
 #endif
 };
 
@@ -206,6 +212,9 @@ struct pubnub_flags {
 #if PUBNUB_USE_SSL
     /** Try to establish TLS/SSL over existing TCP/IP connection: yes/no */
     bool trySSL : 1;
+    /** The whole request was sent as TLS early data and the server
+        accepted it, so there is nothing more to send */
+    bool sent_as_early_data : 1;
 #endif
     /** Should close connection */
     bool should_close : 1;
@@ -301,7 +310,7 @@ struct pubnub_ {
 
     /** The number of bytes we got (in our buffer) from network but
         have not processed yet. */
-    uint16_t unreadlen;
+    size_t unreadlen;
 
     /** Pointer to next byte to read from our buffer or next byte to
         send in the user-supplied send buffer.
@@ -309,13 +318,13 @@ struct pubnub_ {
     uint8_t* ptr;
 
     /** Number of bytes left (empty) in the read buffer */
-    uint16_t left;
+    size_t left;
 
     /** The state of the socket. */
     enum PBSocketState sock_state;
 
     /** Number of bytes to send or read - given by the user */
-    unsigned len;
+    size_t len;
 
     /** Indicates whether we are receiving chunked or regular HTTP
      * response
@@ -438,9 +447,15 @@ struct pubnub_ {
     */
     int proxy_tunnel_established;
 
-    /** The saved path part of the URL for the Pubnub transaction.
+    /** The saved path part of the URL for the Pubnub transaction,
+        sent instead of the one in the HTTP buffer (which gets
+        overwritten by the response from the proxy). Allocated on
+        first use, grown as needed.
      */
-    char proxy_saved_path[PUBNUB_BUF_MAXLEN];
+    char* proxy_saved_path;
+
+    /** The size of the memory allocated for the saved proxy path */
+    size_t proxy_saved_path_size;
 
     /** The length, in characters, of the saved proxy path */
     unsigned proxy_saved_path_len;
@@ -519,6 +534,20 @@ int pbntf_requeue_for_processing(pubnub_t* pb);
 int pbntf_watch_in_events(pubnub_t* pb);
 int pbntf_watch_out_events(pubnub_t* pb);
 
+#if !defined(PUBNUB_CALLBACK_API)
+/** Internal function, only available in the sync interface. Drives
+    the transaction on the context @p pb, like pubnub_await() does
+    (observing the transaction timeout), but only until @p progress
+    returns something other than #PNR_IN_PROGRESS, which is then
+    returned. @p progress is called (with @p data) before each step,
+    with the context locked. If the transaction ends and @p progress
+    still returns #PNR_IN_PROGRESS, returns the transaction outcome.
+*/
+enum pubnub_res pbntf_await_progress(pubnub_t* pb,
+                                     enum pubnub_res (*progress)(pubnub_t* pb, void* data),
+                                     void* data);
+#endif
+
 
 /** Internal function. Checks if the given pubnub context pointer
     is valid.
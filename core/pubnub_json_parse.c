@@ -6,6 +6,55 @@
 #include <string.h>
 
 
+#if !defined PUBNUB_JSON_USE_SIMD
+/** If true, use SIMD instructions (where available) to scan JSON */
+#define PUBNUB_JSON_USE_SIMD 1
+#endif
+
+
+/* The scanners (pbjson_find_end_string(), pbjson_find_end_complex()
+   and pbjson_split_array()) look at every character, but only a few
+   of them are "interesting": quotes, backslashes and, depending on
+   the scanner, NULs, brackets, braces and commas. So, the SIMD
+   implementations classify a block of 16 or 32 characters at a time,
+   getting a bit mask of the interesting ones, and run the state
+   machine only for those. The scalar implementations are used if no
+   SIMD is available (or on the tail of the input which doesn't fill
+   a block).
+ */
+#if PUBNUB_JSON_USE_SIMD
+#if (defined __GNUC__ || defined __clang__) && (defined __x86_64__ || defined __SSE2__)
+#define PBJSON_SSE2 1
+#include <emmintrin.h>
+#if defined __clang__ || (__GNUC__ >= 5)
+#define PBJSON_AVX2 1
+#define PBJSON_TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#endif
+#elif defined _MSC_VER && (defined _M_X64 || (defined _M_IX86_FP && (_M_IX86_FP >= 2)))
+#define PBJSON_SSE2 1
+#define PBJSON_AVX2 1
+#define PBJSON_TARGET_AVX2
+#include <intrin.h>
+#include <immintrin.h>
+#elif (defined __GNUC__ || defined __clang__) && defined __aarch64__
+#define PBJSON_NEON 1
+#include <arm_neon.h>
+#endif
+#endif /* PUBNUB_JSON_USE_SIMD */
+
+#if !defined PBJSON_SSE2
+#define PBJSON_SSE2 0
+#endif
+#if !defined PBJSON_AVX2
+#define PBJSON_AVX2 0
+#endif
+#if !defined PBJSON_NEON
+#define PBJSON_NEON 0
+#endif
+#define PBJSON_SIMD (PBJSON_SSE2 || PBJSON_NEON)
+
+
 char const* pbjson_skip_whitespace(char const* start, char const* end)
 {
     for (; start < end; ++start) {
@@ -23,7 +72,7 @@ char const* pbjson_skip_whitespace(char const* start, char const* end)
 }
 
 
-char const* pbjson_find_end_string(char const* start, char const* end)
+static char const* find_end_string_scalar(char const* start, char const* end)
 {
     bool in_escape = false;
 
@@ -49,29 +98,7 @@ char const* pbjson_find_end_string(char const* start, char const* end)
 }
 
 
-char const* pbjson_find_end_primitive(char const* start, char const* end)
-{
-    for (; start < end; ++start) {
-        switch (*start) {
-        case ' ':
-        case '\t':
-        case '\r':
-        case '\n':
-        case ',':
-        case '}':
-        case ']':
-            return start - 1;
-        case '\0':
-            return start;
-        default:
-            break;
-        }
-    }
-    return start;
-}
-
-
-char const* pbjson_find_end_complex(char const* start, char const* end)
+static char const* find_end_complex_scalar(char const* start, char const* end)
 {
     bool        in_string = false, in_escape = false;
     int         bracket_level = 0, brace_level = 0;
@@ -126,6 +153,616 @@ char const* pbjson_find_end_complex(char const* start, char const* end)
 }
 
 
+static bool split_array_scalar(char* start, char const* end)
+{
+    bool  escaped       = false;
+    bool  in_string     = false;
+    int   bracket_level = 0;
+    char* s;
+
+    for (s = start; s < end; ++s) {
+        if (escaped) {
+            escaped = false;
+        }
+        else if ('"' == *s) {
+            in_string = !in_string;
+        }
+        else if (in_string) {
+            escaped = ('\\' == *s);
+        }
+        else {
+            switch (*s) {
+            case '[':
+            case '{':
+                bracket_level++;
+                break;
+            case ']':
+            case '}':
+                bracket_level--;
+                break;
+                /* if at root, split! */
+            case ',':
+                if (bracket_level == 0) {
+                    *s = '\0';
+                }
+                break;
+            default:
+                break;
+            }
+        }
+    }
+
+    return !(escaped || in_string || (bracket_level > 0));
+}
+
+
+#if PBJSON_SIMD
+
+/** Classes of interesting characters, besides quotes and
+    backslashes, which are always interesting */
+#define PBJSON_CLASS_NUL 1
+#define PBJSON_CLASS_BRACKETS 2
+#define PBJSON_CLASS_COMMA 4
+
+
+/** State of the scan of a complex value (or a string, for which only
+    the escape state is used).
+ */
+struct scan_state {
+    bool in_string;
+    bool in_escape;
+    int  bracket_level;
+    int  brace_level;
+    /** The last character the state machine has seen. As only the
+        interesting characters are seen, if the one after a backslash
+        is not "next to" it, it was not escaped. */
+    char const* last;
+};
+
+
+/** Runs the string state machine for the (interesting) character
+    at @p s.
+    @retval true @p s is the end of the string
+    @retval false otherwise
+ */
+static bool string_step(struct scan_state* st, char const* s)
+{
+    if (st->in_escape && (s != st->last + 1)) {
+        st->in_escape = false;
+    }
+    st->last = s;
+    switch (*s) {
+    case '\\':
+        st->in_escape = !st->in_escape;
+        return false;
+    case '\0':
+        return true;
+    case '"':
+        if (!st->in_escape) {
+            return true;
+        }
+        /*FALLTHRU*/
+    default:
+        st->in_escape = false;
+        return false;
+    }
+}
+
+
+/** Runs the complex value state machine for the (interesting)
+    character at @p s.
+    @retval true @p s is the end of the complex value
+    @retval false otherwise
+ */
+static bool complex_step(struct scan_state* st, char const* s)
+{
+    if ('\0' == *s) {
+        return true;
+    }
+    if (st->in_string) {
+        if (st->in_escape && (s != st->last + 1)) {
+            st->in_escape = false;
+        }
+        st->last = s;
+        switch (*s) {
+        case '\\':
+            st->in_escape = !st->in_escape;
+            break;
+        case '"':
+            if (!st->in_escape) {
+                st->in_string = false;
+                break;
+            }
+            /*FALLTHRU*/
+        default:
+            st->in_escape = false;
+            break;
+        }
+        return false;
+    }
+    switch (*s) {
+    case '{':
+        ++st->brace_level;
+        break;
+    case '}':
+        return (--st->brace_level == 0) && (0 == st->bracket_level);
+    case '[':
+        ++st->bracket_level;
+        break;
+    case ']':
+        return (--st->bracket_level == 0) && (0 == st->brace_level);
+    case '"':
+        st->in_string = true;
+        st->in_escape = false;
+        break;
+    default:
+        break;
+    }
+    return false;
+}
+
+
+/** State of splitting an array */
+struct split_state {
+    bool in_string;
+    bool escaped;
+    int  bracket_level;
+    /** The last backslash seen (in a string). If the next
+        interesting character is right after it, it is escaped,
+        otherwise an uninteresting one was. */
+    char const* last;
+};
+
+
+/** Runs the array splitting state machine for the (interesting)
+    character at @p s.
+ */
+static void split_step(struct split_state* st, char* s)
+{
+    if (st->escaped) {
+        st->escaped = false;
+        if (s == st->last + 1) {
+            return;
+        }
+    }
+    if ('"' == *s) {
+        st->in_string = !st->in_string;
+    }
+    else if (st->in_string) {
+        if ('\\' == *s) {
+            st->escaped = true;
+            st->last    = s;
+        }
+    }
+    else {
+        switch (*s) {
+        case '[':
+        case '{':
+            st->bracket_level++;
+            break;
+        case ']':
+        case '}':
+            st->bracket_level--;
+            break;
+        case ',':
+            if (st->bracket_level == 0) {
+                *s = '\0';
+            }
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+
+#if defined _MSC_VER
+static unsigned lowest_bit(unsigned mask)
+{
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return (unsigned)index;
+}
+#else
+#define lowest_bit(mask) (unsigned)__builtin_ctz(mask)
+#endif
+
+
+/** Finds the end of the string, running the state machine only for
+    the characters @p classify finds interesting, @p width at a time.
+    Meant to be inlined into the functions for a specific
+    instruction set.
+ */
+#define PBJSON_FIND_END_STRING(start, end, classify, width)                \
+    do {                                                                   \
+        struct scan_state st_;                                             \
+        char const*       s_ = (start);                                    \
+        st_.in_escape        = false;                                      \
+        st_.last             = s_;                                         \
+        while ((end) - s_ >= (width)) {                                    \
+            unsigned mask_ = classify(s_, PBJSON_CLASS_NUL);               \
+            while (mask_ != 0) {                                           \
+                char const* p_ = s_ + lowest_bit(mask_);                   \
+                if (string_step(&st_, p_)) {                               \
+                    return p_;                                             \
+                }                                                          \
+                mask_ &= mask_ - 1;                                        \
+            }                                                              \
+            s_ += (width);                                                 \
+        }                                                                  \
+        for (; s_ < (end); ++s_) {                                         \
+            if (string_step(&st_, s_)) {                                   \
+                return s_;                                                 \
+            }                                                              \
+        }                                                                  \
+        return s_;                                                         \
+    } while (0)
+
+
+/** Finds the end of the complex value, like PBJSON_FIND_END_STRING()
+    does for strings. */
+#define PBJSON_FIND_END_COMPLEX(start, end, classify, width)               \
+    do {                                                                   \
+        struct scan_state st_;                                             \
+        char const*       s_ = (start);                                    \
+        st_.in_string        = false;                                      \
+        st_.in_escape        = false;                                      \
+        st_.bracket_level    = 0;                                          \
+        st_.brace_level      = 0;                                          \
+        st_.last             = s_;                                         \
+        while ((end) - s_ >= (width)) {                                    \
+            unsigned mask_ = classify(                                     \
+                s_, PBJSON_CLASS_NUL | PBJSON_CLASS_BRACKETS);             \
+            while (mask_ != 0) {                                           \
+                char const* p_ = s_ + lowest_bit(mask_);                   \
+                if (complex_step(&st_, p_)) {                              \
+                    return p_;                                             \
+                }                                                          \
+                mask_ &= mask_ - 1;                                        \
+            }                                                              \
+            s_ += (width);                                                 \
+        }                                                                  \
+        for (; s_ < (end); ++s_) {                                         \
+            if (complex_step(&st_, s_)) {                                  \
+                return s_;                                                 \
+            }                                                              \
+        }                                                                  \
+        return s_;                                                         \
+    } while (0)
+
+
+/** Splits the array, like PBJSON_FIND_END_STRING() finds the end of
+    a string. */
+#define PBJSON_SPLIT_ARRAY(start, end, classify, width)                    \
+    do {                                                                   \
+        struct split_state st_;                                            \
+        char*              s_ = (start);                                   \
+        st_.in_string         = false;                                     \
+        st_.escaped           = false;                                     \
+        st_.bracket_level     = 0;                                         \
+        st_.last              = s_;                                        \
+        while ((end) - s_ >= (width)) {                                    \
+            unsigned mask_ = classify(                                     \
+                s_, PBJSON_CLASS_BRACKETS | PBJSON_CLASS_COMMA);           \
+            while (mask_ != 0) {                                           \
+                split_step(&st_, s_ + lowest_bit(mask_));                  \
+                mask_ &= mask_ - 1;                                        \
+            }                                                              \
+            s_ += (width);                                                 \
+        }                                                                  \
+        for (; s_ < (end); ++s_) {                                         \
+            split_step(&st_, s_);                                          \
+        }                                                                  \
+        if (st_.escaped && (st_.last + 1 < (end))) {                       \
+            /* The escaped character was not interesting */                \
+            st_.escaped = false;                                           \
+        }                                                                  \
+        return !(st_.escaped || st_.in_string || (st_.bracket_level > 0)); \
+    } while (0)
+
+#endif /* PBJSON_SIMD */
+
+
+#if PBJSON_SSE2
+/** Returns the mask of the interesting characters in the 16
+    characters starting at @p s: quotes and backslashes and the
+    characters of the classes in @p classes (PBJSON_CLASS_xxx). */
+static unsigned classify_sse2(char const* s, unsigned classes)
+{
+    __m128i v = _mm_loadu_si128((__m128i const*)s);
+    __m128i m = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('"')),
+                             _mm_cmpeq_epi8(v, _mm_set1_epi8('\\')));
+    if (classes & PBJSON_CLASS_NUL) {
+        m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_setzero_si128()));
+    }
+    if (classes & PBJSON_CLASS_COMMA) {
+        m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8(',')));
+    }
+    if (classes & PBJSON_CLASS_BRACKETS) {
+        /* '[' | 0x20 == '{' and ']' | 0x20 == '}' */
+        __m128i lower = _mm_or_si128(v, _mm_set1_epi8(0x20));
+        m = _mm_or_si128(m, _mm_cmpeq_epi8(lower, _mm_set1_epi8('{')));
+        m = _mm_or_si128(m, _mm_cmpeq_epi8(lower, _mm_set1_epi8('}')));
+    }
+    return (unsigned)_mm_movemask_epi8(m);
+}
+
+static char const* find_end_string_sse2(char const* start, char const* end)
+{
+    PBJSON_FIND_END_STRING(start, end, classify_sse2, 16);
+}
+
+static char const* find_end_complex_sse2(char const* start, char const* end)
+{
+    PBJSON_FIND_END_COMPLEX(start, end, classify_sse2, 16);
+}
+
+static bool split_array_sse2(char* start, char const* end)
+{
+    PBJSON_SPLIT_ARRAY(start, end, classify_sse2, 16);
+}
+#endif /* PBJSON_SSE2 */
+
+
+#if PBJSON_AVX2
+/** Like classify_sse2(), but for 32 characters */
+PBJSON_TARGET_AVX2 static unsigned classify_avx2(char const* s, unsigned classes)
+{
+    __m256i v = _mm256_loadu_si256((__m256i const*)s);
+    __m256i m = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('"')),
+                                _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\\')));
+    if (classes & PBJSON_CLASS_NUL) {
+        m = _mm256_or_si256(m, _mm256_cmpeq_epi8(v, _mm256_setzero_si256()));
+    }
+    if (classes & PBJSON_CLASS_COMMA) {
+        m = _mm256_or_si256(m, _mm256_cmpeq_epi8(v, _mm256_set1_epi8(',')));
+    }
+    if (classes & PBJSON_CLASS_BRACKETS) {
+        __m256i lower = _mm256_or_si256(v, _mm256_set1_epi8(0x20));
+        m = _mm256_or_si256(m, _mm256_cmpeq_epi8(lower, _mm256_set1_epi8('{')));
+        m = _mm256_or_si256(m, _mm256_cmpeq_epi8(lower, _mm256_set1_epi8('}')));
+    }
+    return (unsigned)_mm256_movemask_epi8(m);
+}
+
+PBJSON_TARGET_AVX2 static char const* find_end_string_avx2(char const* start,
+                                                          char const* end)
+{
+    PBJSON_FIND_END_STRING(start, end, classify_avx2, 32);
+}
+
+PBJSON_TARGET_AVX2 static char const* find_end_complex_avx2(char const* start,
+                                                           char const* end)
+{
+    PBJSON_FIND_END_COMPLEX(start, end, classify_avx2, 32);
+}
+
+PBJSON_TARGET_AVX2 static bool split_array_avx2(char* start, char const* end)
+{
+    PBJSON_SPLIT_ARRAY(start, end, classify_avx2, 32);
+}
+
+
+static bool cpu_has_avx2(void)
+{
+#if defined _MSC_VER
+    int info[4];
+
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    __cpuid(info, 1);
+    /* OSXSAVE and AVX, and the OS saves the YMM registers */
+    if (((info[2] & (3 << 27)) != (3 << 27)) || ((_xgetbv(0) & 6) != 6)) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif /* PBJSON_AVX2 */
+
+
+#if PBJSON_NEON
+static unsigned movemask_neon(uint8x16_t m)
+{
+    static uint8_t const bits[16] = { 1, 2, 4, 8, 16, 32, 64, 128,
+                                      1, 2, 4, 8, 16, 32, 64, 128 };
+    uint8x16_t           b        = vandq_u8(m, vld1q_u8(bits));
+
+    return vaddv_u8(vget_low_u8(b)) | ((unsigned)vaddv_u8(vget_high_u8(b)) << 8);
+}
+
+/** Like classify_sse2(), for NEON */
+static unsigned classify_neon(char const* s, unsigned classes)
+{
+    uint8x16_t v = vld1q_u8((uint8_t const*)s);
+    uint8x16_t m = vorrq_u8(vceqq_u8(v, vdupq_n_u8('"')),
+                            vceqq_u8(v, vdupq_n_u8('\\')));
+    if (classes & PBJSON_CLASS_NUL) {
+        m = vorrq_u8(m, vceqq_u8(v, vdupq_n_u8(0)));
+    }
+    if (classes & PBJSON_CLASS_COMMA) {
+        m = vorrq_u8(m, vceqq_u8(v, vdupq_n_u8(',')));
+    }
+    if (classes & PBJSON_CLASS_BRACKETS) {
+        uint8x16_t lower = vorrq_u8(v, vdupq_n_u8(0x20));
+        m = vorrq_u8(m, vceqq_u8(lower, vdupq_n_u8('{')));
+        m = vorrq_u8(m, vceqq_u8(lower, vdupq_n_u8('}')));
+    }
+    return movemask_neon(m);
+}
+
+static char const* find_end_string_neon(char const* start, char const* end)
+{
+    PBJSON_FIND_END_STRING(start, end, classify_neon, 16);
+}
+
+static char const* find_end_complex_neon(char const* start, char const* end)
+{
+    PBJSON_FIND_END_COMPLEX(start, end, classify_neon, 16);
+}
+
+static bool split_array_neon(char* start, char const* end)
+{
+    PBJSON_SPLIT_ARRAY(start, end, classify_neon, 16);
+}
+#endif /* PBJSON_NEON */
+
+
+/** The scanner in use. Detected on first use - if several threads do
+    that at the same time, they all detect (and write) the same one.
+ */
+static int m_scanner = -1;
+
+
+static enum pbjson_scanner detect_scanner(void)
+{
+#if PBJSON_AVX2
+    if (cpu_has_avx2()) {
+        return pbjsonScannerAVX2;
+    }
+#endif
+#if PBJSON_SSE2
+    return pbjsonScannerSSE2;
+#elif PBJSON_NEON
+    return pbjsonScannerNEON;
+#else
+    return pbjsonScannerScalar;
+#endif
+}
+
+
+enum pbjson_scanner pbjson_current_scanner(void)
+{
+    if (m_scanner < 0) {
+        m_scanner = detect_scanner();
+    }
+    return (enum pbjson_scanner)m_scanner;
+}
+
+
+bool pbjson_select_scanner(enum pbjson_scanner scanner)
+{
+    switch (scanner) {
+    case pbjsonScannerScalar:
+        break;
+    case pbjsonScannerSSE2:
+        if (!PBJSON_SSE2) {
+            return false;
+        }
+        break;
+    case pbjsonScannerAVX2:
+#if PBJSON_AVX2
+        if (!cpu_has_avx2()) {
+            return false;
+        }
+        break;
+#else
+        return false;
+#endif
+    case pbjsonScannerNEON:
+        if (!PBJSON_NEON) {
+            return false;
+        }
+        break;
+    default:
+        return false;
+    }
+    m_scanner = scanner;
+    return true;
+}
+
+
+char const* pbjson_find_end_string(char const* start, char const* end)
+{
+    switch (pbjson_current_scanner()) {
+#if PBJSON_AVX2
+    case pbjsonScannerAVX2:
+        return find_end_string_avx2(start, end);
+#endif
+#if PBJSON_SSE2
+    case pbjsonScannerSSE2:
+        return find_end_string_sse2(start, end);
+#endif
+#if PBJSON_NEON
+    case pbjsonScannerNEON:
+        return find_end_string_neon(start, end);
+#endif
+    default:
+        return find_end_string_scalar(start, end);
+    }
+}
+
+
+char const* pbjson_find_end_primitive(char const* start, char const* end)
+{
+    for (; start < end; ++start) {
+        switch (*start) {
+        case ' ':
+        case '\t':
+        case '\r':
+        case '\n':
+        case ',':
+        case '}':
+        case ']':
+            return start - 1;
+        case '\0':
+            return start;
+        default:
+            break;
+        }
+    }
+    return start;
+}
+
+
+char const* pbjson_find_end_complex(char const* start, char const* end)
+{
+    switch (pbjson_current_scanner()) {
+#if PBJSON_AVX2
+    case pbjsonScannerAVX2:
+        return find_end_complex_avx2(start, end);
+#endif
+#if PBJSON_SSE2
+    case pbjsonScannerSSE2:
+        return find_end_complex_sse2(start, end);
+#endif
+#if PBJSON_NEON
+    case pbjsonScannerNEON:
+        return find_end_complex_neon(start, end);
+#endif
+    default:
+        return find_end_complex_scalar(start, end);
+    }
+}
+
+
+bool pbjson_split_array(char* start, char const* end)
+{
+    switch (pbjson_current_scanner()) {
+#if PBJSON_AVX2
+    case pbjsonScannerAVX2:
+        return split_array_avx2(start, end);
+#endif
+#if PBJSON_SSE2
+    case pbjsonScannerSSE2:
+        return split_array_sse2(start, end);
+#endif
+#if PBJSON_NEON
+    case pbjsonScannerNEON:
+        return split_array_neon(start, end);
+#endif
+    default:
+        return split_array_scalar(start, end);
+    }
+}
+
+
 char const* pbjson_find_end_element(char const* start, char const* end)
 {
     switch (*start) {
@@ -205,6 +842,78 @@ pbjson_get_object_value(struct pbjson_elem const* p,
 }
 
 
+enum pbjson_object_name_parse_result
+pbjson_object_iterator_init(struct pbjson_object_iterator* it,
+                            struct pbjson_elem const*      p)
+{
+    char const* s = pbjson_skip_whitespace(p->start, p->end);
+
+    if ((s == p->end) || (*s != '{')) {
+        return jonmpNoStartCurly;
+    }
+    it->s   = s;
+    it->end = p->end;
+
+    return jonmpOK;
+}
+
+
+enum pbjson_object_name_parse_result
+pbjson_object_next_pair(struct pbjson_object_iterator* it,
+                        struct pbjson_elem*            key,
+                        struct pbjson_elem*            value)
+{
+    char const* s = it->s;
+    char const* end;
+
+    if (s == it->end) {
+        return jonmpObjectIncomplete;
+    }
+    if ('}' == *s) {
+        return jonmpKeyNotFound;
+    }
+    s = pbjson_skip_whitespace(s + 1, it->end);
+    if (s == it->end) {
+        return jonmpKeyMissing;
+    }
+    if (('}' == *s) && ('{' == *it->s)) {
+        /* Empty object */
+        it->s = s;
+        return jonmpKeyNotFound;
+    }
+    if (*s != '"') {
+        return jonmpKeyNotString;
+    }
+    end = pbjson_find_end_string(s + 1, it->end);
+    if ((end == it->end) || (*end != '"')) {
+        return jonmpStringNotTerminated;
+    }
+    key->start = s + 1;
+    key->end   = end;
+    s          = pbjson_skip_whitespace(end + 1, it->end);
+    if ((s == it->end) || (*s != ':')) {
+        return jonmpMissingColon;
+    }
+    s   = pbjson_skip_whitespace(s + 1, it->end);
+    end = pbjson_find_end_element(s, it->end);
+    if ((end == it->end) || ('\0' == *end)) {
+        return jonmpValueIncomplete;
+    }
+    value->start = s;
+    value->end   = end + 1;
+    s            = pbjson_skip_whitespace(end + 1, it->end);
+    if (s == it->end) {
+        return jonmpObjectIncomplete;
+    }
+    if ((*s != ',') && (*s != '}')) {
+        return jonmpMissingValueSeparator;
+    }
+    it->s = s;
+
+    return jonmpOK;
+}
+
+
 bool pbjson_elem_equals_string(struct pbjson_elem const* e, char const* s)
 {
     char const* p;
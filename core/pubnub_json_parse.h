@@ -59,6 +59,41 @@ enum pbjson_object_name_parse_result {
 };
 
 
+/** Implementations of the JSON scanning functions,
+    pbjson_find_end_string() and pbjson_find_end_complex() (and,
+    thus, of all the others that use them).
+ */
+enum pbjson_scanner {
+    /** Plain C, one character at a time */
+    pbjsonScannerScalar,
+    /** SSE2 instructions, 16 characters at a time */
+    pbjsonScannerSSE2,
+    /** AVX2 instructions, 32 characters at a time */
+    pbjsonScannerAVX2,
+    /** ARM NEON instructions, 16 characters at a time */
+    pbjsonScannerNEON
+};
+
+
+/** Returns the JSON scanner in use. Unless another one was selected
+    with pbjson_select_scanner(), this is the fastest one available,
+    detected on first use.
+ */
+enum pbjson_scanner pbjson_current_scanner(void);
+
+
+/** Selects the JSON scanner to use, for all the contexts. Meant for
+    testing and benchmarking, as the default one is the fastest one
+    available. Not thread safe - should not be called while JSON is
+    being parsed.
+
+    @param scanner The scanner to use
+    @return true if @p scanner is selected, false if it's not
+    available (not built in or not supported by the CPU)
+ */
+bool pbjson_select_scanner(enum pbjson_scanner scanner);
+
+
 /** Skips whitespace starting from @p start, until @p end.
     Interprets whitespace as JSON does - that should be
     compatible with a lot of other specifications.
@@ -115,6 +150,20 @@ char const* pbjson_find_end_primitive(char const* start, char const* end);
 char const* pbjson_find_end_complex(char const* start, char const* end);
 
 
+/** Splits the contents of a JSON array (with arbitrary elements),
+    from @p start until @p end, to its (top level) elements, by
+    replacing the commas between them with NUL characters. Other NUL
+    characters are treated as any other character.
+
+    Assumes that @p start points to the first character of the first
+    element (that is, one past the opening square bracket).
+
+    @return true if the array elements are complete (all the strings,
+    arrays and objects in them are closed), false otherwise
+ */
+bool pbjson_split_array(char* start, char const* end);
+
+
 /** Finds the end of the JSON element starting from @p start, until
     @p end.  Interprets element as JSON does (primitive, object or array) -
     that should be compatible with a lot of other specifications.
@@ -140,6 +189,45 @@ pbjson_get_object_value(struct pbjson_elem const* p,
                         struct pbjson_elem*       parsed);
 
 
+/** State of iterating over the key/value pairs of a JSON object,
+    see pbjson_object_iterator_init() and pbjson_object_next_pair().
+ */
+struct pbjson_object_iterator {
+    /** Points to the opening curly brace, or the comma or closing
+        curly brace after the last pair that was iterated over */
+    char const* s;
+    /** End of input */
+    char const* end;
+};
+
+
+/** Starts iterating over the key/value pairs of the JSON object
+    @p p, which, unlike pbjson_get_object_value(), goes over the
+    object just once, no matter how many values one is interested in.
+
+    @retval jonmpOK iteration started
+    @retval jonmpNoStartCurly @p p is not a JSON object
+ */
+enum pbjson_object_name_parse_result
+pbjson_object_iterator_init(struct pbjson_object_iterator* it,
+                            struct pbjson_elem const*      p);
+
+
+/** Gets the next key/value pair of the JSON object being iterated
+    over with @p it. The @p key is given without the double-quotes.
+
+    @retval jonmpOK got the next pair in @p key and @p value
+    @retval jonmpKeyNotFound no more pairs, `it->s` points to the
+            closing curly brace of the object
+    @retval other parse error, the effects on @p key and @p value are
+            not defined
+ */
+enum pbjson_object_name_parse_result
+pbjson_object_next_pair(struct pbjson_object_iterator* it,
+                        struct pbjson_elem*            key,
+                        struct pbjson_elem*            value);
+
+
 /** Helper function, returns whether string @p s is equal to the
     contents of the JSON element @p e.
 */
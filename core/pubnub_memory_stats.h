@@ -0,0 +1,90 @@
+/* -*- c-file-style:"stroustrup"; indent-tabs-mode: nil -*- */
+#if !defined INC_PUBNUB_MEMORY_STATS
+#define      INC_PUBNUB_MEMORY_STATS
+
+#include "pubnub_api_types.h"
+
+#include <stddef.h>
+
+
+/** @file pubnub_memory_stats.h
+    Accounting of the heap memory that Pubnub allocates (through the
+    allocator set by pubnub_set_allocator()), per context and for the
+    whole process, broken down into categories. Available only if
+    #PUBNUB_MEMORY_STATS is true (!=0).
+
+    With OpenSSL, its own allocations are included too, in
+    #pbmemcatTLS, as long as Pubnub is initialized (the first context
+    allocated) before OpenSSL is used in the process. Memory that other
+    third party libraries allocate on their own is not included.
+ */
+
+
+/** The categories of memory that Pubnub allocates */
+enum pubnub_memory_category {
+    /** The buffer for the HTTP reply (response body) */
+    pbmemcatReply,
+    /** GZIP compression and decompression buffers */
+    pbmemcatDecomp,
+    /** Crypto buffers (for encrypted messages to publish) */
+    pbmemcatCrypto,
+    /** TLS bookkeeping (`SSL_CTX` and session caches, early data,
+        OpenSSL's own allocations) */
+    pbmemcatTLS,
+    /** Arrays of the callback interface "poller" */
+    pbmemcatPoller,
+    /** Auto heartbeat data (channel and channel group lists) */
+    pbmemcatHeartbeat,
+    /** Contexts themselves and their HTTP and other buffers */
+    pbmemcatContext,
+    /** Number of the categories, not a category itself */
+    pbmemcatCount
+};
+
+/** Usage of some memory, in bytes */
+struct pubnub_memory_usage {
+    /** Currently allocated */
+    size_t current;
+    /** The most that was ever allocated at the same time */
+    size_t peak;
+};
+
+/** Memory usage report */
+struct pubnub_memory_report {
+    /** Usage per category, indexed by enum pubnub_memory_category */
+    struct pubnub_memory_usage category[pbmemcatCount];
+    /** Usage of all categories together. The peak is the peak of the
+        total, which is not the sum of category peaks. */
+    struct pubnub_memory_usage total;
+};
+
+
+/** Reports the memory allocated by the context @p pb - that is,
+    everything that is freed when the context is freed (contexts
+    themselves are allocated in chunks, so they are accounted for
+    only in the process-wide report). Peaks are since the context
+    was allocated.
+
+    @param pb The context to report memory usage for
+    @param report Where to put the report
+    @retval 0 OK
+    @retval -1 memory accounting not available (#PUBNUB_MEMORY_STATS
+    is false), @p report zeroed
+ */
+int pubnub_memory_stats(pubnub_t* pb, struct pubnub_memory_report* report);
+
+/** Reports the memory allocated by Pubnub in the whole process,
+    including the memory of all the contexts and process-wide caches,
+    but not the memory that Pubnub allocated and handed over to the
+    user (like the result of pubnub_get_decrypted_alloc()). Peaks are
+    since the start of the process.
+
+    @param report Where to put the report
+    @retval 0 OK
+    @retval -1 memory accounting not available (#PUBNUB_MEMORY_STATS
+    is false), @p report zeroed
+ */
+int pubnub_memory_stats_global(struct pubnub_memory_report* report);
+
+
+#endif /* !defined INC_PUBNUB_MEMORY_STATS */
@@ -2,6 +2,7 @@
 #include "pubnub_internal.h"
 
 #include "core/pubnub_assert.h"
+#include "core/pbmem.h"
 #include "core/pubnub_log.h"
 #include "core/pubnub_ccore.h"
 #include "core/pubnub_ccore_pubsub.h"
@@ -48,9 +49,17 @@
 #if PUBNUB_RECEIVE_GZIP_RESPONSE
 /* 'Accept-Encoding' header line */
 #define ACCEPT_ENCODING "Accept-Encoding: gzip\r\n"
+#if PUBNUB_DYNAMIC_REPLY_BUFFER
+/* The response body is decompressed as it arrives */
+#define GZIP_STREAMING(pb) ((pb)->data_compressed == compressionGZIP)
+#define gzip_finish(pb) pbgzip_stream_finish(pb)
+#else
+#define GZIP_STREAMING(pb) false
+#define gzip_finish(pb) pbgzip_decompress(pb)
+#endif
 #define possible_gzip_response(pb)                                             \
     if ((pb)->data_compressed == compressionGZIP) {                            \
-        pbres                 = pbgzip_decompress(pb);                         \
+        pbres                 = gzip_finish(pb);                               \
         (pb)->data_compressed = compressionNONE;                               \
         if (PNR_OK != pbres) {                                                 \
             outcome_detected((pb), pbres);                                     \
@@ -59,9 +68,110 @@
     }
 #else
 #define ACCEPT_ENCODING ""
+#define GZIP_STREAMING(pb) false
 #define possible_gzip_response(pb)
 #endif /* PUBNUB_RECEIVE_GZIP_RESPONSE */
 
+#if PUBNUB_USE_ADVANCED_HISTORY && !defined(PUBNUB_CALLBACK_API)
+/* The user wants the response of the (history) transaction streamed.
+   Only the sync interface streams, as there the user takes the
+   messages in the same thread that receives them. */
+#define HISTORY_STREAM_REQUESTED(pb)                                           \
+    ((PBTT_HISTORY == (pb)->trans) && pbcc_history_stream_requested(&(pb)->core))
+/* The response is a history that is to be streamed, as opposed to,
+   say, an error response */
+#define HISTORY_STREAM_WANTED(pb)                                              \
+    (HISTORY_STREAM_REQUESTED(pb) && ((pb)->http_code / 100 == 2))
+/* The response body is fed to the history stream as it arrives */
+#define HISTORY_STREAMING(pb)                                                  \
+    ((PBTT_HISTORY == (pb)->trans) && pbcc_history_stream_receiving(&(pb)->core))
+/* The user has not taken enough messages from the history stream to
+   read more of the response */
+#define HISTORY_STREAM_FULL(pb)                                                \
+    (HISTORY_STREAMING(pb) && pbcc_history_stream_full(&(pb)->core))
+#else
+#define HISTORY_STREAM_REQUESTED(pb) false
+#define HISTORY_STREAM_WANTED(pb) false
+#define HISTORY_STREAMING(pb) false
+#define HISTORY_STREAM_FULL(pb) false
+#endif /* PUBNUB_USE_ADVANCED_HISTORY && !defined(PUBNUB_CALLBACK_API) */
+
+#if PUBNUB_RECEIVE_GZIP_RESPONSE
+#define RESPONSE_COMPRESSED(pb) ((pb)->data_compressed != compressionNONE)
+#else
+#define RESPONSE_COMPRESSED(pb) false
+#endif
+
+
+/** Makes room for a response body of @p bytes in the reply buffer. A
+    compressed body that's decompressed as it arrives makes room for
+    itself, while a streamed history response body is not kept in the
+    reply buffer at all.
+ */
+static int reserve_reply_buffer(struct pubnub_* pb, unsigned bytes)
+{
+    if (GZIP_STREAMING(pb) || HISTORY_STREAM_WANTED(pb)) {
+        return 0;
+    }
+    return pbcc_realloc_reply_buffer(&pb->core, bytes);
+}
+
+
+/** At the end of the response headers, decides how to receive the
+    body of a history response the user wants streamed: if it's not
+    an error and is not compressed, it is fed to the stream as it
+    arrives. Otherwise it is kept in the reply buffer, as usual, and
+    an error response is not streamed at all.
+ */
+static int start_history_stream(struct pubnub_* pb)
+{
+    if (HISTORY_STREAM_WANTED(pb)) {
+#if PUBNUB_USE_ADVANCED_HISTORY
+        if (!RESPONSE_COMPRESSED(pb)) {
+            pbcc_history_stream_receive(&pb->core);
+            return 0;
+        }
+#endif
+        if (!pb->http_chunked && !GZIP_STREAMING(pb)) {
+            return pbcc_realloc_reply_buffer(&pb->core, pb->core.http_content_len);
+        }
+    }
+#if PUBNUB_USE_ADVANCED_HISTORY
+    else if ((PBTT_HISTORY == pb->trans) && pbcc_history_stream_requested(&pb->core)
+             && (pb->http_code / 100 != 2)) {
+        pbcc_history_stream_reset(&pb->core);
+    }
+#endif
+    return 0;
+}
+
+
+/** Appends @p len bytes of the response body at @p data to the reply
+    buffer, decompressing them on the fly if the body is compressed
+    (and decompression "as it arrives" is used). Either way, the
+    @p len bytes are added to the length of received body
+    (`http_buf_len`). A streamed history response body is fed to the
+    history stream instead.
+ */
+static enum pubnub_res append_to_reply(struct pubnub_* pb, char const* data, unsigned len)
+{
+#if PUBNUB_USE_ADVANCED_HISTORY
+    if (HISTORY_STREAMING(pb)) {
+        pb->core.http_buf_len += len;
+        return pbcc_history_stream_feed(&pb->core, data, len);
+    }
+#endif
+#if PUBNUB_RECEIVE_GZIP_RESPONSE && PUBNUB_DYNAMIC_REPLY_BUFFER
+    if (GZIP_STREAMING(pb)) {
+        pb->core.http_buf_len += len;
+        return pbgzip_stream_feed(pb, (uint8_t const*)data, len);
+    }
+#endif
+    memcpy(pb->core.http_reply + pb->core.http_buf_len, data, len);
+    pb->core.http_buf_len += len;
+    return PNR_OK;
+}
+
 bool HTTP_request_has_body(uint8_t method)
 {
     switch(method) {
@@ -107,18 +217,156 @@ static char const* get_method_verb_string(uint8_t method)
     }
 }
 
+/* What follows the path in the request line, up to the origin */
+#define HTTP_VERSION_AND_HOST " HTTP/1.1\r\nHost: "
+
+
+/** Returns the origin to send the request of @p pb to */
+static char const* request_origin(struct pubnub_ const* pb)
+{
+    return PUBNUB_ORIGIN_SETTABLE ? pb->origin : PUBNUB_ORIGIN;
+}
+
+
+/** Formats the end of the request head of @p pb, which every request
+    has, to @p buf of size @p n. It starts with the line end of the
+    header before it.
+
+    @return As snprintf()
+ */
+static int format_fin_head(struct pubnub_* pb, char* buf, size_t n)
+{
+    /* A compressed response can't be streamed */
+    return snprintf(buf,
+                    n,
+                    "\r\nUser-Agent: %s\r\n%s\r\n",
+                    pubnub_uagent(),
+                    HISTORY_STREAM_REQUESTED(pb) ? "" : ACCEPT_ENCODING);
+}
+
+
 static int send_fin_head(struct pubnub_* pb)
 {
     char s[200];
-    snprintf(s,
-             sizeof s,
-             "\r\nUser-Agent: %s%s",
-             pubnub_uagent(),
-             "\r\n" ACCEPT_ENCODING "\r\n");
+    format_fin_head(pb, s, sizeof s);
     return pbpal_send_str(pb, s);
 }
 
 
+/** Transactions which only read data, thus may be safely replayed,
+    which may happen if they are sent as TLS early data.
+ */
+static bool trans_is_idempotent(enum pubnub_trans trans)
+{
+    switch (trans) {
+    case PBTT_SUBSCRIBE:
+    case PBTT_TIME:
+    case PBTT_HISTORY:
+    case PBTT_HERENOW:
+    case PBTT_GLOBAL_HERENOW:
+    case PBTT_WHERENOW:
+    case PBTT_STATE_GET:
+    case PBTT_LIST_CHANNEL_GROUP:
+#if PUBNUB_USE_SUBSCRIBE_V2
+    case PBTT_SUBSCRIBE_V2:
+#endif
+#if PUBNUB_USE_ADVANCED_HISTORY
+    case PBTT_MESSAGE_COUNTS:
+#endif
+        return true;
+    default:
+        return false;
+    }
+}
+
+
+bool pbnc_request_replayable(struct pubnub_ const* pb)
+{
+#if PUBNUB_PROXY_API
+    if (pbproxyNONE != pb->proxy_type) {
+        return false;
+    }
+#endif
+    return (pubnubSendViaGET == pb->method) && trans_is_idempotent(pb->trans);
+}
+
+
+size_t pbnc_request_head(struct pubnub_* pb, char* buf, size_t n)
+{
+    int len;
+    int fin;
+
+    /* The same pieces, in the same order, as the states from
+       PBS_CONNECTED to PBS_TX_FIN_HEAD send */
+    len = snprintf(buf,
+                   n,
+                   "%s%s" HTTP_VERSION_AND_HOST "%s",
+                   get_method_verb_string(pb->method),
+                   pb->core.http_buf,
+                   request_origin(pb));
+    if ((len < 0) || ((size_t)len >= n)) {
+        return 0;
+    }
+    fin = format_fin_head(pb, buf + len, n - len);
+    if ((fin < 0) || ((size_t)fin >= n - len)) {
+        return 0;
+    }
+
+    return len + fin;
+}
+
+
+#if PUBNUB_USE_SSL
+size_t pbnc_early_data_request(struct pubnub_* pb, char* buf, size_t n)
+{
+    if (!pb->options.use_tls_early_data || !pbnc_request_replayable(pb)) {
+        return 0;
+    }
+    return pbnc_request_head(pb, buf, n);
+}
+#endif /* PUBNUB_USE_SSL */
+
+
+#if PUBNUB_PROXY_API
+/** Saves the path (part of the URL) of the current transaction, to
+    send it again when the proxy asks for authentication, or through
+    the established tunnel.
+    @return 0: OK, -1: failed to allocate the buffer to save to
+ */
+static int save_proxy_path(struct pubnub_* pb)
+{
+    size_t const size = pb->core.http_buf_len + 1;
+
+    if (size > pb->proxy_saved_path_size) {
+        pbmem_free(pb->proxy_saved_path);
+        pb->proxy_saved_path_size = 0;
+        pb->proxy_saved_path      = (char*)pbmem_alloc(
+            PBCC_MEMORY(&pb->core), pbmemcatContext, size);
+        if (NULL == pb->proxy_saved_path) {
+            PUBNUB_LOG_ERROR("pb=%p: Failed to allocate proxy path buffer\n", pb);
+            return -1;
+        }
+        pb->proxy_saved_path_size = size;
+    }
+    memcpy(pb->proxy_saved_path, pb->core.http_buf, size);
+    pb->proxy_saved_path_len = pb->core.http_buf_len;
+
+    return 0;
+}
+
+
+/** Returns the path (part of the URL) of the current transaction to
+    send: the saved one, if it was saved, otherwise the one in the
+    HTTP buffer.
+ */
+static char const* proxy_path_to_send(struct pubnub_ const* pb)
+{
+    return (pb->proxy_saved_path_len > 0) ? pb->proxy_saved_path
+                                          : pb->core.http_buf;
+}
+#endif /* PUBNUB_PROXY_API */
+
+
 #define SEND_FIN_HEAD(pb)                                                      \
     if (0 > send_fin_head(pb)) {                                               \
         outcome_detected(pb, PNR_IO_ERROR);                                    \
@@ -371,6 +619,10 @@ static enum pubnub_res finish(struct pubnub_* pb)
         return PNR_REPLY_TOO_BIG;
     }
     possible_gzip_response(pb);
+    if (HISTORY_STREAMING(pb)) {
+        /* The body was fed to the history stream, not kept */
+        pb->core.http_buf_len = 0;
+    }
     pb->core.http_reply[pb->core.http_buf_len] = '\0';
     PUBNUB_LOG_TRACE("finish(pb=%p, '%s')\n", pb, pb->core.http_reply);
     pbres = parse_pubnub_result(pb);
@@ -465,13 +717,13 @@ static char const* pbnc_state2str(enum pubnub_state e)
 
 static void initialize_fields_in_state_IDLE(struct pubnub_* pb)
 {
+    /* The outcome of the previous transaction is not needed any more */
+    pbcc_release_reply_buffer(&pb->core);
 #if PUBNUB_CHANGE_DNS_SERVERS
     pb->dns_check.dns_server_check = 0;
 #endif
 #if PUBNUB_NEED_RETRY_AFTER_CLOSE
     pb->flags.retry_after_close = false;
-#else
-    PUBNUB_UNUSED(pb);
 #endif
 #if PUBNUB_PROXY_API
     pb->proxy_tunnel_established = false;
@@ -688,6 +940,12 @@ next_state:
             res = pbpal_start_tls(pb);
             switch (res) {
             case pbtlsEstablished:
+                if (pb->flags.sent_as_early_data) {
+                    pbpal_start_read_line(pb);
+                    pb->state = PBS_RX_HTTP_VER;
+                    pbntf_watch_in_events(pb);
+                    goto next_state;
+                }
                 break;
             case pbtlsStarted:
                 pb->state = PBS_WAIT_TLS_CONNECT;
@@ -729,6 +987,12 @@ next_state:
         enum pbpal_tls_result res = pbpal_check_tls(pb);
         switch (res) {
         case pbtlsEstablished:
+            if (pb->flags.sent_as_early_data) {
+                pbpal_start_read_line(pb);
+                pb->state = PBS_RX_HTTP_VER;
+                pbntf_watch_in_events(pb);
+                goto next_state;
+            }
             i = pbpal_send_str(pb, get_method_verb_string(pb->method));
             if (i < 0) {
                 outcome_detected(pb, PNR_IO_ERROR);
@@ -775,19 +1039,10 @@ next_state:
                     outcome_detected(pb, PNR_IO_ERROR);
                     break;
                 }
-                PUBNUB_ASSERT_OPT(pb->core.http_buf_len < PUBNUB_BUF_MAXLEN);
-                if (0 == pb->proxy_saved_path_len) {
-                    memcpy(pb->proxy_saved_path,
-                           pb->core.http_buf,
-                           pb->core.http_buf_len + 1);
-                    pb->proxy_saved_path_len = pb->core.http_buf_len;
-                }
-                else {
-                    PUBNUB_ASSERT_OPT(pb->proxy_saved_path_len < PUBNUB_BUF_MAXLEN);
-                    memmove(pb->core.http_buf,
-                            pb->proxy_saved_path,
-                            pb->proxy_saved_path_len + 1);
-                    pb->core.http_buf_len = pb->proxy_saved_path_len;
+                PUBNUB_ASSERT_OPT(pb->core.http_buf_len < PBCC_HTTP_BUF_SIZE(&pb->core));
+                if ((0 == pb->proxy_saved_path_len) && (0 != save_proxy_path(pb))) {
+                    outcome_detected(pb, PNR_OUT_OF_MEMORY);
+                    break;
                 }
 #if PUBNUB_USE_SSL
                 if (pb->flags.trySSL) {
@@ -807,22 +1062,12 @@ next_state:
                     break;
                 }
                 if (!pb->proxy_tunnel_established) {
-                    PUBNUB_ASSERT_OPT(pb->core.http_buf_len < PUBNUB_BUF_MAXLEN);
-                    if (0 == pb->proxy_saved_path_len) {
-                        memcpy(pb->proxy_saved_path,
-                               pb->core.http_buf,
-                               pb->core.http_buf_len + 1);
-                        pb->proxy_saved_path_len = pb->core.http_buf_len;
+                    PUBNUB_ASSERT_OPT(pb->core.http_buf_len < PBCC_HTTP_BUF_SIZE(&pb->core));
+                    if ((0 == pb->proxy_saved_path_len) && (0 != save_proxy_path(pb))) {
+                        outcome_detected(pb, PNR_OUT_OF_MEMORY);
+                        break;
                     }
                 }
-                else if (pb->proxy_saved_path_len > 0) {
-                    PUBNUB_ASSERT_OPT(pb->proxy_saved_path_len < PUBNUB_BUF_MAXLEN);
-                    memmove(pb->core.http_buf,
-                            pb->proxy_saved_path,
-                            pb->proxy_saved_path_len + 1);
-                    pb->core.http_buf_len    = pb->proxy_saved_path_len;
-                    pb->proxy_saved_path_len = 0;
-                }
                 break;
             case pbproxyNONE:
                 pb->state = PBS_TX_PATH;
@@ -886,7 +1131,7 @@ next_state:
             }
             else {
                 pb->state = PBS_TX_PATH;
-                if (-1 == pbpal_send_str(pb, pb->core.http_buf)) {
+                if (-1 == pbpal_send_str(pb, proxy_path_to_send(pb))) {
                     outcome_detected(pb, PNR_IO_ERROR);
                     break;
                 }
@@ -902,7 +1147,7 @@ next_state:
             outcome_detected(pb, PNR_IO_ERROR);
         }
         else if (0 == i) {
-            if (0 > pbpal_send_literal_str(pb, " HTTP/1.1\r\nHost: ")) {
+            if (0 > pbpal_send_literal_str(pb, HTTP_VERSION_AND_HOST)) {
                 outcome_detected(pb, PNR_IO_ERROR);
                 break;
             }
@@ -913,9 +1158,8 @@ next_state:
     case PBS_TX_VER:
         i = pbpal_send_status(pb);
         if (i <= 0) {
-            char const* o = PUBNUB_ORIGIN_SETTABLE ? pb->origin : PUBNUB_ORIGIN;
-            pb->state     = PBS_TX_ORIGIN;
-            if ((i < 0) || (-1 == pbpal_send_str(pb, o))) {
+            pb->state = PBS_TX_ORIGIN;
+            if ((i < 0) || (-1 == pbpal_send_str(pb, request_origin(pb)))) {
                 outcome_detected(pb, PNR_IO_ERROR);
                 break;
             }
@@ -1039,7 +1283,10 @@ next_state:
             WATCH_USHORT(pb->http_code);
             pb->core.http_content_len = 0;
             pb->http_chunked          = false;
-            pb->state                 = PBS_RX_HEADERS;
+#if PUBNUB_RECEIVE_GZIP_RESPONSE
+            pb->data_compressed = compressionNONE;
+#endif
+            pb->state = PBS_RX_HEADERS;
             goto next_state;
         case PNR_CONNECTION_TIMEOUT:
         case PNR_TIMEOUT:
@@ -1087,6 +1334,17 @@ next_state:
             WATCH_INT(read_len);
             if (read_len <= 2) {
                 pb->core.http_buf_len = 0;
+#if PUBNUB_RECEIVE_GZIP_RESPONSE && PUBNUB_DYNAMIC_REPLY_BUFFER
+                if (GZIP_STREAMING(pb) && (pbgzip_stream_start(pb) != PNR_OK)) {
+                    pb->data_compressed = compressionNONE;
+                    outcome_detected(pb, PNR_REPLY_TOO_BIG);
+                    break;
+                }
+#endif
+                if (start_history_stream(pb) != 0) {
+                    outcome_detected(pb, PNR_REPLY_TOO_BIG);
+                    break;
+                }
                 if (!pb->http_chunked) {
                     if (0 == pb->core.http_content_len) {
 #if PUBNUB_PROXY_API
@@ -1115,7 +1373,7 @@ next_state:
             }
             else if (strncmp(pb->core.http_buf, h_length, sizeof h_length - 1) == 0) {
                 size_t len = atoi(pb->core.http_buf + sizeof h_length - 1);
-                if (0 != pbcc_realloc_reply_buffer(&pb->core, len)) {
+                if (0 != reserve_reply_buffer(pb, len)) {
                     outcome_detected(pb, PNR_REPLY_TOO_BIG);
                     break;
                 }
@@ -1153,6 +1411,10 @@ next_state:
         break;
     case PBS_RX_BODY:
         if (pb->core.http_buf_len < pb->core.http_content_len) {
+            if (HISTORY_STREAM_FULL(pb)) {
+                /* Wait for the user to take some messages */
+                break;
+            }
             pbpal_start_read(pb, pb->core.http_content_len - pb->core.http_buf_len);
             pb->state = PBS_RX_BODY_WAIT;
             goto next_state;
@@ -1178,8 +1440,11 @@ next_state:
             WATCH_SIZE_T(pb->core.http_buf_len);
             PUBNUB_ASSERT_OPT(pb->core.http_buf_len + len
                               <= pb->core.http_content_len);
-            memcpy(pb->core.http_reply + pb->core.http_buf_len, pb->core.http_buf, len);
-            pb->core.http_buf_len += len;
+            pbrslt = append_to_reply(pb, pb->core.http_buf, len);
+            if (pbrslt != PNR_OK) {
+                outcome_detected(pb, pbrslt);
+                break;
+            }
             pb->state = PBS_RX_BODY;
             goto next_state;
         }
@@ -1211,8 +1476,8 @@ next_state:
 #endif
             }
             else if (0
-                     != pbcc_realloc_reply_buffer(
-                            &pb->core, pb->core.http_buf_len + chunk_length)) {
+                     != reserve_reply_buffer(
+                            pb, pb->core.http_buf_len + chunk_length)) {
                 outcome_detected(pb, PNR_REPLY_TOO_BIG);
             }
             else {
@@ -1229,6 +1494,10 @@ next_state:
         break;
     case PBS_RX_BODY_CHUNK:
         if (pb->core.http_content_len > 0) {
+            if (HISTORY_STREAM_FULL(pb)) {
+                /* Wait for the user to take some messages */
+                break;
+            }
             pbpal_start_read(pb, pb->core.http_content_len);
             pb->state = PBS_RX_BODY_CHUNK_WAIT;
         }
@@ -1253,10 +1522,11 @@ next_state:
                 if (len < to_copy) {
                     to_copy = len;
                 }
-                memcpy(pb->core.http_reply + pb->core.http_buf_len,
-                       pb->core.http_buf,
-                       to_copy);
-                pb->core.http_buf_len += to_copy;
+                pbrslt = append_to_reply(pb, pb->core.http_buf, to_copy);
+                if (pbrslt != PNR_OK) {
+                    outcome_detected(pb, pbrslt);
+                    break;
+                }
             }
             pb->core.http_content_len -= len;
             pb->state = PBS_RX_BODY_CHUNK;
@@ -1299,6 +1569,7 @@ next_state:
         }
         break;
     case PBS_KEEP_ALIVE_IDLE:
+        pbcc_release_reply_buffer(&pb->core);
 #if PUBNUB_PROXY_API
         pb->proxy_saved_path_len     = 0;
         pb->proxy_authorization_sent = false;
@@ -134,4 +134,40 @@ void pbnc_stop(struct pubnub_* pb, enum pubnub_res outcome_to_report);
 bool pbnc_can_start_transaction(struct pubnub_ const* pbp);
 
 
+/** Returns whether the request of the current transaction of the
+    context @p pb may be replayed, as it may when it's sent as TLS
+    early data (0-RTT). Only requests of idempotent transactions, sent
+    via GET with no proxy, may be replayed.
+ */
+bool pbnc_request_replayable(struct pubnub_ const* pb);
+
+
+/** Formats the whole HTTP request head for the current transaction of
+    the context @p pb to @p buf - the same bytes that sending a request
+    with no body, with no proxy, puts on the wire.
+
+    @param pb The context for which to format the request head
+    @param buf The buffer to format the request head to
+    @param n The size of @p buf
+    @return The length of the formatted request head, 0 if it doesn't
+    fit in @p buf
+ */
+size_t pbnc_request_head(struct pubnub_* pb, char* buf, size_t n);
+
+
+/** Formats the whole HTTP request for the current transaction of the
+    context @p pb to @p buf, if it may be sent as TLS early data
+    (0-RTT). As early data may be replayed by an attacker, only
+    requests that pbnc_request_replayable() allows may be sent this
+    way, and only if the user enabled it on @p pb.
+
+    @param pb The context for which to format the request
+    @param buf The buffer to format the request to
+    @param n The size of @p buf
+    @return The length of the formatted request, 0 if it may not be
+    sent as early data, or doesn't fit in @p buf
+ */
+size_t pbnc_early_data_request(struct pubnub_* pb, char* buf, size_t n);
+
+
 #endif /* !defined INC_PUBNUB_NETCORE */
@@ -102,19 +102,26 @@ enum pubnub_res pubnub_last_result(pubnub_t* pb)
 }
 
 
-enum pubnub_res pubnub_await(pubnub_t* pb)
+enum pubnub_res pbntf_await_progress(pubnub_t* pb,
+                                     enum pubnub_res (*progress)(pubnub_t* pb, void* data),
+                                     void* data)
 {
     pbmsref_t       t0;
     enum pubnub_res result;
     bool            stopped = false;
 
     PUBNUB_ASSERT(pb_valid_ctx_ptr(pb));
+    PUBNUB_ASSERT_OPT(progress != NULL);
 
     pubnub_mutex_lock(pb->monitor);
     t0 = pbms_start();
-    while (!pbnc_can_start_transaction(pb)) {
+    while (PNR_IN_PROGRESS == (result = progress(pb, data))) {
         pbms_t delta;
 
+        if (pbnc_can_start_transaction(pb)) {
+            result = pb->core.last_result;
+            break;
+        }
         pbnc_fsm(pb);
 
         delta = pbms_elapsed(t0);
@@ -125,12 +132,29 @@ enum pubnub_res pubnub_await(pubnub_t* pb)
                 stopped = true;
             }
             else {
+                result = pb->core.last_result;
                 break;
             }
         }
     }
-    result = pb->core.last_result;
     pubnub_mutex_unlock(pb->monitor);
 
     return result;
 }
+
+
+/** The progress of a plain transaction: there is none to report
+    before it ends.
+ */
+static enum pubnub_res no_progress(pubnub_t* pb, void* data)
+{
+    PUBNUB_UNUSED(pb);
+    PUBNUB_UNUSED(data);
+    return PNR_IN_PROGRESS;
+}
+
+
+enum pubnub_res pubnub_await(pubnub_t* pb)
+{
+    return pbntf_await_progress(pb, no_progress, NULL);
+}
@@ -9,6 +9,7 @@
 #include "lib/pb_strnlen_s.h"
 #include "core/pbcc_objects_api.h"
 #include "core/pubnub_objects_api.h"
+#include "core/pbpager.h"
 
 #include "core/pbpal.h"
 
@@ -698,3 +699,216 @@ enum pubnub_res pubnub_remove_members(pubnub_t* pb,
 
     return rslt;
 }
+
+
+/** Returns true if the last transaction on @p pb was a successful
+    Objects API transaction. To be called with the context locked.
+ */
+static bool have_objects_response(pubnub_t* pb)
+{
+    return pbnc_can_start_transaction(pb) && (PNR_OK == pb->core.last_result)
+           && (pb->trans >= PBTT_GET_USERS) && (pb->trans <= PBTT_REMOVE_MEMBERS);
+}
+
+
+pubnub_chamebl_t pubnub_get_objects_data_element(pubnub_t* pb)
+{
+    pubnub_chamebl_t rslt;
+
+    PUBNUB_ASSERT(pb_valid_ctx_ptr(pb));
+
+    pubnub_mutex_lock(pb->monitor);
+    if (have_objects_response(pb)) {
+        rslt = pbcc_get_objects_data_element(&pb->core);
+    }
+    else {
+        rslt.ptr  = NULL;
+        rslt.size = 0;
+    }
+    pubnub_mutex_unlock(pb->monitor);
+
+    return rslt;
+}
+
+
+static int get_objects_cursor(pubnub_t* pb, char const* name, pubnub_chamebl_t* o_cursor)
+{
+    int rslt = -1;
+
+    PUBNUB_ASSERT(pb_valid_ctx_ptr(pb));
+    PUBNUB_ASSERT_OPT(o_cursor != NULL);
+
+    pubnub_mutex_lock(pb->monitor);
+    if (have_objects_response(pb)) {
+        rslt = pbcc_get_objects_cursor(&pb->core, name, o_cursor);
+    }
+    pubnub_mutex_unlock(pb->monitor);
+
+    return rslt;
+}
+
+
+int pubnub_get_objects_next_cursor(pubnub_t* pb, pubnub_chamebl_t* o_cursor)
+{
+    return get_objects_cursor(pb, "next", o_cursor);
+}
+
+
+int pubnub_get_objects_prev_cursor(pubnub_t* pb, pubnub_chamebl_t* o_cursor)
+{
+    return get_objects_cursor(pb, "prev", o_cursor);
+}
+
+
+/** Takes the next element of the page on @p pb for the pager, once
+    the page is received.
+ */
+static enum pubnub_res take_page_element(pubnub_t* pb, void* elem, bool* o_have)
+{
+    pubnub_chamebl_t* o_elem = (pubnub_chamebl_t*)elem;
+
+    if (!pbnc_can_start_transaction(pb)) {
+        return PNR_IN_PROGRESS;
+    }
+    if (pb->core.last_result != PNR_OK) {
+        return pb->core.last_result;
+    }
+    *o_elem = pbcc_get_objects_data_element(&pb->core);
+    *o_have = (o_elem->ptr != NULL);
+
+    return PNR_OK;
+}
+
+
+/** Starts fetching, on the context @p pb, the page of @p pager that
+    starts at the cursor @p start (NULL for the first page).
+ */
+static enum pubnub_res start_objects_page(struct pbpager* pager,
+                                          pubnub_t* pb,
+                                          char const* start)
+{
+    struct pubnub_objects_pager* op = (struct pubnub_objects_pager*)pager;
+    enum pubnub_res              rslt;
+
+    switch (op->list) {
+    case pbolUsers:
+        rslt = pubnub_get_users(pb,
+                                op->include,
+                                op->include_count,
+                                op->limit,
+                                start,
+                                NULL,
+                                pbccNotSet);
+        break;
+    case pbolSpaces:
+        rslt = pubnub_get_spaces(pb,
+                                 op->include,
+                                 op->include_count,
+                                 op->limit,
+                                 start,
+                                 NULL,
+                                 pbccNotSet);
+        break;
+    case pbolMemberships:
+        rslt = pubnub_get_memberships(pb,
+                                      op->id,
+                                      op->include,
+                                      op->include_count,
+                                      op->limit,
+                                      start,
+                                      NULL,
+                                      pbccNotSet);
+        break;
+    case pbolMembers:
+        rslt = pubnub_get_members(pb,
+                                  op->id,
+                                  op->include,
+                                  op->include_count,
+                                  op->limit,
+                                  start,
+                                  NULL,
+                                  pbccNotSet);
+        break;
+    default:
+        rslt = PNR_INTERNAL_ERROR;
+        break;
+    }
+    return rslt;
+}
+
+
+/** The next page starts at the "next" cursor of the current one.
+    A page without one is the last.
+ */
+static int objects_page_received(struct pbpager* pager, pubnub_t* pb, void const* elem)
+{
+    pubnub_chamebl_t cursor;
+
+    PUBNUB_UNUSED(elem);
+    pubnub_mutex_lock(pb->monitor);
+    if (pbcc_get_objects_cursor(&pb->core, "next", &cursor) != 0) {
+        pubnub_mutex_unlock(pb->monitor);
+        return +1;
+    }
+    if (cursor.size >= sizeof pager->next_start) {
+        pubnub_mutex_unlock(pb->monitor);
+        PUBNUB_LOG_ERROR("pager=%p: Objects API page cursor too long: %lu\n",
+                         pager,
+                         (unsigned long)cursor.size);
+        return -1;
+    }
+    memcpy(pager->next_start, cursor.ptr, cursor.size);
+    pager->next_start[cursor.size] = '\0';
+    pubnub_mutex_unlock(pb->monitor);
+
+    return 0;
+}
+
+
+static struct pbpager_api const m_objects_pager_api = {
+    start_objects_page,
+    take_page_element,
+    objects_page_received,
+    sizeof(pubnub_chamebl_t)
+};
+
+
+enum pubnub_res pubnub_objects_pager_start(struct pubnub_objects_pager* pager,
+                                           pubnub_t* pb,
+                                           pubnub_t* prefetch_pb,
+                                           enum pubnub_objects_list list,
+                                           char const* id,
+                                           char const** include,
+                                           size_t include_count,
+                                           size_t limit)
+{
+    PUBNUB_ASSERT_OPT(pager != NULL);
+
+    pager->list          = list;
+    pager->id            = id;
+    pager->include       = include;
+    pager->include_count = include_count;
+    pager->limit         = limit;
+
+    /* A page with fewer elements than the limit is not necessarily
+       the last one, the server might have a lower limit */
+    return pbpager_start(&pager->pager, &m_objects_pager_api, pb, prefetch_pb, 0);
+}
+
+
+enum pubnub_res pubnub_objects_pager_next(struct pubnub_objects_pager* pager,
+                                          pubnub_chamebl_t* o_elem)
+{
+    PUBNUB_ASSERT_OPT(pager != NULL);
+    PUBNUB_ASSERT_OPT(o_elem != NULL);
+
+    return pbpager_next(&pager->pager, o_elem);
+}
+
+
+void pubnub_objects_pager_stop(struct pubnub_objects_pager* pager)
+{
+    PUBNUB_ASSERT_OPT(pager != NULL);
+
+    pbpager_stop(&pager->pager);
+}
@@ -4,6 +4,8 @@
 
 
 #include "pubnub_api_types.h"
+#include "pubnub_memory_block.h"
+#include "pbpager.h"
 
 #include <stdbool.h>
 
@@ -423,4 +425,110 @@ enum pubnub_res pubnub_remove_members(pubnub_t* pb,
                                       char const* update_obj);
 
 
+/** Returns the next element of the "data" array from the response of
+    the last (successful) Objects API transaction on @p pb - a user,
+    space, membership or member JSON object - without copying
+    anything: the returned memory block points into the response and
+    is valid until the next transaction is started on @p pb. If "data"
+    is a single object (like in the response to pubnub_get_user()),
+    it is returned as the only element.
+    This doesn't affect pubnub_get(), which still returns the whole
+    response.
+    @return The element, or a memory block with `ptr` NULL if there
+    are no more elements (or a transaction is in progress, or the last
+    one was not a successful Objects API transaction)
+  */
+pubnub_chamebl_t pubnub_get_objects_data_element(pubnub_t* pb);
+
+/** Gets the "next" page cursor from the response of the last
+    (successful) Objects API transaction on @p pb, to use as the
+    `start` of the request for the next page. The cursor points into
+    the response, it is not NUL terminated.
+    @retval 0 cursor found and put in @p o_cursor
+    @retval -1 no "next" cursor (or a transaction is in progress, or
+               the last one was not a successful Objects API
+               transaction)
+  */
+int pubnub_get_objects_next_cursor(pubnub_t* pb, pubnub_chamebl_t* o_cursor);
+
+/** Same as pubnub_get_objects_next_cursor(), but for the "prev" page
+    cursor, to use as the `end` of the request for the previous page.
+  */
+int pubnub_get_objects_prev_cursor(pubnub_t* pb, pubnub_chamebl_t* o_cursor);
+
+
+/** The lists that the Objects API pager can go through */
+enum pubnub_objects_list {
+    /** Users, as with pubnub_get_users() */
+    pbolUsers,
+    /** Spaces, as with pubnub_get_spaces() */
+    pbolSpaces,
+    /** Space memberships of a user, as with pubnub_get_memberships() */
+    pbolMemberships,
+    /** Members of a space, as with pubnub_get_members() */
+    pbolMembers
+};
+
+/** Pages through an Objects API list with two contexts: while the
+    elements are taken from the page on one, the next page is being
+    fetched on the other. Both contexts have to be initialized, and
+    not used by anything else while paging. The members are internal,
+    use the pubnub_objects_pager_*() functions.
+  */
+struct pubnub_objects_pager {
+    /** The part common to all pagers, has to be the first member */
+    struct pbpager pager;
+    /** The list to go through */
+    enum pubnub_objects_list list;
+    /** The user ID (for memberships) or space ID (for members) */
+    char const* id;
+    /** Additional attributes to include in the response */
+    char const** include;
+    /** Number of elements of `include` */
+    size_t include_count;
+    /** Number of elements per page, 0 for the default */
+    size_t limit;
+};
+
+/** Starts going through the @p list with @p pager, using the contexts
+    @p pb and @p prefetch_pb. The parameters @p id (for
+    #pbolMemberships and #pbolMembers, ignored otherwise),
+    @p include, @p include_count and @p limit have the same meaning
+    as for the function that gets a page of the @p list and have to
+    stay valid while paging. In the sync interface, both contexts use
+    non-blocking I/O (see pubnub_set_non_blocking_io()) until the
+    pager is stopped, or the last page is done, when the I/O mode
+    they had before is restored. That way, the next page is read in
+    the background while the elements of the current one are taken.
+    @return The result of starting the transaction for the first
+    page, on @p pb
+  */
+enum pubnub_res pubnub_objects_pager_start(struct pubnub_objects_pager* pager,
+                                           pubnub_t* pb,
+                                           pubnub_t* prefetch_pb,
+                                           enum pubnub_objects_list list,
+                                           char const* id,
+                                           char const** include,
+                                           size_t include_count,
+                                           size_t limit);
+
+/** Takes the next element of the list from @p pager, putting it in
+    @p o_elem, like pubnub_get_objects_data_element() does, just going
+    from page to page. In the sync interface, waits for the page to
+    be received, in the callback interface returns #PNR_IN_PROGRESS
+    if it was not received yet.
+    @retval PNR_OK element taken, or, if `ptr` of @p o_elem is NULL,
+                   there are no more (the last page is done)
+    @retval PNR_IN_PROGRESS page not received yet (callback interface)
+    @retval otherwise error getting the page, paging is stopped
+  */
+enum pubnub_res pubnub_objects_pager_next(struct pubnub_objects_pager* pager,
+                                          pubnub_chamebl_t* o_elem);
+
+/** Stops @p pager, cancelling the transactions it has in progress,
+    and restoring the I/O mode of its contexts.
+ */
+void pubnub_objects_pager_stop(struct pubnub_objects_pager* pager);
+
+
 #endif /* !defined INC_PUBNUB_OBJECTS_API */
@@ -237,7 +237,7 @@ int pbpal_send_status(pubnub_t* pb)
 
 int pbpal_start_read_line(pubnub_t* pb)
 {
-    unsigned distance;
+    size_t distance;
 
     PUBNUB_ASSERT_INT_OPT(pb->sock_state, ==, STATE_NONE);
 
@@ -329,7 +329,7 @@ enum pubnub_res pbpal_line_read_status(pubnub_t* pb)
             pb->sock_state = STATE_NONE;
             return PNR_TIMEOUT;
         }
-        PUBNUB_ASSERT_OPT(recvres <= pb->left);
+        PUBNUB_ASSERT_OPT((size_t)recvres <= pb->left);
         PUBNUB_LOG_TRACE(
             "pb=%p have new data of length=%d: %.*s\n", pb, recvres, recvres, pb->ptr);
         pb->unreadlen = recvres;
@@ -344,7 +344,7 @@ enum pubnub_res pbpal_line_read_status(pubnub_t* pb)
             PUBNUB_LOG_TRACE("pb=%p, newline found, line length: %d, ",
                              pb,
                              pbpal_read_len(pb));
-            WATCH_USHORT(pb->unreadlen);
+            WATCH_SIZE_T(pb->unreadlen);
             pb->sock_state = STATE_NONE;
             return PNR_OK;
         }
@@ -362,20 +362,20 @@ enum pubnub_res pbpal_line_read_status(pubnub_t* pb)
 
 int pbpal_start_read(pubnub_t* pb, size_t n)
 {
-    unsigned distance;
+    size_t distance;
 
     PUBNUB_ASSERT_UINT_OPT(n, >, 0);
     PUBNUB_ASSERT_INT_OPT(pb->sock_state, ==, STATE_NONE);
 
-    WATCH_USHORT(pb->unreadlen);
-    WATCH_USHORT(pb->left);
+    WATCH_SIZE_T(pb->unreadlen);
+    WATCH_SIZE_T(pb->left);
     if (pb->unreadlen > 0) {
         PUBNUB_ASSERT_OPT((char*)(pb->ptr + pb->unreadlen)
                           <= (char*)(pb->core.http_buf + PUBNUB_BUF_MAXLEN));
         memmove(pb->core.http_buf, pb->ptr, pb->unreadlen);
     }
     distance = pb->ptr - (uint8_t*)pb->core.http_buf;
-    WATCH_UINT(distance);
+    WATCH_SIZE_T(distance);
     PUBNUB_ASSERT_UINT(distance + pb->unreadlen + pb->left,
                        ==,
                        sizeof pb->core.http_buf / sizeof pb->core.http_buf[0]);
@@ -395,7 +395,7 @@ enum pubnub_res pbpal_read_status(pubnub_t* pb)
     PUBNUB_ASSERT_OPT(STATE_READ == pb->sock_state);
 
     if (0 == pb->unreadlen) {
-        unsigned to_recv = pb->len;
+        size_t to_recv = pb->len;
         if (to_recv > pb->left) {
             to_recv = pb->left;
         }
@@ -408,11 +408,11 @@ enum pubnub_res pbpal_read_status(pubnub_t* pb)
             pb->sock_state = STATE_NONE;
             return PNR_TIMEOUT;
         }
-        PUBNUB_ASSERT_OPT(pb->left >= have_read);
+        PUBNUB_ASSERT_OPT(pb->left >= (size_t)have_read);
         pb->left -= have_read;
     }
     else {
-        have_read = (pb->unreadlen >= pb->len) ? pb->len : pb->unreadlen;
+        have_read = (int)((pb->unreadlen >= pb->len) ? pb->len : pb->unreadlen);
         pb->unreadlen -= have_read;
     }
 
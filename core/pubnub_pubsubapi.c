@@ -5,11 +5,14 @@
 #include "core/pubnub_ccore.h"
 #include "core/pubnub_netcore.h"
 #include "core/pubnub_assert.h"
+#include "core/pbmem.h"
+#include "core/pubnub_log.h"
 #include "core/pubnub_timers.h"
 
 #include "core/pbpal.h"
 
 #include <ctype.h>
+#include <stdlib.h>
 #include <string.h>
 
 pubnub_t* pubnub_init(pubnub_t* p, const char* publish_key, const char* subscribe_key)
@@ -154,6 +157,20 @@ char const* pubnub_get(pubnub_t* pb)
 }
 
 
+size_t pubnub_get_batch(pubnub_t* pb, char const** out, size_t max)
+{
+    size_t result;
+    PUBNUB_ASSERT(pb_valid_ctx_ptr(pb));
+    PUBNUB_ASSERT_OPT((out != NULL) || (0 == max));
+
+    pubnub_mutex_lock(pb->monitor);
+    result = pbcc_get_msg_batch(&pb->core, out, max);
+    pubnub_mutex_unlock(pb->monitor);
+
+    return result;
+}
+
+
 char const* pubnub_get_channel(pubnub_t* pb)
 {
     char const* result;
@@ -282,6 +299,19 @@ char const* pubnub_last_time_token(pubnub_t* pb)
 }
 
 
+uint64_t pubnub_last_time_token_u64(pubnub_t* pb)
+{
+    uint64_t result;
+    PUBNUB_ASSERT(pb_valid_ctx_ptr(pb));
+
+    pubnub_mutex_lock(pb->monitor);
+    result = pb->core.timetoken_u64;
+    pubnub_mutex_unlock(pb->monitor);
+
+    return result;
+}
+
+
 static char const* do_last_publish_result(pubnub_t* pb)
 {
     char* end;
@@ -361,6 +391,52 @@ int pubnub_origin_set(pubnub_t* pb, char const* origin)
 }
 
 
+int pubnub_set_http_buffer_size(pubnub_t* p, size_t size)
+{
+    int rslt = -1;
+
+    PUBNUB_ASSERT(pb_valid_ctx_ptr(p));
+#if PUBNUB_DYNAMIC_HTTP_BUFFER
+    if ((size < PUBNUB_MIN_HTTP_BUF_SIZE) || (size > PUBNUB_MAX_HTTP_BUF_SIZE)) {
+        PUBNUB_LOG_ERROR("pubnub_set_http_buffer_size(pb=%p): size=%lu out of range\n",
+                         p,
+                         (unsigned long)size);
+        return -1;
+    }
+    pubnub_mutex_lock(p->monitor);
+    if (PBS_IDLE == p->state) {
+        rslt = pbcc_set_http_buf_size(&p->core, size);
+        if (0 == rslt) {
+            p->ptr       = (uint8_t*)p->core.http_buf;
+            p->left      = size;
+            p->unreadlen = 0;
+        }
+    }
+    pubnub_mutex_unlock(p->monitor);
+#else
+    PUBNUB_UNUSED(size);
+#endif
+
+    return rslt;
+}
+
+
+int pubnub_release_reply(pubnub_t* p)
+{
+    int rslt = -1;
+
+    PUBNUB_ASSERT(pb_valid_ctx_ptr(p));
+    pubnub_mutex_lock(p->monitor);
+    if ((PBS_IDLE == p->state) || (PBS_KEEP_ALIVE_IDLE == p->state)) {
+        pbcc_release_reply_buffer(&p->core);
+        rslt = 0;
+    }
+    pubnub_mutex_unlock(p->monitor);
+
+    return rslt;
+}
+
+
 void pubnub_use_http_keep_alive(pubnub_t* p)
 {
     p->options.use_http_keep_alive = 1;
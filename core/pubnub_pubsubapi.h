@@ -6,6 +6,8 @@
 #include "pubnub_api_types.h"
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 
 
 /** @file pubnub_pubsubapi.h
@@ -177,6 +179,25 @@ enum pubnub_res pubnub_signal(pubnub_t* pb,
  */
 char const* pubnub_get(pubnub_t* p);
 
+/** Gets the next (up to) @p max messages from the context @p p into
+    @p out, just like calling pubnub_get() for each of them would,
+    but with much less overhead (the context is locked only once).
+    Useful when there are a lot of messages to get, like after
+    a "catch up" subscribe.
+
+    Messages are, just like those returned by pubnub_get(), valid
+    until the next transaction is started on @p p.
+
+    @param p The Pubnub context. Can't be NULL.
+    @param out The array to put (the pointers to) the messages in
+    @param max The number of elements in @p out
+
+    @return Number of messages put into @p out, 0 if there are no
+    (more) messages
+    @see pubnub_get
+ */
+size_t pubnub_get_batch(pubnub_t* p, char const** out, size_t max);
+
 /** Returns a pointer to an fetched subscribe operation/transaction's
     next channel.  Each transaction may hold a list of channels, and
     this functions provides a way to read them.  Subsequent call to
@@ -269,6 +290,15 @@ char const* pubnub_last_publish_result(pubnub_t* p);
  */
 char const* pubnub_last_time_token(pubnub_t* p);
 
+/** Returns the last received time token on the @c p context as an
+    integer, which is simpler (and faster) to compare or store than
+    the string returned by pubnub_last_time_token(). After
+    pubnub_init() this should be 0.
+    @param p Pubnub context to get the last received time token from
+    @return The last received time token
+ */
+uint64_t pubnub_last_time_token_u64(pubnub_t* p);
+
 /** Gets the origin to be used for the context @p p.
     If setting of the origin is not enabled, this will return
     the default origin.
@@ -326,5 +356,48 @@ void pubnub_use_http_keep_alive(pubnub_t* p);
 */
 void pubnub_dont_use_http_keep_alive(pubnub_t* p);
 
+/** Sets the size of the HTTP buffer of the context @p p to @p size
+    bytes.  The HTTP buffer holds the request (URL-encoded, so it
+    limits the size of the message you can publish) and the lines
+    of the HTTP response header.  The buffer for encrypted messages,
+    if used, has the same size.
+
+    The default is #PUBNUB_BUF_MAXLEN, which is a lot for contexts
+    that only publish small messages, so if you have many such
+    contexts, you can save a lot of memory by setting a smaller size.
+    On the other hand, contexts that do bulk transfers may set a
+    large buffer (say, 256 KB - 1 MB), to send the request and receive
+    the response in fewer and larger reads and writes.
+
+    This works only if #PUBNUB_DYNAMIC_HTTP_BUFFER is true and
+    there is no transaction on the context @p p, nor a connection
+    kept alive, so it's best to call it right after pubnub_init().
+
+    @param p The Pubnub context to set the HTTP buffer size for
+    @param size The size to set, at least #PUBNUB_MIN_HTTP_BUF_SIZE
+                and at most #PUBNUB_MAX_HTTP_BUF_SIZE
+    @retval 0 size set
+    @retval -1 size not set, buffer not changed
+ */
+int pubnub_set_http_buffer_size(pubnub_t* p, size_t size);
+
+/** Releases the reply of the last transaction on the context @p p.
+    If #PUBNUB_DYNAMIC_REPLY_BUFFER is true, reply buffers are
+    borrowed from a process-wide pool when a transaction starts
+    receiving the response and returned to it when the next
+    transaction starts (or the context is freed). Call this when you
+    are done with the outcome of a transaction (got all the messages,
+    channels, response body...) and don't start a new one right away,
+    so that other contexts can use the buffer in the mean time.
+
+    After this, there are no messages (nor channels) to get from
+    the context, as if the last transaction had no response.
+
+    @param p The Pubnub context to release the reply of
+    @retval 0 released (or there was nothing to release)
+    @retval -1 not released, as a transaction is in progress
+ */
+int pubnub_release_reply(pubnub_t* p);
+
 
 #endif /* !defined INC_PUBNUB_PUBSUBAPI */
@@ -10,5 +10,8 @@
 /** The maximum channel name length */
 #define PUBNUB_MAX_CHANNEL_NAME_LENGTH 92
 
+/** The maximum number of messages in one history response */
+#define PUBNUB_MAX_HISTORY_COUNT 100
+
 #endif /* !defined INC_PUBNUB_SERVER_LIMITS */
 
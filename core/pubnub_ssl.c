@@ -65,6 +65,30 @@ void pubnub_ssl_set_pem_cert(pubnub_t *p, char const *contents)
 }
 
 
+void pubnub_set_ssl_early_data(pubnub_t *p, bool use)
+{
+    PUBNUB_ASSERT(pb_valid_ctx_ptr(p));
+
+#if PUBNUB_USE_SSL
+    pubnub_mutex_lock(p->monitor);
+    p->options.use_tls_early_data = use;
+    pubnub_mutex_unlock(p->monitor);
+#endif
+}
+
+
+void pubnub_set_ssl_ktls(pubnub_t *p, bool use)
+{
+    PUBNUB_ASSERT(pb_valid_ctx_ptr(p));
+
+#if PUBNUB_USE_SSL
+    pubnub_mutex_lock(p->monitor);
+    p->options.use_ktls = use;
+    pubnub_mutex_unlock(p->monitor);
+#endif
+}
+
+
 void pubnub_set_reuse_ssl_session(pubnub_t *p, bool reuse)
 {
     PUBNUB_ASSERT(pb_valid_ctx_ptr(p));
@@ -39,11 +39,58 @@ void pubnub_set_ssl_options(pubnub_t *p, bool useSSL, bool ignoreSecureConnectio
     @note While reusing SSL sessions can provide for great speed-up of
     TLS/SSL session establishment, it is also prone to errors.
 
+    On OpenSSL, sessions are also shared among contexts (see
+    pubnub_ssl_get_handshake_stats()).
+
     @param p The context for which to set the option for SSL session reuse
     @param reuse The value (true/false == on/off) of the option
  */
 void pubnub_set_reuse_ssl_session(pubnub_t *p, bool reuse);
 
+/** Sets the option to send the request of idempotent transactions
+    as TLS 1.3 early data (0-RTT) to @p use on the context @p p.
+    This saves one round-trip on each new connection, which is a
+    big part of the latency of a transaction on (mobile) links which
+    drop connections often.
+
+    Early data is sent only when all of these hold:
+    - the session to resume is a TLS 1.3 one and the server allowed
+    early data in it, so it is only used if SSL sessions are reused
+    (see pubnub_set_reuse_ssl_session()) and OpenSSL is 1.1.1 or newer
+    - the transaction only reads data, so it is safe if the request
+    gets replayed: subscribe, time, history, here-now, where-now,
+    get state, list channel group and message counts
+    - the request is sent via GET and not through a proxy
+
+    If the server rejects the early data, the request is sent as
+    usual, after the handshake.
+
+    Default is off (false).
+
+    @param p The context for which to set the option for early data
+    @param use The value (true/false == on/off) of the option
+ */
+void pubnub_set_ssl_early_data(pubnub_t *p, bool use);
+
+/** Sets the option to offload TLS record encryption and decryption
+    to the kernel (Linux kernel TLS, "kTLS") to @p use on the context
+    @p p. Once the handshake is done, the data is sent and received
+    with plain socket calls, without copying it through user-space
+    crypto, which saves CPU on bulk transfers (history, objects...).
+
+    This is only a request: it has effect only with OpenSSL 3.0 or
+    newer built with kTLS support, on a kernel with the `tls` module
+    loaded, for a cipher the kernel supports. Otherwise (and for the
+    direction that the kernel doesn't support), TLS is done in
+    user-space as usual.
+
+    Default is off (false).
+
+    @param p The context for which to set the option for kTLS
+    @param use The value (true/false == on/off) of the option
+ */
+void pubnub_set_ssl_ktls(pubnub_t *p, bool use);
+
 /** Sets the location(s) of CA certificates for verification
     purposes. This is only available on targets that have a file
     system.
@@ -131,4 +178,29 @@ void pubnub_ssl_dont_use_system_certificate_store(pubnub_t *p);
  */
 void pubnub_ssl_set_usrdef_pem_cert(pubnub_t *p, char const *contents);
 
+
+/** Process-wide counters of TLS/SSL handshakes */
+struct pubnub_ssl_handshake_stats {
+    /** Number of full handshakes (no session was resumed) */
+    unsigned long full;
+    /** Number of handshakes which resumed a previous session */
+    unsigned long resumed;
+};
+
+/** Gets the process-wide counters of full and resumed TLS/SSL
+    handshakes, to check the session resumption rate.
+
+    Sessions are resumed only on contexts which reuse SSL sessions
+    (see pubnub_set_reuse_ssl_session()). Such a context will resume
+    the session it established itself, or, if it has none (for
+    example, it was just created, or it dropped its session because
+    of an error), the last session established to the same origin by
+    any context with the same certificate settings.
+
+    This is only available on targets that use OpenSSL.
+
+    @param stats Pointer to the structure to fill with the counters
+ */
+void pubnub_ssl_get_handshake_stats(struct pubnub_ssl_handshake_stats* stats);
+
 #endif /* defined INC_PUBNUB_SSL */
@@ -13,6 +13,9 @@
 
 #include "pbpal.h"
 
+#include <limits.h>
+#include <string.h>
+
 
 struct pubnub_subscribe_v2_options pubnub_subscribe_v2_defopts(void)
 {
@@ -67,3 +70,48 @@ struct pubnub_v2_message pubnub_get_v2(pubnub_t* pb)
 
     return result;
 }
+
+
+size_t pubnub_get_v2_batch(pubnub_t* pb, struct pubnub_v2_message* out, size_t max)
+{
+    size_t result;
+    PUBNUB_ASSERT(pb_valid_ctx_ptr(pb));
+    PUBNUB_ASSERT_OPT((out != NULL) || (0 == max));
+
+    pubnub_mutex_lock(pb->monitor);
+    result = pbcc_get_msg_v2_batch(&pb->core, out, max);
+    pubnub_mutex_unlock(pb->monitor);
+
+    return result;
+}
+
+
+size_t pubnub_v2_message_count(pubnub_t* pb)
+{
+    size_t rslt;
+    PUBNUB_ASSERT(pb_valid_ctx_ptr(pb));
+
+    pubnub_mutex_lock(pb->monitor);
+    rslt = pbcc_msg_v2_count(&pb->core);
+    pubnub_mutex_unlock(pb->monitor);
+
+    return rslt;
+}
+
+
+struct pubnub_v2_message pubnub_get_v2_at(pubnub_t* pb, size_t index)
+{
+    struct pubnub_v2_message result;
+    PUBNUB_ASSERT(pb_valid_ctx_ptr(pb));
+
+    pubnub_mutex_lock(pb->monitor);
+    if (index > UINT_MAX) {
+        memset(&result, 0, sizeof result);
+    }
+    else {
+        result = pbcc_get_msg_v2_at(&pb->core, (unsigned)index);
+    }
+    pubnub_mutex_unlock(pb->monitor);
+
+    return result;
+}
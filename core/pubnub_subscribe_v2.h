@@ -100,6 +100,43 @@ enum pubnub_res pubnub_subscribe_v2(pubnub_t*                          p,
 struct pubnub_v2_message pubnub_get_v2(pubnub_t* pbp);
 
 
+/** Gets the next (up to) @p max V2 messages from the context @p pbp
+    into @p out, just like calling pubnub_get_v2() for each of them
+    would, but with much less overhead (the context is locked only
+    once). To get all the messages at once, size @p out with
+    pubnub_v2_message_count(). Unlike with pubnub_get_v2(), messages
+    that are not valid (have no payload) are skipped, rather than
+    ending the batch.
+
+    @return Number of messages put into @p out, 0 if there are no
+    (more) messages
+ */
+size_t pubnub_get_v2_batch(pubnub_t* pbp, struct pubnub_v2_message* out, size_t max);
+
+
+/** Returns the number of V2 messages received in the last subscribe
+    V2 transaction on the context @p pbp - regardless of how many of
+    them were already gotten with pubnub_get_v2().
+
+    Messages are indexed when the response is received, so this
+    (as well as pubnub_get_v2() and pubnub_get_v2_at()) doesn't
+    parse anything.
+ */
+size_t pubnub_v2_message_count(pubnub_t* pbp);
+
+
+/** Returns the V2 message with the given @p index (starting from 0)
+    received in the last subscribe V2 transaction on the context
+    @p pbp. Unlike pubnub_get_v2(), messages may be gotten in any
+    order, any number of times, and this doesn't change which
+    message pubnub_get_v2() returns next.
+
+    If @p index is not less than pubnub_v2_message_count(), this
+    will return an empty message v2 structure.
+ */
+struct pubnub_v2_message pubnub_get_v2_at(pubnub_t* pbp, size_t index);
+
+
 
 
 #endif /* !defined INC_PUBNUB_SUBSCRIBE_V2 */
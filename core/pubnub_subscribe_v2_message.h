@@ -7,6 +7,7 @@
 #endif
 
 #include <stdbool.h>
+#include <stdint.h>
 #include "pubnub_memory_block.h"
 
 /* subscribe_v2 message types */
@@ -46,6 +47,9 @@ struct pubnub_v2_message {
     struct pubnub_char_mem_block metadata;
     /** Indicates the message type: a signal, published, or something else */ 
     enum pubnub_message_type message_type;
+    /** The time token of the message, as an integer (0 if not valid)
+        @see pubnub_timetoken_to_u64() */
+    uint64_t tt_u64;
 };
 
 
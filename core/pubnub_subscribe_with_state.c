@@ -29,12 +29,12 @@ static enum pubnub_res pbcc_subscribe_with_state_prep(struct pbcc_context *p,
     p->msg_ofs = p->msg_end = 0;
 
     p->http_buf_len = snprintf(p->http_buf,
-                               sizeof p->http_buf,
+                               PBCC_HTTP_BUF_SIZE(p),
                                "/subscribe/%s/",
                                p->subscribe_key);
     APPEND_URL_ENCODED_M(pb, channel);
     p->http_buf_len += snprintf(p->http_buf + p->http_buf_len,
-                                sizeof p->http_buf - p->http_buf_len,
+                                PBCC_HTTP_BUF_SIZE(p) - p->http_buf_len,
                                 "/0/%s?pnsdk=%s",
                                 p->timetoken,
                                 pubnub_uname());
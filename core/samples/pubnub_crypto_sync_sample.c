@@ -7,6 +7,7 @@
 #include "core/pubnub_pubsubapi.h"
 #include "core/pubnub_coreapi_ex.h"
 #include "core/pubnub_crypto.h"
+#include "core/pubnub_allocator.h"
 
 #include <stdio.h>
 #include <time.h>
@@ -127,7 +128,7 @@ int main()
                 break;
             }
             puts((char*)mebl.ptr);
-            free(mebl.ptr);
+            pubnub_free_memory(mebl.ptr);
         }
     }
     else {
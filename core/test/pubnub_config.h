@@ -128,11 +128,21 @@
  */
 #define PUBNUB_MIN_WAIT_CONNECT_TIMER 5000
 
+#if !defined(PUBNUB_USE_SUBSCRIBE_V2)
+/** If true (!=0) will enable using the subscribe v2 API */
+#define PUBNUB_USE_SUBSCRIBE_V2 1
+#endif
+
 #if !defined(PUBNUB_USE_ADVANCED_HISTORY)
 /** If true (!=0) will enable using the advanced history API, which
     provides more data about (unread) messages. */
 #define PUBNUB_USE_ADVANCED_HISTORY 1
 #endif
 
+#if !defined(PUBNUB_USE_OBJECTS_API)
+/** If true (!=0) will enable using the objects API */
+#define PUBNUB_USE_OBJECTS_API 1
+#endif
+
 
 #endif /* !defined INC_PUBNUB_CONFIG */
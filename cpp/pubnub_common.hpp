@@ -8,6 +8,8 @@ extern "C" {
 #endif
 #include "pubnub_config.h"
 #include "core/pubnub_alloc.h"
+#include "core/pubnub_allocator.h"
+#include "core/pubnub_memory_stats.h"
 #include "core/pubnub_pubsubapi.h"
 #include "core/pubnub_coreapi.h"
 #include "core/pubnub_coreapi_ex.h"
@@ -596,14 +598,14 @@ public:
         return (NULL == msg) ? "" : msg;
     }
     /// Returns a vector of all messages from the context.
+    /// @see pubnub_get_batch
     std::vector<std::string> get_all() const
     {
         std::vector<std::string> all;
-        while (char const* msg = pubnub_get(d_pb)) {
-            if (NULL == msg) {
-                break;
-            }
-            all.push_back(msg);
+        char const*              msgs[64];
+        size_t                   n;
+        while ((n = pubnub_get_batch(d_pb, msgs, sizeof msgs / sizeof msgs[0])) > 0) {
+            all.insert(all.end(), msgs, msgs + n);
         }
         return all;
     }
@@ -617,17 +619,17 @@ public:
     {
         return v2_message(pubnub_get_v2(d_pb));
     }
-    /// Returns a vector of all v2 messages from the context.
+    /// Returns a vector of all (remaining) v2 messages from the
+    /// context.
+    /// @see pubnub_get_v2_batch
     std::vector<v2_message> get_all_v2() const
     {
-        std::vector<v2_message> all;
-        v2_message msg = get_v2();
-
-        while (!msg.is_empty()) {
-            all.push_back(msg);
-            msg = get_v2();
+        std::vector<pubnub_v2_message> msgs(pubnub_v2_message_count(d_pb));
+        if (msgs.empty()) {
+            return std::vector<v2_message>();
         }
-        return all;
+        size_t n = pubnub_get_v2_batch(d_pb, &msgs[0], msgs.size());
+        return std::vector<v2_message>(msgs.begin(), msgs.begin() + n);
     }
 #endif /* PUBNUB_USE_SUBSCRIBE_V2 */
 
@@ -644,7 +646,7 @@ public:
             return "";
         }
         std::string rslt(reinterpret_cast<char*>(mebl.ptr));
-        ::free(mebl.ptr);
+        pubnub_free_memory(mebl.ptr);
         return rslt;
     }
     /// Returns the all the remaining messages from the context,
@@ -661,7 +663,7 @@ public:
                 break;
             }
             all.push_back(reinterpret_cast<char*>(mebl.ptr));
-            ::free(mebl.ptr);
+            pubnub_free_memory(mebl.ptr);
         }
         return all;
     }
@@ -905,20 +907,12 @@ public:
     std::map<std::string, size_t> get_channel_message_counts()
     {
         std::map<std::string, size_t> map;
-        std::vector<pubnub_chan_msg_count> chan_msg_counters;
-        int i;
-        int count = pubnub_get_chan_msg_counts_size(d_pb);
-        if (count <= 0) {
-            return map;
-        }
-        chan_msg_counters = std::vector<pubnub_chan_msg_count>(count);
-        if (pubnub_get_chan_msg_counts(d_pb, (size_t*)&count, &chan_msg_counters[0]) != 0) {
-            return map;
-        }
-        for (i = 0; i < count; i++) {
-            map.insert(std::make_pair(std::string(chan_msg_counters[i].channel.ptr,
-                                                  chan_msg_counters[i].channel.size),
-                                      chan_msg_counters[i].message_count));
+        for (pubnub_chan_msg_count counter = pubnub_get_chan_msg_count(d_pb);
+             counter.channel.ptr != NULL;
+             counter = pubnub_get_chan_msg_count(d_pb)) {
+            map.insert(std::make_pair(
+                std::string(counter.channel.ptr, counter.channel.size),
+                counter.message_count));
         }
         return map;
     }
@@ -1494,6 +1488,13 @@ public:
         return pubnub_last_time_token(d_pb);
     }
 
+    /// Return the last time token as an integer.
+    /// @see pubnub_last_time_token_u64
+    uint64_t last_time_token_u64() const
+    {
+        return pubnub_last_time_token_u64(d_pb);
+    }
+
     /// Sets whether to use (non-)blocking I/O according to option @p e.
     /// @see pubnub_set_blocking_io, pubnub_set_non_blocking_io
     int set_blocking_io(blocking_io e)
@@ -1633,6 +1634,13 @@ public:
     }
 #endif
 
+    /// Reports the memory allocated by this context
+    /// @see pubnub_memory_stats
+    int memory_stats(pubnub_memory_report& report)
+    {
+        return pubnub_memory_stats(d_pb, &report);
+    }
+
     /// Frees the context and any other thing that needs to be
     /// freed/released.
     /// @see pubnub_free
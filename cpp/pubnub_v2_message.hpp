@@ -17,6 +17,7 @@ public:
     v2_message(struct pubnub_v2_message message_v2) { d_ = message_v2; }
     v2_message() { memset(&d_, 0, sizeof d_); }
     std::string tt() const { return std::string(d_.tt.ptr, d_.tt.size); }
+    uint64_t tt_u64() const { return d_.tt_u64; }
     int region() const { return d_.region; }
     int flags() const { return d_.flags; }
     std::string channel() const { return std::string(d_.channel.ptr, d_.channel.size); } 
@@ -2,6 +2,7 @@
 #include "lib/base64/pbbase64.h"
 
 #include "core/pubnub_assert.h"
+#include "core/pbmem.h"
 #include "core/pubnub_log.h"
 
 #include <string.h>
@@ -81,12 +82,12 @@ pubnub_bymebl_t pbbase64_encode_alloc(pubnub_bymebl_t                data,
 {
     pubnub_bymebl_t result;
     result.size = pbbase64_char_array_size_for_encoding(data.size);
-    result.ptr  = (uint8_t*)malloc(result.size);
+    result.ptr  = (uint8_t*)pbmem_alloc_user(result.size);
     if (NULL == result.ptr) {
         return result;
     }
     if (0 != pbbase64_encode(data, (char*)result.ptr, &result.size, options)) {
-        free(result.ptr);
+        pbmem_free_user(result.ptr);
         result.ptr = NULL;
     }
     return result;
@@ -219,12 +220,12 @@ pubnub_bymebl_t pbbase64_decode_alloc(char const*                    s,
 {
     pubnub_bymebl_t result;
     result.size = pbbase64_decoded_length(n) + 1; /* +1 "just in case" */
-    result.ptr  = (uint8_t*)malloc(result.size);
+    result.ptr  = (uint8_t*)pbmem_alloc_user(result.size);
     if (NULL == result.ptr) {
         return result;
     }
     if (0 != pbbase64_decode(s, n, &result, options)) {
-        free(result.ptr);
+        pbmem_free_user(result.ptr);
         result.ptr = NULL;
     }
     return result;
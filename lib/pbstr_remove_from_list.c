@@ -1,6 +1,7 @@
 /* -*- c-file-style:"stroustrup"; indent-tabs-mode: nil -*- */
 #include "lib/pb_strnlen_s.h"
 #include "core/pubnub_assert.h"
+#include "core/pbmem.h"
 
 #include <stdlib.h>
 #include <string.h>
@@ -73,7 +74,7 @@ void pbstr_free_if_empty(char** list)
     PUBNUB_ASSERT_OPT(l != NULL);
     
     if ('\0' == *l) {
-        free(l);
+        pbmem_free(l);
         *list = NULL;
     }
 }
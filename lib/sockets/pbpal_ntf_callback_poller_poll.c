@@ -7,6 +7,7 @@
 #include "core/pb_sleep_ms.h"
 
 #include "core/pubnub_assert.h"
+#include "core/pbmem.h"
 #include "core/pubnub_log.h"
 
 #include <string.h>
@@ -33,7 +34,7 @@ struct pbpal_poll_data* pbpal_ntf_callback_poller_init(void)
 {
     struct pbpal_poll_data* rslt;
 
-    rslt = (struct pbpal_poll_data*)malloc(sizeof *rslt);
+    rslt = (struct pbpal_poll_data*)pbmem_alloc(NULL, pbmemcatPoller, sizeof *rslt);
     if (NULL == rslt) {
         return NULL;
     }
@@ -59,9 +60,11 @@ void pbpal_ntf_callback_save_socket(struct pbpal_poll_data* data, pubnub_t* pb)
     if (data->size == data->cap) {
         size_t const   newcap = data->size + 2;
         struct pollfd* npalloc =
-            (struct pollfd*)realloc(data->apoll, sizeof data->apoll[0] * newcap);
+            (struct pollfd*)pbmem_realloc(
+                NULL, pbmemcatPoller, data->apoll, sizeof data->apoll[0] * newcap);
         pubnub_t** npapb =
-            (pubnub_t**)realloc(data->apb, sizeof data->apb[0] * newcap);
+            (pubnub_t**)pbmem_realloc(
+                NULL, pbmemcatPoller, data->apb, sizeof data->apb[0] * newcap);
         if (NULL == npalloc) {
             if (npapb != NULL) {
                 data->apb = npapb;
@@ -201,6 +204,6 @@ void pbpal_ntf_callback_poller_deinit(struct pbpal_poll_data** data)
     PUBNUB_ASSERT_OPT(data != NULL);
     PUBNUB_ASSERT_OPT(*data != NULL);
 
-    free(*data);
+    pbmem_free(*data);
     *data = NULL;
 }
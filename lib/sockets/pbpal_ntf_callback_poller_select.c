@@ -4,6 +4,7 @@
 #include "lib/sockets/pbpal_ntf_callback_poller_select.h"
 
 #include "core/pubnub_assert.h"
+#include "core/pbmem.h"
 #include "core/pubnub_log.h"
 
 #include <stdlib.h>
@@ -13,7 +14,7 @@ struct pbpal_poll_data* pbpal_ntf_callback_poller_init(void)
 {
     struct pbpal_poll_data* rslt;
 
-    rslt = (struct pbpal_poll_data*)malloc(sizeof *rslt);
+    rslt = (struct pbpal_poll_data*)pbmem_alloc(NULL, pbmemcatPoller, sizeof *rslt);
     if (NULL == rslt) {
         return NULL;
     }
@@ -231,6 +232,6 @@ void pbpal_ntf_callback_poller_deinit(struct pbpal_poll_data** data)
     PUBNUB_ASSERT_OPT(data != NULL);
     PUBNUB_ASSERT_OPT(*data != NULL);
 
-    free(*data);
+    pbmem_free(*data);
     *data = NULL;
 }
@@ -16,7 +16,7 @@
 static void buf_setup(pubnub_t* pb)
 {
     pb->ptr  = (uint8_t*)pb->core.http_buf;
-    pb->left = sizeof pb->core.http_buf / sizeof pb->core.http_buf[0];
+    pb->left = PBCC_HTTP_BUF_SIZE(&pb->core);
 }
 
 
@@ -51,9 +51,9 @@ int pbpal_send(pubnub_t* pb, void const* data, size_t n)
     PUBNUB_ASSERT_INT_OPT(pb->sock_state, ==, STATE_NONE);
 
     pb->ptr        = (uint8_t*)data;
-    pb->len        = (uint16_t)n;
+    pb->len        = n;
     pb->sock_state = STATE_SENDING_DATA;
-    pb->left       = sizeof pb->core.http_buf / sizeof pb->core.http_buf[0];
+    pb->left       = PBCC_HTTP_BUF_SIZE(&pb->core);
 
     return pbpal_send_status(pb);
 }
@@ -98,19 +98,19 @@ int pbpal_send_status(pubnub_t* pb)
 
 int pbpal_start_read_line(pubnub_t* pb)
 {
-    unsigned distance;
+    size_t distance;
 
     PUBNUB_ASSERT_INT_OPT(pb->sock_state, ==, STATE_NONE);
 
     if (pb->unreadlen > 0) {
         PUBNUB_ASSERT_OPT((char*)pb->ptr + pb->unreadlen
-                          <= pb->core.http_buf + PUBNUB_BUF_MAXLEN);
+                          <= pb->core.http_buf + PBCC_HTTP_BUF_SIZE(&pb->core));
         memmove(pb->core.http_buf, pb->ptr, pb->unreadlen);
     }
     distance = pb->ptr - (uint8_t*)pb->core.http_buf;
     PUBNUB_ASSERT_UINT(distance + pb->left + pb->unreadlen,
                        ==,
-                       sizeof pb->core.http_buf / sizeof pb->core.http_buf[0]);
+                       PBCC_HTTP_BUF_SIZE(&pb->core));
     pb->ptr -= distance;
     pb->left += distance;
 
@@ -127,12 +127,12 @@ enum pubnub_res pbpal_line_read_status(pubnub_t* pb)
     if (pb->unreadlen == 0) {
         int recvres;
         PUBNUB_ASSERT_OPT((char*)pb->ptr + pb->left
-                          == pb->core.http_buf + PUBNUB_BUF_MAXLEN);
+                          == pb->core.http_buf + PBCC_HTTP_BUF_SIZE(&pb->core));
         recvres = socket_recv(pb->pal.socket, (char*)pb->ptr, pb->left, 0);
         if (recvres <= 0) {
             return pbpal_handle_socket_error(recvres, pb, __FILE__, __LINE__);
         }
-        PUBNUB_ASSERT_OPT(recvres <= pb->left);
+        PUBNUB_ASSERT_OPT((size_t)recvres <= pb->left);
         PUBNUB_LOG_TRACE(
             "pb=%p have new data of length=%d: %.*s\n", pb, recvres, recvres, pb->ptr);
         pb->unreadlen = recvres;
@@ -149,7 +149,7 @@ enum pubnub_res pbpal_line_read_status(pubnub_t* pb)
             PUBNUB_LOG_TRACE("pb=%p, newline found, line length: %d, ",
                              pb,
                              pbpal_read_len(pb));
-            WATCH_USHORT(pb->unreadlen);
+            WATCH_SIZE_T(pb->unreadlen);
             pb->sock_state = STATE_NONE;
             return PNR_OK;
         }
@@ -174,23 +174,23 @@ int pbpal_read_len(pubnub_t* pb)
 
 int pbpal_start_read(pubnub_t* pb, size_t n)
 {
-    unsigned distance;
+    size_t distance;
 
     PUBNUB_ASSERT_UINT_OPT(n, >, 0);
     PUBNUB_ASSERT_INT_OPT(pb->sock_state, ==, STATE_NONE);
 
-    WATCH_USHORT(pb->unreadlen);
-    WATCH_USHORT(pb->left);
+    WATCH_SIZE_T(pb->unreadlen);
+    WATCH_SIZE_T(pb->left);
     if (pb->unreadlen > 0) {
         PUBNUB_ASSERT_OPT((char*)pb->ptr + pb->unreadlen
-                          <= pb->core.http_buf + PUBNUB_BUF_MAXLEN);
+                          <= pb->core.http_buf + PBCC_HTTP_BUF_SIZE(&pb->core));
         memmove(pb->core.http_buf, pb->ptr, pb->unreadlen);
     }
     distance = pb->ptr - (uint8_t*)pb->core.http_buf;
-    WATCH_UINT(distance);
+    WATCH_SIZE_T(distance);
     PUBNUB_ASSERT_UINT(distance + pb->unreadlen + pb->left,
                        ==,
-                       sizeof pb->core.http_buf / sizeof pb->core.http_buf[0]);
+                       PBCC_HTTP_BUF_SIZE(&pb->core));
     pb->ptr -= distance;
     pb->left += distance;
 
@@ -208,7 +208,7 @@ enum pubnub_res pbpal_read_status(pubnub_t* pb)
     PUBNUB_ASSERT_OPT(STATE_READ == pb->sock_state);
 
     if (0 == pb->unreadlen) {
-        unsigned to_recv = pb->len;
+        size_t to_recv = pb->len;
         if (to_recv > pb->left) {
             to_recv = pb->left;
         }
@@ -217,11 +217,11 @@ enum pubnub_res pbpal_read_status(pubnub_t* pb)
         if (have_read <= 0) {
             return pbpal_handle_socket_error(have_read, pb, __FILE__, __LINE__);
         }
-        PUBNUB_ASSERT_OPT(pb->left >= have_read);
+        PUBNUB_ASSERT_OPT(pb->left >= (size_t)have_read);
         pb->left -= have_read;
     }
     else {
-        have_read = (pb->unreadlen >= pb->len) ? pb->len : pb->unreadlen;
+        have_read = (int)((pb->unreadlen >= pb->len) ? pb->len : pb->unreadlen);
         pb->unreadlen -= have_read;
     }
 
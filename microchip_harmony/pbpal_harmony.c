@@ -13,7 +13,7 @@
 static void buf_setup(pubnub_t *pb)
 {
     pb->ptr = (uint8_t*)pb->core.http_buf;
-    pb->left = sizeof pb->core.http_buf;
+    pb->left = PBCC_HTTP_BUF_SIZE(&pb->core);
 }
 
 
@@ -155,7 +155,7 @@ enum pubnub_res pbpal_line_read_status(pubnub_t *pb)
 
 int pbpal_read_len(pubnub_t *pb)
 {
-    return sizeof pb->core.http_buf - pb->left;
+    return PBCC_HTTP_BUF_SIZE(&pb->core) - pb->left;
 }
 
 
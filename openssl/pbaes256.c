@@ -3,6 +3,7 @@
 
 #include "core/pubnub_log.h"
 #include "core/pubnub_assert.h"
+#include "core/pbmem.h"
 
 #include <openssl/evp.h>
 #include <openssl/err.h>
@@ -10,6 +11,41 @@
 #include <stdlib.h>
 
 
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+#include "pbpal_mutex.h"
+
+/** The AES-256-CBC cipher, fetched from the providers only once, as
+    the implicit fetch done by `EVP_aes_256_cbc()` looks it up (under
+    a lock) on every encryption/decryption.
+ */
+static EVP_CIPHER* volatile m_aes_256_cbc;
+
+/** Guards fetching of the cipher */
+pbpal_mutex_static_decl_and_init(m_aes_lock);
+#endif
+
+
+static EVP_CIPHER const* aes_256_cbc(void)
+{
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+    if (NULL == m_aes_256_cbc) {
+        pbpal_mutex_init_static(m_aes_lock);
+        pbpal_mutex_lock(m_aes_lock);
+        if (NULL == m_aes_256_cbc) {
+            m_aes_256_cbc = EVP_CIPHER_fetch(NULL, "AES-256-CBC", NULL);
+        }
+        pbpal_mutex_unlock(m_aes_lock);
+        if (NULL == m_aes_256_cbc) {
+            PUBNUB_LOG_WARNING("Failed to fetch AES-256-CBC, using the implicit one\n");
+            return EVP_aes_256_cbc();
+        }
+    }
+    return m_aes_256_cbc;
+#else
+    return EVP_aes_256_cbc();
+#endif
+}
+
 
 static int print_to_pubnub_log(const char *s, size_t len, void *p)
 {
@@ -26,7 +62,7 @@ static int do_encrypt(EVP_CIPHER_CTX* aes256, pubnub_bymebl_t msg, uint8_t const
 {
     int len = 0;
 
-    if (!EVP_EncryptInit_ex(aes256, EVP_aes_256_cbc(), NULL, key, iv)) {
+    if (!EVP_EncryptInit_ex(aes256, aes_256_cbc(), NULL, key, iv)) {
         ERR_print_errors_cb(print_to_pubnub_log, NULL);
         PUBNUB_LOG_ERROR("Failed to initialize AES-256 encryption\n");
         return -1;
@@ -77,7 +113,7 @@ pubnub_bymebl_t pbaes256_encrypt_alloc(pubnub_bymebl_t msg, uint8_t const* key,
         return result;
     }
 
-    result.ptr = (uint8_t*)malloc(msg.size + EVP_CIPHER_block_size(EVP_aes_256_cbc()));
+    result.ptr = (uint8_t*)pbmem_alloc_user(msg.size + EVP_CIPHER_block_size(aes_256_cbc()));
     if (NULL == result.ptr) {
         EVP_CIPHER_CTX_free(aes256);
         PUBNUB_LOG_ERROR("Failed to allocate memory for AES-256 encryption\n");
@@ -86,7 +122,7 @@ pubnub_bymebl_t pbaes256_encrypt_alloc(pubnub_bymebl_t msg, uint8_t const* key,
     
     encrypt_result = do_encrypt(aes256, msg, key, iv, &result);
     if (-1 == encrypt_result) {
-        free(result.ptr);
+        pbmem_free_user(result.ptr);
         result.ptr = NULL;
     }
     EVP_CIPHER_CTX_free(aes256);
@@ -98,7 +134,7 @@ pubnub_bymebl_t pbaes256_encrypt_alloc(pubnub_bymebl_t msg, uint8_t const* key,
 static int do_decrypt(EVP_CIPHER_CTX* aes256, pubnub_bymebl_t data, uint8_t const* key, uint8_t const* iv, pubnub_bymebl_t *msg)
 {
     int len = 0;
-    if (!EVP_DecryptInit_ex(aes256, EVP_aes_256_cbc(), NULL, key, iv)) {
+    if (!EVP_DecryptInit_ex(aes256, aes_256_cbc(), NULL, key, iv)) {
         ERR_print_errors_cb(print_to_pubnub_log, NULL);
         PUBNUB_LOG_ERROR("Failed to initialize AES-256 decryption\n");
         return -1;
@@ -127,7 +163,7 @@ int pbaes256_decrypt(pubnub_bymebl_t data, uint8_t const* key, uint8_t const* iv
     int result;
     EVP_CIPHER_CTX *aes256;
 
-    if (msg->size < data.size + EVP_CIPHER_block_size(EVP_aes_256_cbc()) + 1) {
+    if (msg->size < data.size + EVP_CIPHER_block_size(aes_256_cbc()) + 1) {
         PUBNUB_LOG_ERROR("Not enough room to save AES-256 decrypted data\n");
         return -1;
     }
@@ -152,8 +188,8 @@ pubnub_bymebl_t pbaes256_decrypt_alloc(pubnub_bymebl_t data, uint8_t const* key,
     EVP_CIPHER_CTX *aes256;
     pubnub_bymebl_t result;
 
-    result.size = data.size + EVP_CIPHER_block_size(EVP_aes_256_cbc()) + 1;
-    result.ptr = (uint8_t*)malloc(result.size);
+    result.size = data.size + EVP_CIPHER_block_size(aes_256_cbc()) + 1;
+    result.ptr = (uint8_t*)pbmem_alloc_user(result.size);
     if (NULL == result.ptr) {
         return result;
     }
@@ -161,7 +197,7 @@ pubnub_bymebl_t pbaes256_decrypt_alloc(pubnub_bymebl_t data, uint8_t const* key,
     aes256 = EVP_CIPHER_CTX_new();
     if (NULL == aes256) {
         PUBNUB_LOG_ERROR("Failed to allocate AES-256 decryption context\n");
-        free(result.ptr);
+        pbmem_free_user(result.ptr);
         result.ptr = NULL;
         return result;;
     }
@@ -172,7 +208,7 @@ pubnub_bymebl_t pbaes256_decrypt_alloc(pubnub_bymebl_t data, uint8_t const* key,
 
     if (decrypt_result != 0) {
         PUBNUB_LOG_ERROR("Failed AES-256 decryption\n");
-        free(result.ptr);
+        pbmem_free_user(result.ptr);
         result.ptr = NULL;
     }
 
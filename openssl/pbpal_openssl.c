@@ -4,9 +4,12 @@
 #include "core/pbpal.h"
 
 #include "pbpal_mutex.h"
+#include "pbpal_ssl_ctx_cache.h"
+#include "pbpal_ssl_session_cache.h"
 #include "core/pubnub_ntf_sync.h"
 #include "core/pubnub_netcore.h"
 #include "core/pubnub_assert.h"
+#include "core/pbmem.h"
 #include "core/pubnub_log.h"
 
 #include "lib/msstopwatch/msstopwatch.h"
@@ -20,8 +23,10 @@
 #define HTTP_PORT 80
 
 
+#if PBPAL_OPENSSL_NEEDS_LOCKING
 /** Locks used by OpenSSL */
 static pbpal_mutex_t* m_locks;
+#endif
 
 
 PUBNUB_STATIC_ASSERT(PUBNUB_TIMERS_API, need_TIMERS_API);
@@ -37,7 +42,59 @@ static int print_to_pubnub_log(const char* s, size_t len, void* p)
 }
 
 
-#if OPENSSL_API_COMPAT < 0x10100000L
+/* OpenSSL's own allocations go through pbmem, as TLS bookkeeping.
+   Since 1.1.0, the memory functions also get the source location.
+ */
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L
+#define PBPAL_OPENSSL_MEM_LOC , char const* file, int line
+#define PBPAL_OPENSSL_MEM_LOC_UNUSED \
+    PUBNUB_UNUSED(file);             \
+    PUBNUB_UNUSED(line)
+#else
+#define PBPAL_OPENSSL_MEM_LOC
+#define PBPAL_OPENSSL_MEM_LOC_UNUSED
+#endif
+
+static void* openssl_malloc(size_t num PBPAL_OPENSSL_MEM_LOC)
+{
+    PBPAL_OPENSSL_MEM_LOC_UNUSED;
+    return pbmem_alloc(NULL, pbmemcatTLS, num);
+}
+
+
+static void* openssl_realloc(void* ptr, size_t num PBPAL_OPENSSL_MEM_LOC)
+{
+    PBPAL_OPENSSL_MEM_LOC_UNUSED;
+    if (0 == num) {
+        pbmem_free(ptr);
+        return NULL;
+    }
+    return pbmem_realloc(NULL, pbmemcatTLS, ptr, num);
+}
+
+
+static void openssl_free(void* ptr PBPAL_OPENSSL_MEM_LOC)
+{
+    PBPAL_OPENSSL_MEM_LOC_UNUSED;
+    pbmem_free(ptr);
+}
+
+
+/** Has OpenSSL allocate through pbmem. This works only before
+    OpenSSL allocates anything, so, if OpenSSL was already used in
+    the process, it keeps its own allocator.
+ */
+static void openssl_set_mem_functions(void)
+{
+    if (!CRYPTO_set_mem_functions(openssl_malloc, openssl_realloc, openssl_free)) {
+        PUBNUB_LOG_WARNING("OpenSSL already allocated memory, its "
+                           "allocations will not go through Pubnub's "
+                           "allocator\n");
+    }
+}
+
+
+#if PBPAL_OPENSSL_NEEDS_LOCKING
 static void locking_callback(int mode, int type, const char* file, int line)
 {
     PUBNUB_LOG_TRACE("thread=%4lu mode=%s lock=%s %s:%d\n",
@@ -53,10 +110,9 @@ static void locking_callback(int mode, int type, const char* file, int line)
         pbpal_mutex_unlock(m_locks[type]);
     }
 }
-#endif
 
 
-#if !defined(_WIN32) && (OPENSSL_API_COMPAT < 0x10000000L)
+#if !defined(_WIN32)
 static unsigned long thread_id(void)
 {
     return (unsigned long)pbpal_thread_id();
@@ -67,28 +123,94 @@ static unsigned long thread_id(void)
 static int locks_setup(void)
 {
     int i;
-    m_locks = (pbpal_mutex_t*)calloc(CRYPTO_num_locks(), sizeof(pbpal_mutex_t));
+    m_locks = (pbpal_mutex_t*)pbmem_calloc(
+        NULL, pbmemcatTLS, CRYPTO_num_locks(), sizeof(pbpal_mutex_t));
     if (NULL == m_locks) {
         return -1;
     }
     for (i = 0; i < CRYPTO_num_locks(); ++i) {
         pbpal_mutex_init_std(m_locks[i]);
     }
-#if !defined(_WIN32) && (OPENSSL_API_COMPAT < 0x10000000L)
+#if !defined(_WIN32)
     // On Windows, OpenSSL has a suitable default
     CRYPTO_set_id_callback(thread_id);
 #endif
-#if OPENSSL_API_COMPAT < 0x10100000L
     CRYPTO_set_locking_callback(locking_callback);
-#endif
     return 0;
 }
 
 
+static int openssl_init(void)
+{
+    openssl_set_mem_functions();
+    ERR_load_BIO_strings();
+    SSL_load_error_strings();
+    SSL_library_init();
+    OpenSSL_add_all_algorithms();
+    PUBNUB_LOG_TRACE("SSLEAY_VERSION_NUMBER=%lx SSLeay()=%lx "
+                     "SSLeay_version(SSLEAY_VERSION)='%s'\n",
+                     SSLEAY_VERSION_NUMBER,
+                     SSLeay(),
+                     SSLeay_version(SSLEAY_VERSION));
+    return locks_setup();
+}
+#else
+/* Since 1.1.0, OpenSSL initializes itself and does its own locking,
+   so there's no global lock array and callbacks to serialize its
+   internals on.
+ */
+static int openssl_init(void)
+{
+    openssl_set_mem_functions();
+    if (!OPENSSL_init_ssl(OPENSSL_INIT_LOAD_SSL_STRINGS
+                              | OPENSSL_INIT_LOAD_CRYPTO_STRINGS,
+                          NULL)) {
+        return -1;
+    }
+    PUBNUB_LOG_TRACE("OPENSSL_VERSION_NUMBER=%lx OpenSSL_version_num()=%lx "
+                     "OpenSSL_version(OPENSSL_VERSION)='%s'\n",
+                     (unsigned long)OPENSSL_VERSION_NUMBER,
+                     (unsigned long)OpenSSL_version_num(),
+                     OpenSSL_version(OPENSSL_VERSION));
+    return 0;
+}
+#endif /* PBPAL_OPENSSL_NEEDS_LOCKING */
+
+
+/** Like `SSL_read()`, but via `SSL_read_ex()` if available, which
+    doesn't limit the length to an `int`. Returns the number of bytes
+    read, or <= 0 on failure, to be checked with `SSL_get_error()`.
+ */
+static int ssl_read(SSL* ssl, void* buf, size_t n)
+{
+#if PBPAL_HAVE_SSL_RW_EX
+    size_t have_read;
+    return SSL_read_ex(ssl, buf, n, &have_read) ? (int)have_read : 0;
+#else
+    return SSL_read(ssl, buf, (int)n);
+#endif
+}
+
+
+/** Like `SSL_write()`, but via `SSL_write_ex()` if available.
+    Returns the number of bytes written, or <= 0 on failure, to be
+    checked with `SSL_get_error()`.
+ */
+static int ssl_write(SSL* ssl, void const* buf, size_t n)
+{
+#if PBPAL_HAVE_SSL_RW_EX
+    size_t written;
+    return SSL_write_ex(ssl, buf, n, &written) ? (int)written : 0;
+#else
+    return SSL_write(ssl, buf, (int)n);
+#endif
+}
+
+
 static void buf_setup(pubnub_t* pb)
 {
     pb->ptr  = (uint8_t*)pb->core.http_buf;
-    pb->left = sizeof pb->core.http_buf / sizeof pb->core.http_buf[0];
+    pb->left = PBCC_HTTP_BUF_SIZE(&pb->core);
 }
 
 
@@ -96,16 +218,7 @@ static int pal_init(void)
 {
     static bool s_init = false;
     if (!s_init) {
-        ERR_load_BIO_strings();
-        SSL_load_error_strings();
-        SSL_library_init();
-        OpenSSL_add_all_algorithms();
-        PUBNUB_LOG_TRACE("SSLEAY_VERSION_NUMBER=%lx SSLeay()=%lx "
-                         "SSLeay_version(SSLEAY_VERSION)='%s'\n",
-                         SSLEAY_VERSION_NUMBER,
-                         SSLeay(),
-                         SSLeay_version(SSLEAY_VERSION));
-        if (locks_setup()) {
+        if (openssl_init()) {
             return -1;
         }
         if (0 != socket_platform_init()) {
@@ -126,6 +239,8 @@ void pbpal_init(pubnub_t* pb)
     pb->options.useSSL = pb->flags.trySSL = pb->options.fallbackSSL = true;
     pb->options.use_system_certificate_store                        = false;
     pb->options.reuse_SSL_session                                   = false;
+    pb->options.use_tls_early_data                                  = false;
+    pb->options.use_ktls                                            = false;
     pb->ssl_CAfile = pb->ssl_CApath = NULL;
     pb->ssl_userPEMcert             = NULL;
     pb->sock_state                  = STATE_NONE;
@@ -141,9 +256,9 @@ int pbpal_send(pubnub_t* pb, void const* data, size_t n)
     PUBNUB_ASSERT_INT_OPT(pb->sock_state, ==, STATE_NONE);
 
     pb->ptr        = (uint8_t*)data;
-    pb->len        = (uint16_t)n;
+    pb->len        = n;
     pb->sock_state = STATE_SENDING_DATA;
-    pb->left       = sizeof pb->core.http_buf / sizeof pb->core.http_buf[0];
+    pb->left       = PBCC_HTTP_BUF_SIZE(&pb->core);
 
     return pbpal_send_status(pb);
 }
@@ -180,9 +295,8 @@ enum pubnub_res pbpal_handle_socket_condition(int result, pubnub_t* pb, char con
             else {
                 /* Expire the IP for the next connect */
                 pb->pal.ip_timeout = 0;
-                if ((pb->pal.session != NULL) && pb->options.reuse_SSL_session) {
-                    SSL_SESSION_free(pb->pal.session);
-                    pb->pal.session = NULL;
+                if (pb->options.reuse_SSL_session) {
+                    pbpal_ssl_session_forget(pb);
                 }
                 PUBNUB_LOG_ERROR(
                     "pb=%p: TLS/SSL_I/O operation failed, PNR_TIMEOUT\n", pb);
@@ -197,9 +311,8 @@ enum pubnub_res pbpal_handle_socket_condition(int result, pubnub_t* pb, char con
             /* Expire the IP for the next connect */
             pb->pal.ip_timeout = 0;
             ERR_print_errors_cb(print_to_pubnub_log, pb);
-            if ((pb->pal.session != NULL) && pb->options.reuse_SSL_session) {
-                SSL_SESSION_free(pb->pal.session);
-                pb->pal.session = NULL;
+            if (pb->options.reuse_SSL_session) {
+                pbpal_ssl_session_forget(pb);
             }
             PUBNUB_LOG_ERROR(
                 "pb=%p: TLS/SSL_I/O operation failed, errno=%d\n", pb, errno);
@@ -228,7 +341,7 @@ int pbpal_send_status(pubnub_t* pb)
         rslt = socket_send(pb->pal.socket, (char*)pb->ptr, pb->len);
     }
     else {
-        rslt = SSL_write(ssl, pb->ptr, pb->len);
+        rslt = ssl_write(ssl, pb->ptr, pb->len);
     }
     if (rslt <= 0) {
         rslt = (pbpal_handle_socket_condition(rslt, pb, __FILE__, __LINE__) == PNR_IN_PROGRESS) ? +1
@@ -253,19 +366,19 @@ int pbpal_send_status(pubnub_t* pb)
 
 int pbpal_start_read_line(pubnub_t* pb)
 {
-    unsigned distance;
+    size_t distance;
 
     PUBNUB_ASSERT_INT_OPT(pb->sock_state, ==, STATE_NONE);
 
     if (pb->unreadlen > 0) {
         PUBNUB_ASSERT_OPT((char*)pb->ptr + pb->unreadlen
-                          <= pb->core.http_buf + PUBNUB_BUF_MAXLEN);
+                          <= pb->core.http_buf + PBCC_HTTP_BUF_SIZE(&pb->core));
         memmove(pb->core.http_buf, pb->ptr, pb->unreadlen);
     }
     distance = pb->ptr - (uint8_t*)pb->core.http_buf;
     PUBNUB_ASSERT_UINT(distance + pb->left + pb->unreadlen,
                        ==,
-                       sizeof pb->core.http_buf / sizeof pb->core.http_buf[0]);
+                       PBCC_HTTP_BUF_SIZE(&pb->core));
     pb->ptr -= distance;
     pb->left += distance;
 
@@ -288,18 +401,18 @@ enum pubnub_res pbpal_line_read_status(pubnub_t* pb)
         if (pb->unreadlen == 0) {
             int recvres;
             PUBNUB_ASSERT_OPT((char*)pb->ptr + pb->left
-                              == pb->core.http_buf + PUBNUB_BUF_MAXLEN);
+                              == pb->core.http_buf + PBCC_HTTP_BUF_SIZE(&pb->core));
             if (NULL == ssl) {
                 recvres = socket_recv(pb->pal.socket, (char*)pb->ptr, pb->left, 0);
             }
             else {
-                recvres = SSL_read(ssl, (char*)pb->ptr, pb->left);
+                recvres = ssl_read(ssl, pb->ptr, pb->left);
             }
             if (recvres <= 0) {
                 return pbpal_handle_socket_condition(recvres, pb, __FILE__, __LINE__);
             }
 
-            PUBNUB_ASSERT_OPT(recvres <= pb->left);
+            PUBNUB_ASSERT_OPT((size_t)recvres <= pb->left);
             PUBNUB_LOG_TRACE("pb=%p have new data of length=%d: %.*s\n",
                              pb,
                              recvres,
@@ -316,7 +429,7 @@ enum pubnub_res pbpal_line_read_status(pubnub_t* pb)
 
             c = *pb->ptr++;
             if (c == '\n') {
-                WATCH_USHORT(pb->unreadlen);
+                WATCH_SIZE_T(pb->unreadlen);
                 pb->sock_state = STATE_NONE;
                 return PNR_OK;
             }
@@ -346,23 +459,23 @@ int pbpal_read_len(pubnub_t* pb)
 
 int pbpal_start_read(pubnub_t* pb, size_t n)
 {
-    unsigned distance;
+    size_t distance;
 
     PUBNUB_ASSERT_UINT_OPT(n, >, 0);
     PUBNUB_ASSERT_INT_OPT(pb->sock_state, ==, STATE_NONE);
 
-    WATCH_USHORT(pb->unreadlen);
-    WATCH_USHORT(pb->left);
+    WATCH_SIZE_T(pb->unreadlen);
+    WATCH_SIZE_T(pb->left);
     if (pb->unreadlen > 0) {
         PUBNUB_ASSERT_OPT((char*)pb->ptr + pb->unreadlen
-                          <= pb->core.http_buf + PUBNUB_BUF_MAXLEN);
+                          <= pb->core.http_buf + PBCC_HTTP_BUF_SIZE(&pb->core));
         memmove(pb->core.http_buf, pb->ptr, pb->unreadlen);
     }
     distance = pb->ptr - (uint8_t*)pb->core.http_buf;
-    WATCH_UINT(distance);
+    WATCH_SIZE_T(distance);
     PUBNUB_ASSERT_UINT(distance + pb->unreadlen + pb->left,
                        ==,
-                       sizeof pb->core.http_buf / sizeof pb->core.http_buf[0]);
+                       PBCC_HTTP_BUF_SIZE(&pb->core));
     pb->ptr -= distance;
     pb->left += distance;
 
@@ -385,7 +498,7 @@ enum pubnub_res pbpal_read_status(pubnub_t* pb)
     */
     for (;;) {
         if (0 == pb->unreadlen) {
-            unsigned to_recv = pb->len;
+            size_t to_recv = pb->len;
             if (to_recv > pb->left) {
                 to_recv = pb->left;
             }
@@ -394,16 +507,16 @@ enum pubnub_res pbpal_read_status(pubnub_t* pb)
                 have_read = socket_recv(pb->pal.socket, (char*)pb->ptr, to_recv, 0);
             }
             else {
-                have_read = SSL_read(ssl, pb->ptr, to_recv);
+                have_read = ssl_read(ssl, pb->ptr, to_recv);
             }
             if (have_read <= 0) {
                 return pbpal_handle_socket_condition(have_read, pb, __FILE__, __LINE__);
             }
-            PUBNUB_ASSERT_OPT(pb->left >= have_read);
+            PUBNUB_ASSERT_OPT(pb->left >= (size_t)have_read);
             pb->left -= have_read;
         }
         else {
-            have_read = (pb->unreadlen >= pb->len) ? pb->len : pb->unreadlen;
+            have_read = (int)((pb->unreadlen >= pb->len) ? pb->len : pb->unreadlen);
             pb->unreadlen -= have_read;
         }
 
@@ -438,6 +551,10 @@ void pbpal_forget(pubnub_t* pb)
 int pbpal_close(pubnub_t* pb)
 {
     pb->unreadlen = 0;
+    if (pb->pal.early_data != NULL) {
+        pbmem_free(pb->pal.early_data);
+        pb->pal.early_data = NULL;
+    }
     if (pb->pal.ssl != NULL) {
         SSL_shutdown(pb->pal.ssl);
         SSL_free(pb->pal.ssl);
@@ -476,9 +593,14 @@ void pbpal_free(pubnub_t* pb)
         pb->pal.socket = SOCKET_INVALID;
         pb->sock_state = STATE_NONE;
     }
+    if (pb->pal.early_data != NULL) {
+        pbmem_free(pb->pal.early_data);
+        pb->pal.early_data = NULL;
+    }
     /* The rest, OTOH, is expected */
     if (pb->pal.ctx != NULL) {
-        SSL_CTX_free(pb->pal.ctx);
+        pbpal_ssl_ctx_release(pb->pal.ctx);
+        pb->pal.ctx = NULL;
         if (NULL != pb->pal.session) {
             SSL_SESSION_free(pb->pal.session);
             pb->pal.session = NULL;
@@ -0,0 +1,360 @@
+/* -*- c-file-style:"stroustrup"; indent-tabs-mode: nil -*- */
+#include "pbpal_ssl_ctx_cache.h"
+
+#include "pbpal_add_system_certs.h"
+#include "pbpal_ssl_session_cache.h"
+#include "pbpal_mutex.h"
+#include "pubnub_internal.h"
+#include "core/pubnub_assert.h"
+#include "core/pbmem.h"
+#include "core/pubnub_log.h"
+
+#include <openssl/pem.h>
+#include <openssl/err.h>
+#include <openssl/ssl.h>
+
+#include <string.h>
+#include <stdlib.h>
+
+
+/** An entry in the `SSL_CTX` cache. The key is the "trust
+    configuration", the value is the `SSL_CTX` with certificates
+    loaded according to it.
+ */
+struct pbpal_ssl_ctx_entry {
+    /** The cached OpenSSL context */
+    SSL_CTX* ctx;
+    /** Number of Pubnub contexts using @c ctx */
+    unsigned refcount;
+    /** Use system certificate store */
+    bool use_system_certificate_store;
+    /** (Copy of the) certificate store file, may be NULL */
+    char* CAfile;
+    /** (Copy of the) certificate store directory, may be NULL */
+    char* CApath;
+    /** (Copy of the) user-defined, in-memory PEM certificate, may be NULL */
+    char* userPEMcert;
+    /** Next entry in the cache list */
+    struct pbpal_ssl_ctx_entry* next;
+};
+
+
+/** The list of cached `SSL_CTX`es. There are only ever a few
+    different trust configurations in a process, so a list is just
+    fine.
+ */
+static struct pbpal_ssl_ctx_entry* m_ctx_list;
+
+/** Maximum number of cached `SSL_CTX`es which are not used by any
+    context. These are kept so that a context created after all the
+    others were freed doesn't have to load the certificates again (or
+    do a full TLS handshake, as sessions are cached per `SSL_CTX`).
+ */
+#if !defined PBPAL_SSL_CTX_MAX_IDLE
+#define PBPAL_SSL_CTX_MAX_IDLE 4
+#endif
+
+/** Guards @c m_ctx_list */
+pbpal_mutex_static_decl_and_init(m_lock);
+
+
+static int print_to_pubnub_log(const char* s, size_t len, void* p)
+{
+    PUBNUB_UNUSED(len);
+
+    PUBNUB_LOG_ERROR("From OpenSSL: SSL_CTX=%p '%s'", p, s);
+
+    return 0;
+}
+
+/* Starfields Inc (Class 2) Root certificate.
+   It was used to sign the server certificate of https://pubsub.pubnub.com.
+   (at the time of writing this, 2015-06-04).
+ */
+static char pubnub_cert_Starfield[] =
+    "-----BEGIN CERTIFICATE-----\n"
+    "MIIEDzCCAvegAwIBAgIBADANBgkqhkiG9w0BAQUFADBoMQswCQYDVQQGEwJVUzEl\n"
+    "MCMGA1UEChMcU3RhcmZpZWxkIFRlY2hub2xvZ2llcywgSW5jLjEyMDAGA1UECxMp\n"
+    "U3RhcmZpZWxkIENsYXNzIDIgQ2VydGlmaWNhdGlvbiBBdXRob3JpdHkwHhcNMDQw\n"
+    "NjI5MTczOTE2WhcNMzQwNjI5MTczOTE2WjBoMQswCQYDVQQGEwJVUzElMCMGA1UE\n"
+    "ChMcU3RhcmZpZWxkIFRlY2hub2xvZ2llcywgSW5jLjEyMDAGA1UECxMpU3RhcmZp\n"
+    "ZWxkIENsYXNzIDIgQ2VydGlmaWNhdGlvbiBBdXRob3JpdHkwggEgMA0GCSqGSIb3\n"
+    "DQEBAQUAA4IBDQAwggEIAoIBAQC3Msj+6XGmBIWtDBFk385N78gDGIc/oav7PKaf\n"
+    "8MOh2tTYbitTkPskpD6E8J7oX+zlJ0T1KKY/e97gKvDIr1MvnsoFAZMej2YcOadN\n"
+    "+lq2cwQlZut3f+dZxkqZJRRU6ybH838Z1TBwj6+wRir/resp7defqgSHo9T5iaU0\n"
+    "X9tDkYI22WY8sbi5gv2cOj4QyDvvBmVmepsZGD3/cVE8MC5fvj13c7JdBmzDI1aa\n"
+    "K4UmkhynArPkPw2vCHmCuDY96pzTNbO8acr1zJ3o/WSNF4Azbl5KXZnJHoe0nRrA\n"
+    "1W4TNSNe35tfPe/W93bC6j67eA0cQmdrBNj41tpvi/JEoAGrAgEDo4HFMIHCMB0G\n"
+    "A1UdDgQWBBS/X7fRzt0fhvRbVazc1xDCDqmI5zCBkgYDVR0jBIGKMIGHgBS/X7fR\n"
+    "zt0fhvRbVazc1xDCDqmI56FspGowaDELMAkGA1UEBhMCVVMxJTAjBgNVBAoTHFN0\n"
+    "YXJmaWVsZCBUZWNobm9sb2dpZXMsIEluYy4xMjAwBgNVBAsTKVN0YXJmaWVsZCBD\n"
+    "bGFzcyAyIENlcnRpZmljYXRpb24gQXV0aG9yaXR5ggEAMAwGA1UdEwQFMAMBAf8w\n"
+    "DQYJKoZIhvcNAQEFBQADggEBAAWdP4id0ckaVaGsafPzWdqbAYcaT1epoXkJKtv3\n"
+    "L7IezMdeatiDh6GX70k1PncGQVhiv45YuApnP+yz3SFmH8lU+nLMPUxA2IGvd56D\n"
+    "eruix/U0F47ZEUD0/CwqTRV/p2JdLiXTAAsgGh1o+Re49L2L7ShZ3U0WixeDyLJl\n"
+    "xy16paq8U4Zt3VekyvggQQto8PT7dL5WXXp59fkdheMtlb71cZBDzI0fmgAKhynp\n"
+    "VSJYACPq4xJDKVtHCN2MQWplBqjlIapBtJUhlbl90TSrE9atvNziPTnNvT51cKEY\n"
+    "WQPJIrSPnNVeKtelttQKbfi3QBFGmh95DmK/D5fs4C8fF5Q=\n"
+    "-----END CERTIFICATE-----\n";
+
+
+/* GlobalSign Root class 2 Certificate, used at the time of this
+   writing (2016-11-26):
+
+ 2 s:/C=BE/O=GlobalSign nv-sa/OU=Root CA/CN=GlobalSign Root CA
+   i:/C=BE/O=GlobalSign nv-sa/OU=Root CA/CN=GlobalSign Root CA
+
+ */
+static char pubnub_cert_GlobalSign[] =
+    "-----BEGIN CERTIFICATE-----\n"
+    "MIIDdTCCAl2gAwIBAgILBAAAAAABFUtaw5QwDQYJKoZIhvcNAQEFBQAwVzELMAkG\n"
+    "A1UEBhMCQkUxGTAXBgNVBAoTEEdsb2JhbFNpZ24gbnYtc2ExEDAOBgNVBAsTB1Jv\n"
+    "b3QgQ0ExGzAZBgNVBAMTEkdsb2JhbFNpZ24gUm9vdCBDQTAeFw05ODA5MDExMjAw\n"
+    "MDBaFw0yODAxMjgxMjAwMDBaMFcxCzAJBgNVBAYTAkJFMRkwFwYDVQQKExBHbG9i\n"
+    "YWxTaWduIG52LXNhMRAwDgYDVQQLEwdSb290IENBMRswGQYDVQQDExJHbG9iYWxT\n"
+    "aWduIFJvb3QgQ0EwggEiMA0GCSqGSIb3DQEBAQUAA4IBDwAwggEKAoIBAQDaDuaZ\n"
+    "jc6j40+Kfvvxi4Mla+pIH/EqsLmVEQS98GPR4mdmzxzdzxtIK+6NiY6arymAZavp\n"
+    "xy0Sy6scTHAHoT0KMM0VjU/43dSMUBUc71DuxC73/OlS8pF94G3VNTCOXkNz8kHp\n"
+    "1Wrjsok6Vjk4bwY8iGlbKk3Fp1S4bInMm/k8yuX9ifUSPJJ4ltbcdG6TRGHRjcdG\n"
+    "snUOhugZitVtbNV4FpWi6cgKOOvyJBNPc1STE4U6G7weNLWLBYy5d4ux2x8gkasJ\n"
+    "U26Qzns3dLlwR5EiUWMWea6xrkEmCMgZK9FGqkjWZCrXgzT/LCrBbBlDSgeF59N8\n"
+    "9iFo7+ryUp9/k5DPAgMBAAGjQjBAMA4GA1UdDwEB/wQEAwIBBjAPBgNVHRMBAf8E\n"
+    "BTADAQH/MB0GA1UdDgQWBBRge2YaRQ2XyolQL30EzTSo//z9SzANBgkqhkiG9w0B\n"
+    "AQUFAAOCAQEA1nPnfE920I2/7LqivjTFKDK1fPxsnCwrvQmeU79rXqoRSLblCKOz\n"
+    "yj1hTdNGCbM+w6DjY1Ub8rrvrTnhQ7k4o+YviiY776BQVvnGCv04zcQLcFGUl5gE\n"
+    "38NflNUVyRRBnMRddWQVDf9VMOyGj/8N7yy5Y0b2qvzfvGn9LhJIZJrglfCm7ymP\n"
+    "AbEVtQwdpf5pLGkkeB6zpxxxYu7KyJesF12KwvhHhm4qxFYxldBniYUr+WymXUad\n"
+    "DKqC5JlR3XC321Y9YeRq4VzW9v493kHMB65jUr9TU/Qr6cf9tveCX4XSQRjbgbME\n"
+    "HMUfpIBvFSDJ3gyICh3WZlXi/EjJKSZp4A==\n"
+    "-----END CERTIFICATE-----\n";
+
+
+static int add_pem_cert(SSL_CTX* sslCtx, char const* pem_cert)
+{
+    X509* cert;
+    BIO*  mem = BIO_new(BIO_s_mem());
+    if (NULL == mem) {
+        PUBNUB_LOG_ERROR("SSL_CTX=%p: Failed BIO_new for PEM certificate\n", sslCtx);
+        return -1;
+    }
+    BIO_puts(mem, pem_cert);
+    cert = PEM_read_bio_X509(mem, NULL, 0, NULL);
+    BIO_free(mem);
+    if (NULL == cert) {
+        ERR_print_errors_cb(print_to_pubnub_log, NULL);
+        PUBNUB_LOG_ERROR("SSL_CTX=%p: Failed to read PEM certificate\n", sslCtx);
+        return -1;
+    }
+
+    if (0 == X509_STORE_add_cert(SSL_CTX_get_cert_store(sslCtx), cert)) {
+        ERR_print_errors_cb(print_to_pubnub_log, NULL);
+        PUBNUB_LOG_ERROR("SSL_CTX=%p: Failed to add PEM certificate\n", sslCtx);
+        X509_free(cert);
+        return -1;
+    }
+    X509_free(cert);
+
+    return 0;
+}
+
+
+static int add_pubnub_cert(SSL_CTX* sslCtx)
+{
+    int rslt = add_pem_cert(sslCtx, pubnub_cert_Starfield);
+    return rslt || add_pem_cert(sslCtx, pubnub_cert_GlobalSign);
+}
+
+static void add_certs(SSL_CTX* ctx, struct pbpal_ssl_ctx_entry const* key)
+{
+    PUBNUB_LOG_TRACE(
+        "add_certs(SSL_CTX=%p): use_system_certificate_store=%d, "
+        "userPEMcert=%p, CAfile='%s', CApath='%s'.\n",
+        ctx,
+        key->use_system_certificate_store,
+        key->userPEMcert,
+        key->CAfile,
+        key->CApath);
+
+    if (key->use_system_certificate_store
+        && (0 == pbpal_add_system_certs(ctx))) {
+        return;
+    }
+
+    if (NULL != key->userPEMcert) {
+        add_pem_cert(ctx, key->userPEMcert);
+    }
+
+    if ((NULL == key->CAfile) && (NULL == key->CApath)) {
+        add_pubnub_cert(ctx);
+    }
+    else {
+        if (!SSL_CTX_load_verify_locations(ctx, key->CAfile, key->CApath)) {
+            ERR_print_errors_cb(print_to_pubnub_log, ctx);
+            PUBNUB_LOG_ERROR(
+                "SSL_CTX_load_verify_locations(CAfile=%s, CApath=%s) failed",
+                key->CAfile,
+                key->CApath);
+        }
+    }
+}
+
+
+static bool str_equal(char const* a, char const* b)
+{
+    if ((NULL == a) || (NULL == b)) {
+        return a == b;
+    }
+    return 0 == strcmp(a, b);
+}
+
+
+static char* str_dup(char const* s)
+{
+    char*  rslt;
+    size_t len;
+
+    if (NULL == s) {
+        return NULL;
+    }
+    len  = strlen(s) + 1;
+    rslt = (char*)pbmem_alloc(NULL, pbmemcatTLS, len);
+    if (NULL != rslt) {
+        memcpy(rslt, s, len);
+    }
+    return rslt;
+}
+
+
+static void entry_free(struct pbpal_ssl_ctx_entry* entry)
+{
+    if (NULL != entry->ctx) {
+        pbpal_ssl_session_cache_purge_ctx(entry->ctx);
+        SSL_CTX_free(entry->ctx);
+    }
+    pbmem_free(entry->CAfile);
+    pbmem_free(entry->CApath);
+    pbmem_free(entry->userPEMcert);
+    pbmem_free(entry);
+}
+
+
+static struct pbpal_ssl_ctx_entry* entry_new(pubnub_t* pb)
+{
+    struct pbpal_ssl_ctx_entry* entry;
+
+    entry = (struct pbpal_ssl_ctx_entry*)pbmem_calloc(
+        NULL, pbmemcatTLS, 1, sizeof *entry);
+    if (NULL == entry) {
+        return NULL;
+    }
+    entry->use_system_certificate_store = pb->options.use_system_certificate_store;
+    entry->CAfile      = str_dup(pb->ssl_CAfile);
+    entry->CApath      = str_dup(pb->ssl_CApath);
+    entry->userPEMcert = str_dup(pb->ssl_userPEMcert);
+    if (((NULL != pb->ssl_CAfile) && (NULL == entry->CAfile))
+        || ((NULL != pb->ssl_CApath) && (NULL == entry->CApath))
+        || ((NULL != pb->ssl_userPEMcert) && (NULL == entry->userPEMcert))) {
+        entry_free(entry);
+        return NULL;
+    }
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L
+    entry->ctx = SSL_CTX_new(TLS_client_method());
+#else
+    entry->ctx = SSL_CTX_new(SSLv23_client_method());
+#endif
+    if (NULL == entry->ctx) {
+        ERR_print_errors_cb(print_to_pubnub_log, NULL);
+        PUBNUB_LOG_ERROR("pb=%p SSL_CTX_new failed\n", pb);
+        entry_free(entry);
+        return NULL;
+    }
+    add_certs(entry->ctx, entry);
+    pbpal_ssl_session_cache_setup_ctx(entry->ctx);
+
+    return entry;
+}
+
+
+/** Frees the least recently created unused entries, so that at most
+    #PBPAL_SSL_CTX_MAX_IDLE of them remain. Must be called with the
+    lock held.
+ */
+static void free_surplus_idle(void)
+{
+    struct pbpal_ssl_ctx_entry** pentry = &m_ctx_list;
+    unsigned                     idle   = 0;
+
+    while (*pentry != NULL) {
+        struct pbpal_ssl_ctx_entry* entry = *pentry;
+        if ((0 == entry->refcount) && (++idle > PBPAL_SSL_CTX_MAX_IDLE)) {
+            PUBNUB_LOG_TRACE("Freeing shared SSL_CTX=%p\n", entry->ctx);
+            *pentry = entry->next;
+            entry_free(entry);
+        }
+        else {
+            pentry = &entry->next;
+        }
+    }
+}
+
+
+SSL_CTX* pbpal_ssl_ctx_acquire(pubnub_t* pb)
+{
+    struct pbpal_ssl_ctx_entry* entry;
+    SSL_CTX*                    rslt = NULL;
+
+    PUBNUB_ASSERT(pb_valid_ctx_ptr(pb));
+
+    pbpal_mutex_init_static(m_lock);
+    pbpal_mutex_lock(m_lock);
+    for (entry = m_ctx_list; entry != NULL; entry = entry->next) {
+        if ((entry->use_system_certificate_store
+             == pb->options.use_system_certificate_store)
+            && str_equal(entry->CAfile, pb->ssl_CAfile)
+            && str_equal(entry->CApath, pb->ssl_CApath)
+            && str_equal(entry->userPEMcert, pb->ssl_userPEMcert)) {
+            break;
+        }
+    }
+    if (NULL == entry) {
+        entry = entry_new(pb);
+        if (NULL != entry) {
+            entry->next = m_ctx_list;
+            m_ctx_list  = entry;
+            PUBNUB_LOG_TRACE("pb=%p: Created new shared SSL_CTX=%p\n", pb, entry->ctx);
+        }
+    }
+    if (NULL != entry) {
+        ++entry->refcount;
+        rslt = entry->ctx;
+    }
+    pbpal_mutex_unlock(m_lock);
+
+    return rslt;
+}
+
+
+void pbpal_ssl_ctx_release(SSL_CTX* ctx)
+{
+    struct pbpal_ssl_ctx_entry** pentry;
+    struct pbpal_ssl_ctx_entry*  entry;
+
+    PUBNUB_ASSERT_OPT(NULL != ctx);
+
+    pbpal_mutex_init_static(m_lock);
+    pbpal_mutex_lock(m_lock);
+    for (pentry = &m_ctx_list; *pentry != NULL; pentry = &(*pentry)->next) {
+        if ((*pentry)->ctx == ctx) {
+            break;
+        }
+    }
+    entry = *pentry;
+    PUBNUB_ASSERT_OPT(entry != NULL);
+    if (entry != NULL) {
+        PUBNUB_ASSERT_OPT(entry->refcount > 0);
+        if (0 == --entry->refcount) {
+            free_surplus_idle();
+        }
+    }
+    pbpal_mutex_unlock(m_lock);
+}
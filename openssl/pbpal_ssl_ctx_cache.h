@@ -0,0 +1,39 @@
+/* -*- c-file-style:"stroustrup"; indent-tabs-mode: nil -*- */
+#if !defined INC_PBPAL_SSL_CTX_CACHE
+#define      INC_PBPAL_SSL_CTX_CACHE
+
+#include "core/pubnub_api_types.h"
+
+#include "openssl/ssl.h"
+
+
+/** @file pbpal_ssl_ctx_cache.h
+    Process-wide cache of OpenSSL `SSL_CTX` objects. Creating a
+    `SSL_CTX` and loading certificates into its store is expensive
+    (both in CPU and memory), so all contexts that have the same
+    "trust configuration" (CA file, CA path, user-defined PEM
+    certificate and the use of the system certificate store) share
+    one, reference counted, `SSL_CTX`.
+ */
+
+
+/** Returns the `SSL_CTX` for the trust configuration of the context
+    @p pb. If there is no such `SSL_CTX` in the cache, creates it
+    and loads the certificates into its store. Either way, the
+    reference count of the returned `SSL_CTX` is incremented, so
+    the user has to release it with pbpal_ssl_ctx_release().
+
+    @param pb The Pubnub context for which to get the `SSL_CTX`
+    @return The `SSL_CTX` to use, NULL on failure
+ */
+SSL_CTX* pbpal_ssl_ctx_acquire(pubnub_t* pb);
+
+/** Releases the @p ctx acquired with pbpal_ssl_ctx_acquire(). When
+    the last user releases it, it stays in the cache for a while, as
+    another context may need it, but it will be freed if there are too
+    many such unused `SSL_CTX`es.
+ */
+void pbpal_ssl_ctx_release(SSL_CTX* ctx);
+
+
+#endif /* !defined INC_PBPAL_SSL_CTX_CACHE */
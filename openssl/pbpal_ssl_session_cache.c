@@ -0,0 +1,321 @@
+/* -*- c-file-style:"stroustrup"; indent-tabs-mode: nil -*- */
+#include "pbpal_ssl_session_cache.h"
+
+#include "pbpal_mutex.h"
+#include "pubnub_internal.h"
+#include "core/pubnub_ssl.h"
+#include "core/pubnub_assert.h"
+#include "core/pbmem.h"
+#include "core/pubnub_log.h"
+
+#include <openssl/err.h>
+#include <openssl/ssl.h>
+
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+
+
+/** An entry in the session cache: the last session established for
+    the given `SSL_CTX` and origin.
+ */
+struct pbpal_ssl_session_entry {
+    /** The `SSL_CTX` the session was established with */
+    SSL_CTX* ctx;
+    /** The session, owned by the cache */
+    SSL_SESSION* session;
+    /** Next entry in the cache list */
+    struct pbpal_ssl_session_entry* next;
+    /** The origin (and SNI) the session was established for. Allocated
+        together with the entry. */
+    char origin[1];
+};
+
+
+/** The list of cached sessions. As there is at most one per
+    `SSL_CTX` and origin, there are only a few of them.
+ */
+static struct pbpal_ssl_session_entry* m_session_list;
+
+/** Number of full handshakes done */
+static unsigned long m_full_handshakes;
+
+/** Number of handshakes which resumed a previous session */
+static unsigned long m_resumed_handshakes;
+
+/** Guards the session list and the handshake counters */
+pbpal_mutex_static_decl_and_init(m_lock);
+
+
+static char const* get_origin(pubnub_t const* pb)
+{
+    return PUBNUB_ORIGIN_SETTABLE ? pb->origin : PUBNUB_ORIGIN;
+}
+
+
+static void session_ref(SSL_SESSION* session)
+{
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L
+    SSL_SESSION_up_ref(session);
+#else
+    CRYPTO_add(&session->references, 1, CRYPTO_LOCK_SSL_SESSION);
+#endif
+}
+
+
+static bool session_expired(SSL_SESSION* session)
+{
+    return (long)time(NULL)
+           >= SSL_SESSION_get_time(session) + SSL_SESSION_get_timeout(session);
+}
+
+
+/** TLS 1.3 tickets should be used only once (RFC 8446, Appendix C.4),
+    while TLS 1.2 sessions may be resumed any number of times.
+ */
+static bool session_single_use(SSL_SESSION* session)
+{
+#if defined(TLS1_3_VERSION)
+    return SSL_SESSION_get_protocol_version(session) >= TLS1_3_VERSION;
+#else
+    PUBNUB_UNUSED(session);
+    return false;
+#endif
+}
+
+
+/** Returns the pointer to the link which points to the entry for
+    @p ctx and @p origin - or to the last link if there is no such
+    entry. Must be called with the lock held. */
+static struct pbpal_ssl_session_entry** find_entry(SSL_CTX* ctx, char const* origin)
+{
+    struct pbpal_ssl_session_entry** pentry;
+
+    for (pentry = &m_session_list; *pentry != NULL; pentry = &(*pentry)->next) {
+        if (((*pentry)->ctx == ctx) && (0 == strcmp((*pentry)->origin, origin))) {
+            break;
+        }
+    }
+    return pentry;
+}
+
+
+static void remove_entry(struct pbpal_ssl_session_entry** pentry)
+{
+    struct pbpal_ssl_session_entry* entry = *pentry;
+
+    *pentry = entry->next;
+    SSL_SESSION_free(entry->session);
+    pbmem_free(entry);
+}
+
+
+/** Called by OpenSSL whenever a new session is established, which,
+    for TLS 1.3, happens when the server sends a new ticket (after the
+    handshake).
+ */
+static int new_session_cb(SSL* ssl, SSL_SESSION* session)
+{
+    struct pbpal_ssl_session_entry** pentry;
+    struct pbpal_ssl_session_entry*  entry;
+    pubnub_t*                        pb = (pubnub_t*)SSL_get_app_data(ssl);
+    char const*                      origin;
+
+    if ((NULL == pb) || !pb->options.reuse_SSL_session) {
+        return 0;
+    }
+    if (NULL != pb->pal.session) {
+        SSL_SESSION_free(pb->pal.session);
+    }
+    session_ref(session);
+    pb->pal.session = session;
+
+    origin = get_origin(pb);
+    pbpal_mutex_init_static(m_lock);
+    pbpal_mutex_lock(m_lock);
+    pentry = find_entry(SSL_get_SSL_CTX(ssl), origin);
+    entry  = *pentry;
+    if (NULL == entry) {
+        size_t len = strlen(origin);
+        entry = (struct pbpal_ssl_session_entry*)pbmem_alloc(
+            NULL, pbmemcatTLS, sizeof *entry + len);
+        if (NULL == entry) {
+            pbpal_mutex_unlock(m_lock);
+            PUBNUB_LOG_WARNING(
+                "pb=%p: Failed to allocate SSL session cache entry\n", pb);
+            return 0;
+        }
+        entry->ctx  = SSL_get_SSL_CTX(ssl);
+        entry->next = NULL;
+        memcpy(entry->origin, origin, len + 1);
+        *pentry = entry;
+    }
+    else {
+        SSL_SESSION_free(entry->session);
+    }
+    session_ref(session);
+    entry->session = session;
+    pbpal_mutex_unlock(m_lock);
+
+    PUBNUB_LOG_TRACE("pb=%p: Cached SSL_SESSION=%p for origin '%s'\n",
+                     pb,
+                     session,
+                     origin);
+
+    return 0;
+}
+
+
+void pbpal_ssl_session_cache_setup_ctx(SSL_CTX* ctx)
+{
+    SSL_CTX_set_session_cache_mode(
+        ctx, SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+    SSL_CTX_sess_set_new_cb(ctx, new_session_cb);
+}
+
+
+void pbpal_ssl_session_cache_purge_ctx(SSL_CTX* ctx)
+{
+    struct pbpal_ssl_session_entry** pentry;
+
+    pbpal_mutex_init_static(m_lock);
+    pbpal_mutex_lock(m_lock);
+    pentry = &m_session_list;
+    while (*pentry != NULL) {
+        if ((*pentry)->ctx == ctx) {
+            remove_entry(pentry);
+        }
+        else {
+            pentry = &(*pentry)->next;
+        }
+    }
+    pbpal_mutex_unlock(m_lock);
+}
+
+
+/** Only host names may be sent as SNI, not IP addresses (RFC 6066,
+    section 3).
+ */
+static bool can_be_sni(char const* origin)
+{
+    if (NULL != strchr(origin, ':')) {
+        return false;
+    }
+    return strspn(origin, "0123456789.") != strlen(origin);
+}
+
+
+void pbpal_ssl_session_prepare(pubnub_t* pb, SSL* ssl)
+{
+    SSL_SESSION* session = NULL;
+    char const*  origin  = get_origin(pb);
+
+    SSL_set_app_data(ssl, pb);
+    if (can_be_sni(origin)) {
+        SSL_set_tlsext_host_name(ssl, origin);
+    }
+    if (!pb->options.reuse_SSL_session) {
+        return;
+    }
+    if ((pb->pal.session != NULL) && !session_expired(pb->pal.session)) {
+        session = pb->pal.session;
+        if (session_single_use(session)) {
+            struct pbpal_ssl_session_entry** pentry;
+
+            /* Hand our reference over to the handshake, so that it's
+               not used again - neither by us, nor, from the cache, by
+               some other context */
+            pb->pal.session = NULL;
+            pbpal_mutex_init_static(m_lock);
+            pbpal_mutex_lock(m_lock);
+            pentry = find_entry(pb->pal.ctx, origin);
+            if ((*pentry != NULL) && ((*pentry)->session == session)) {
+                remove_entry(pentry);
+            }
+            pbpal_mutex_unlock(m_lock);
+        }
+        else {
+            session_ref(session);
+        }
+    }
+    else {
+        struct pbpal_ssl_session_entry** pentry;
+
+        pbpal_mutex_init_static(m_lock);
+        pbpal_mutex_lock(m_lock);
+        pentry = find_entry(pb->pal.ctx, origin);
+        if (*pentry != NULL) {
+            if (session_expired((*pentry)->session)) {
+                remove_entry(pentry);
+            }
+            else {
+                session = (*pentry)->session;
+                session_ref(session);
+                if (session_single_use(session)) {
+                    remove_entry(pentry);
+                }
+            }
+        }
+        pbpal_mutex_unlock(m_lock);
+    }
+    if (session != NULL) {
+        PUBNUB_LOG_TRACE("pb=%p: Trying to resume SSL_SESSION=%p\n", pb, session);
+        if (!SSL_set_session(ssl, session)) {
+            PUBNUB_LOG_WARNING("pb=%p: SSL_set_session() failed\n", pb);
+        }
+        SSL_SESSION_free(session);
+    }
+}
+
+
+void pbpal_ssl_session_handshake_done(pubnub_t* pb)
+{
+    bool reused = SSL_session_reused(pb->pal.ssl);
+
+    pbpal_mutex_init_static(m_lock);
+    pbpal_mutex_lock(m_lock);
+    if (reused) {
+        ++m_resumed_handshakes;
+    }
+    else {
+        ++m_full_handshakes;
+    }
+    pbpal_mutex_unlock(m_lock);
+
+    if (pb->options.reuse_SSL_session) {
+        PUBNUB_LOG_INFO(
+            "pb=%p: SSL session reused: %s\n", pb, reused ? "yes" : "no");
+    }
+}
+
+
+void pbpal_ssl_session_forget(pubnub_t* pb)
+{
+    if (NULL != pb->pal.session) {
+        SSL_SESSION_free(pb->pal.session);
+        pb->pal.session = NULL;
+    }
+    if (NULL != pb->pal.ctx) {
+        struct pbpal_ssl_session_entry** pentry;
+
+        pbpal_mutex_init_static(m_lock);
+        pbpal_mutex_lock(m_lock);
+        pentry = find_entry(pb->pal.ctx, get_origin(pb));
+        if (*pentry != NULL) {
+            remove_entry(pentry);
+        }
+        pbpal_mutex_unlock(m_lock);
+    }
+}
+
+
+void pubnub_ssl_get_handshake_stats(struct pubnub_ssl_handshake_stats* stats)
+{
+    PUBNUB_ASSERT_OPT(stats != NULL);
+
+    pbpal_mutex_init_static(m_lock);
+    pbpal_mutex_lock(m_lock);
+    stats->full    = m_full_handshakes;
+    stats->resumed = m_resumed_handshakes;
+    pbpal_mutex_unlock(m_lock);
+}
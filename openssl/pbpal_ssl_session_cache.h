@@ -0,0 +1,47 @@
+/* -*- c-file-style:"stroustrup"; indent-tabs-mode: nil -*- */
+#if !defined INC_PBPAL_SSL_SESSION_CACHE
+#define      INC_PBPAL_SSL_SESSION_CACHE
+
+#include "core/pubnub_api_types.h"
+
+#include "openssl/ssl.h"
+
+
+/** @file pbpal_ssl_session_cache.h
+    Process-wide TLS client session cache. Sessions (TLS 1.2 session
+    IDs/tickets and TLS 1.3 tickets) are kept per `SSL_CTX` and
+    origin (which is also used as SNI), so that any Pubnub context
+    which reuses SSL sessions can resume a session established by
+    another context - including a freshly created one.
+ */
+
+
+/** Sets up the @p ctx so that sessions established with it get
+    saved in the (process-wide) session cache.
+    To be called right after creating the `SSL_CTX`.
+ */
+void pbpal_ssl_session_cache_setup_ctx(SSL_CTX* ctx);
+
+/** Removes all the sessions kept for @p ctx. To be called before
+    freeing the `SSL_CTX`.
+ */
+void pbpal_ssl_session_cache_purge_ctx(SSL_CTX* ctx);
+
+/** Prepares the @p ssl of the context @p pb for the handshake: sets
+    the SNI and, if @p pb reuses SSL sessions, the session to resume,
+    either its own or the one from the cache.
+ */
+void pbpal_ssl_session_prepare(pubnub_t* pb, SSL* ssl);
+
+/** To be called when the handshake of @p pb is done. Updates the
+    (full vs resumed) handshake counters.
+ */
+void pbpal_ssl_session_handshake_done(pubnub_t* pb);
+
+/** Drops the session of the context @p pb - both its own and the one
+    in the cache for its origin, typically because of a TLS error.
+ */
+void pbpal_ssl_session_forget(pubnub_t* pb);
+
+
+#endif /* !defined INC_PBPAL_SSL_SESSION_CACHE */
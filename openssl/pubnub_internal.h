@@ -105,12 +105,40 @@ typedef SOCKET pb_socket_t;
 */
 #define PUBNUB_MAX_IP_ADDR_OCTET_LENGTH 16
 
+/** OpenSSL before 1.1.0 is thread-safe only if the user provides
+    the locking callbacks. Since 1.1.0, it does its own locking.
+ */
+#define PBPAL_OPENSSL_NEEDS_LOCKING (OPENSSL_VERSION_NUMBER < 0x10100000L)
+
+/** `SSL_read_ex()` and `SSL_write_ex()` are available since
+    OpenSSL 1.1.1
+ */
+#define PBPAL_HAVE_SSL_RW_EX (OPENSSL_VERSION_NUMBER >= 0x10101000L)
+
+/** Kernel TLS offload is available since OpenSSL 3.0, if it was
+    built with it
+ */
+#if defined(SSL_OP_ENABLE_KTLS) && !defined(OPENSSL_NO_KTLS)
+#define PBPAL_HAVE_KTLS 1
+#else
+#define PBPAL_HAVE_KTLS 0
+#endif
+
+/** TLS 1.3 early data (0-RTT) is available since OpenSSL 1.1.1 */
+#define PBPAL_HAVE_TLS_EARLY_DATA (OPENSSL_VERSION_NUMBER >= 0x10101000L)
+
 /** The Pubnub OpenSSL context */
 struct pubnub_pal {
     pbpal_native_socket_t socket;
     SSL*         ssl;
     SSL_CTX*     ctx;
     SSL_SESSION* session;
+    /** The request to send as TLS early data, NULL if none */
+    char*        early_data;
+    /** Length of the request to send as TLS early data */
+    size_t       early_data_len;
+    /** Number of bytes of the early data written so far */
+    size_t       early_data_written;
     char         ip[PUBNUB_MAX_IP_ADDR_OCTET_LENGTH];
     size_t       ip_len;
     int          ip_family;
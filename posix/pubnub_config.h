@@ -36,6 +36,26 @@
  * need to construct big messages, you may need to raise this.  */
 #define PUBNUB_BUF_MAXLEN 32000
 
+#ifndef PUBNUB_DYNAMIC_HTTP_BUFFER
+/** Set to 0 to have the HTTP buffer (and the auxiliary crypto, GZIP
+    and proxy buffers) as part of the context, of the size
+    #PUBNUB_BUF_MAXLEN.  Set to anything !=0 to allocate the HTTP
+    buffer dynamically, with #PUBNUB_BUF_MAXLEN being just the
+    default size, settable per context via
+    pubnub_set_http_buffer_size(), and the auxiliary buffers only
+    when first needed.
+ */
+#define PUBNUB_DYNAMIC_HTTP_BUFFER 1
+#endif
+
+#ifndef PUBNUB_MEMORY_STATS
+/** Set to 1 to enable the accounting of the memory Pubnub allocates
+    (see pubnub_memory_stats()), which costs a small header on every
+    allocation and a lock on every allocation and free.
+ */
+#define PUBNUB_MEMORY_STATS 0
+#endif
+
 /** Set to 0 to use a static buffer and then set its size via
     #PUBNUB_REPLY_MAXLEN.  Set to anything !=0 to use a dynamic
     buffer, that is, dynamically try to allocate as much memory as
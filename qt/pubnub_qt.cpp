@@ -1152,6 +1152,13 @@ QString pubnub_qt::last_time_token() const
 }
 
 
+quint64 pubnub_qt::last_time_token_u64() const
+{
+    KEEP_THREAD_SAFE();
+    return d_context->timetoken_u64;
+}
+
+
 void pubnub_qt::set_ssl_options(ssl_opts options)
 {
     QMutexLocker lk(&d_mutex);
@@ -1899,6 +1899,12 @@ public:
      */
     QString last_time_token() const;
 
+    /** Returns the time token of the last subscribe
+     * operation, as an integer. After init or a serious error,
+     * this will be 0.
+     */
+    quint64 last_time_token_u64() const;
+
     /** Use HTTP Keep-Alive on the context for subsequent transactions.
      */
     void use_http_keep_alive() {
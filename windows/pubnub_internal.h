@@ -11,8 +11,9 @@ typedef SOCKET pb_socket_t;
 
 
 #define socket_close(socket) closesocket(socket)
-#define socket_send(socket, buf, len) send((socket), (buf), (len), 0)
-#define socket_recv(socket, buf, len, flags) recv((socket), (buf), (len), (flags))
+#define socket_send(socket, buf, len) send((socket), (buf), (int)(len), 0)
+#define socket_recv(socket, buf, len, flags)                                   \
+    recv((socket), (buf), (int)(len), (flags))
 
 /* Treating `WSAEINPROGRESS` the same as `WSAEWOULDBLOCK` isn't 
    the greatest solution, but it is good for now.